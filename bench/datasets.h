@@ -0,0 +1,327 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <moose/moose.h>
+#include <moose/stl_serialization.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/** Deterministic synthetic data sets for the benchmarks.
+  The generator does not use the distributions of the standard library, since their results
+  differ between implementations. The same scale thus always produces the same data.*/
+namespace bench
+{
+  /// splitmix64
+  class Random
+  {
+  public:
+    explicit Random (uint64_t seed) : mState {seed} {}
+
+    auto next () -> uint64_t
+    {
+      uint64_t z = (mState += 0x9e3779b97f4a7c15ull);
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+      return z ^ (z >> 31);
+    }
+
+    /// Returns a value in `[0, bound)`.
+    auto below (uint64_t bound) -> uint64_t
+    {
+      return next () % bound;
+    }
+
+    /// Returns a value in `[0, 1)`.
+    auto real () -> double
+    {
+      return static_cast<double> (next () >> 11) * 0x1.0p-53;
+    }
+
+    auto word (std::size_t minLength, std::size_t maxLength) -> std::string
+    {
+      std::string word (minLength + below (maxLength - minLength + 1), ' ');
+      for (auto& c : word)
+        c = static_cast<char> ('a' + below (26));
+      return word;
+    }
+
+  private:
+    uint64_t mState;
+  };
+
+  /// Many small structs with members of different types.
+  struct Flat
+  {
+    int mId {0};
+    double mX {0};
+    double mY {0};
+    double mZ {0};
+    float mWeight {0};
+    bool mActive {false};
+    std::string mLabel;
+
+    void serialize (moose::Archive& ar)
+    {
+      ar ("id", mId);
+      ar ("x", mX);
+      ar ("y", mY);
+      ar ("z", mZ);
+      ar ("weight", mWeight);
+      ar ("active", mActive);
+      ar ("label", mLabel);
+    }
+  };
+
+  struct FlatData
+  {
+    std::vector<Flat> mItems;
+
+    void serialize (moose::Archive& ar)
+    {
+      ar ("items", mItems);
+    }
+  };
+
+  /// A deep tree of nested structs and arrays.
+  struct Node
+  {
+    int mValue {0};
+    std::vector<Node> mChildren;
+
+    void serialize (moose::Archive& ar)
+    {
+      ar ("value", mValue);
+      ar ("children", mChildren);
+    }
+  };
+
+  struct Shape
+  {
+    virtual ~Shape () = default;
+  };
+
+  struct Circle : Shape
+  {
+    double mRadius {0};
+
+    void serialize (moose::Archive& ar)
+    {
+      ar ("radius", mRadius);
+    }
+  };
+
+  struct Rectangle : Shape
+  {
+    double mWidth {0};
+    double mHeight {0};
+
+    void serialize (moose::Archive& ar)
+    {
+      ar ("width", mWidth);
+      ar ("height", mHeight);
+    }
+  };
+
+  struct Polygon : Shape
+  {
+    std::vector<double> mCoordinates;
+
+    void serialize (moose::Archive& ar)
+    {
+      ar ("coordinates", mCoordinates);
+    }
+  };
+
+  struct PolymorphicData
+  {
+    std::vector<std::shared_ptr<Shape>> mShapes;
+
+    void serialize (moose::Archive& ar)
+    {
+      ar ("shapes", mShapes);
+    }
+  };
+
+  /** Large arrays of numbers. If `mCodecs` is set, each array is stored with the codec
+    which suits its content.*/
+  struct NumericData
+  {
+    std::vector<double> mSamples;
+    std::vector<int64_t> mTimestamps;
+    std::vector<int> mLabels;
+    bool mCodecs {false};
+
+    void serialize (moose::Archive& ar)
+    {
+      ar ("samples", mSamples, mCodecs ? moose::Hint::XorFloat : moose::Hint::None);
+      ar ("timestamps", mTimestamps, mCodecs ? moose::Hint::Delta : moose::Hint::None);
+      ar ("labels", mLabels, mCodecs ? moose::Hint::RunLength : moose::Hint::None);
+    }
+  };
+
+  struct StringData
+  {
+    std::map<std::string, std::string> mProperties;
+    std::map<std::string, std::vector<std::string>> mTags;
+
+    void serialize (moose::Archive& ar)
+    {
+      ar ("properties", mProperties);
+      ar ("tags", mTags);
+    }
+  };
+
+  inline void registerTypes ()
+  {
+    moose::types ().add<Circle, Shape> ("Circle");
+    moose::types ().add<Rectangle, Shape> ("Rectangle");
+    moose::types ().add<Polygon, Shape> ("Polygon");
+    moose::types ().add_without_serialize<Shape> ("Shape");
+  }
+
+  inline auto makeFlat (std::size_t count) -> FlatData
+  {
+    Random random {1};
+    FlatData data;
+    data.mItems.resize (count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      auto& item = data.mItems [i];
+      item.mId = static_cast<int> (i);
+      item.mX = random.real () * 100;
+      item.mY = random.real () * 100;
+      item.mZ = random.real () * 100;
+      item.mWeight = static_cast<float> (random.real ());
+      item.mActive = random.below (2) == 0;
+      item.mLabel = random.word (4, 12);
+    }
+    return data;
+  }
+
+  inline void growTree (Node& node, Random& random, int depth)
+  {
+    node.mValue = static_cast<int> (random.below (1000));
+    if (depth == 0)
+      return;
+
+    node.mChildren.resize (2);
+    for (auto& child : node.mChildren)
+      growTree (child, random, depth - 1);
+  }
+
+  inline auto makeDeep (int depth) -> Node
+  {
+    Random random {2};
+    Node root;
+    growTree (root, random, depth);
+    return root;
+  }
+
+  inline auto makePolymorphic (std::size_t count) -> PolymorphicData
+  {
+    Random random {3};
+    PolymorphicData data;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      switch (random.below (3))
+      {
+        case 0:
+        {
+          auto circle = std::make_shared<Circle> ();
+          circle->mRadius = random.real ();
+          data.mShapes.push_back (std::move (circle));
+          break;
+        }
+        case 1:
+        {
+          auto rectangle = std::make_shared<Rectangle> ();
+          rectangle->mWidth = random.real ();
+          rectangle->mHeight = random.real ();
+          data.mShapes.push_back (std::move (rectangle));
+          break;
+        }
+        default:
+        {
+          auto polygon = std::make_shared<Polygon> ();
+          polygon->mCoordinates.resize (2 * (3 + random.below (6)));
+          for (auto& coordinate : polygon->mCoordinates)
+            coordinate = random.real ();
+          data.mShapes.push_back (std::move (polygon));
+          break;
+        }
+      }
+    }
+    return data;
+  }
+
+  /// A slowly varying signal, monotonic timestamps and labels with long runs.
+  inline auto makeNumeric (std::size_t count, bool codecs) -> NumericData
+  {
+    Random random {4};
+    NumericData data;
+    data.mCodecs = codecs;
+    data.mSamples.resize (count);
+    data.mTimestamps.resize (count);
+    data.mLabels.resize (count);
+
+    double sample = 20;
+    int64_t timestamp = 1700000000000;
+    int label = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      if (random.below (8) == 0)
+        sample += 0.25 * (static_cast<double> (random.below (3)) - 1);
+      timestamp += 10 + static_cast<int64_t> (random.below (3));
+      if (random.below (1000) == 0)
+        label = static_cast<int> (random.below (16));
+
+      data.mSamples [i] = sample;
+      data.mTimestamps [i] = timestamp;
+      data.mLabels [i] = label;
+    }
+    return data;
+  }
+
+  inline auto makeStrings (std::size_t count) -> StringData
+  {
+    Random random {5};
+    StringData data;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      data.mProperties [random.word (8, 24)] = random.word (0, 64);
+
+      auto& tags = data.mTags [random.word (8, 16)];
+      tags.resize (random.below (6));
+      for (auto& tag : tags)
+        tag = random.word (3, 10);
+    }
+    return data;
+  }
+}// end of namespace bench
@@ -0,0 +1,381 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "allocation_counter.h"
+#include "datasets.h"
+
+#include <moose/from_binary.h>
+#include <moose/to_binary.h>
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#if defined (__unix__) || defined (__APPLE__)
+  #include <sys/resource.h>
+#endif
+
+namespace
+{
+  /// Returns the peak resident set size of the process in KiB, or 0 if it is unknown.
+  auto peakRssKiB () -> uint64_t
+  {
+  #if defined (__unix__) || defined (__APPLE__)
+    rusage usage {};
+    if (getrusage (RUSAGE_SELF, &usage) != 0)
+      return 0;
+    #if defined (__APPLE__)
+      return static_cast<uint64_t> (usage.ru_maxrss) / 1024;
+    #else
+      return static_cast<uint64_t> (usage.ru_maxrss);
+    #endif
+  #else
+    return 0;
+  #endif
+  }
+
+  struct Options
+  {
+    double scale {1};
+    int repetitions {5};
+    std::string filter;
+    std::string output;
+  };
+
+  /// The measurements of one benchmark case.
+  struct Result
+  {
+    std::string name;
+    std::string dataset;
+    std::string format;
+    std::string operation;
+    uint64_t bytes {0};
+    double minSeconds {0};
+    double meanSeconds {0};
+    double mibPerSecond {0};
+    double allocationsPerRun {0};
+    double allocatedBytesPerRun {0};
+    uint64_t peakRssKiB {0};
+
+    void serialize (moose::Archive& ar)
+    {
+      ar ("name", name);
+      ar ("dataset", dataset);
+      ar ("format", format);
+      ar ("operation", operation);
+      ar ("bytes", bytes);
+      ar ("minSeconds", minSeconds);
+      ar ("meanSeconds", meanSeconds);
+      ar ("mibPerSecond", mibPerSecond);
+      ar ("allocationsPerRun", allocationsPerRun);
+      ar ("allocatedBytesPerRun", allocatedBytesPerRun);
+      ar ("peakRssKiB", peakRssKiB);
+    }
+  };
+
+  struct Report
+  {
+    double scale {1};
+    int repetitions {0};
+    std::vector<Result> results;
+
+    void serialize (moose::Archive& ar)
+    {
+      ar ("scale", scale);
+      ar ("repetitions", repetitions);
+      ar ("results", results);
+    }
+  };
+
+  /** A single benchmark case.
+    `prepare` runs before each repetition and is not measured. `run` performs the measured
+    operation and returns the number of bytes it produced or consumed.*/
+  struct Case
+  {
+    std::string dataset;
+    std::string format;
+    std::string operation;
+    std::function<void ()> prepare;
+    std::function<uint64_t ()> run;
+  };
+
+  auto measure (Case const& c, int repetitions) -> Result
+  {
+    using Clock = std::chrono::steady_clock;
+
+    Result result {c.dataset + "/" + c.format + "/" + c.operation, c.dataset, c.format, c.operation};
+    result.minSeconds = std::numeric_limits<double>::max ();
+
+    // One untimed warm up run.
+    if (c.prepare)
+      c.prepare ();
+    c.run ();
+
+    double total = 0;
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+    for (int i = 0; i < repetitions; ++i)
+    {
+      if (c.prepare)
+        c.prepare ();
+
+      moose::test::AllocationCounter const counter;
+      auto const start = Clock::now ();
+      result.bytes = c.run ();
+      auto const seconds = std::chrono::duration<double> (Clock::now () - start).count ();
+      allocations += counter.allocations ();
+      allocatedBytes += counter.bytes ();
+
+      total += seconds;
+      result.minSeconds = std::min (result.minSeconds, seconds);
+    }
+
+    result.meanSeconds = total / repetitions;
+    if (result.minSeconds > 0)
+      result.mibPerSecond = static_cast<double> (result.bytes) / (1024.0 * 1024.0) / result.minSeconds;
+    result.allocationsPerRun = static_cast<double> (allocations) / repetitions;
+    result.allocatedBytesPerRun = static_cast<double> (allocatedBytes) / repetitions;
+    result.peakRssKiB = peakRssKiB ();
+    return result;
+  }
+
+  /// Adds write and read cases of `data` for json and both binary integer encodings.
+  template <class T>
+  void addCases (std::vector<Case>& cases, std::string const& dataset, std::shared_ptr<T const> data)
+  {
+    auto const json = std::make_shared<std::string> (moose::toJson ("data", *data));
+    cases.push_back ({dataset, "json", "write", {}, [data]
+    {
+      return static_cast<uint64_t> (moose::toJson ("data", *data).size ());
+    }});
+
+    cases.push_back ({dataset, "json", "read", {}, [json]
+    {
+      auto const out = moose::fromJson<T> ("data", json->c_str ());
+      return static_cast<uint64_t> (json->size ());
+    }});
+
+    for (auto const encoding : {moose::IntegerEncoding::Fixed, moose::IntegerEncoding::Varint, moose::IntegerEncoding::Legacy})
+    {
+      std::string const format = encoding == moose::IntegerEncoding::Fixed  ? "binary"
+                               : encoding == moose::IntegerEncoding::Varint ? "binary-varint"
+                                                                            : "binary-legacy";
+      moose::BinaryOptions const options {encoding};
+      auto const binary = std::make_shared<std::string> (moose::toBinary (*data, options)->str ());
+
+      auto out = std::make_shared<std::stringstream> ();
+      cases.push_back ({dataset, format, "write",
+        [out] {out->str ({}); out->clear ();},
+        [data, out, options]
+        {
+          moose::Archive archive {std::make_shared<moose::BinaryWriter<std::stringstream>> (out, options)};
+          archive ("", *data);
+          return static_cast<uint64_t> (out->tellp ());
+        }});
+
+      auto in = std::make_shared<std::stringstream> ();
+      cases.push_back ({dataset, format, "read",
+        [in, binary] {in->str (*binary); in->clear ();},
+        [in, binary, options]
+        {
+          auto const out = moose::fromBinary<T> (in, options);
+          return static_cast<uint64_t> (binary->size ());
+        }});
+    }
+  }
+
+  /** The flat data set written and read with rapidjson directly, without moose.
+    The output matches the json which moose produces, e.g. booleans are stored as numbers.*/
+  void addRapidJsonCases (std::vector<Case>& cases, std::shared_ptr<bench::FlatData const> data)
+  {
+    auto const json = std::make_shared<std::string> (moose::toJson ("data", *data));
+
+    cases.push_back ({"flat", "rapidjson", "write", {}, [data]
+    {
+      rapidjson::StringBuffer buffer;
+      rapidjson::Writer<rapidjson::StringBuffer> writer {buffer};
+      writer.StartObject ();
+      writer.Key ("data");
+      writer.StartObject ();
+      writer.Key ("items");
+      writer.StartArray ();
+      for (auto const& item : data->mItems)
+      {
+        writer.StartObject ();
+        writer.Key ("id"); writer.Int (item.mId);
+        writer.Key ("x"); writer.Double (item.mX);
+        writer.Key ("y"); writer.Double (item.mY);
+        writer.Key ("z"); writer.Double (item.mZ);
+        writer.Key ("weight"); writer.Double (item.mWeight);
+        writer.Key ("active"); writer.Int (item.mActive ? 1 : 0);
+        writer.Key ("label"); writer.String (item.mLabel.c_str (), static_cast<rapidjson::SizeType> (item.mLabel.size ()));
+        writer.EndObject ();
+      }
+      writer.EndArray ();
+      writer.EndObject ();
+      writer.EndObject ();
+      return static_cast<uint64_t> (buffer.GetSize ());
+    }});
+
+    cases.push_back ({"flat", "rapidjson", "read", {}, [json]
+    {
+      rapidjson::Document document;
+      document.Parse (json->c_str ());
+      if (document.HasParseError ())
+        throw std::runtime_error ("rapidjson failed to parse the flat data set");
+
+      bench::FlatData out;
+      for (auto const& value : document ["data"]["items"].GetArray ())
+      {
+        bench::Flat item;
+        item.mId = value ["id"].GetInt ();
+        item.mX = value ["x"].GetDouble ();
+        item.mY = value ["y"].GetDouble ();
+        item.mZ = value ["z"].GetDouble ();
+        item.mWeight = static_cast<float> (value ["weight"].GetDouble ());
+        item.mActive = value ["active"].GetInt () != 0;
+        item.mLabel = value ["label"].GetString ();
+        out.mItems.push_back (std::move (item));
+      }
+      return static_cast<uint64_t> (json->size ());
+    }});
+  }
+
+  auto scaled (double scale, std::size_t count) -> std::size_t
+  {
+    return std::max<std::size_t> (1, static_cast<std::size_t> (scale * static_cast<double> (count)));
+  }
+
+  auto makeCases (double scale) -> std::vector<Case>
+  {
+    std::vector<Case> cases;
+
+    auto const flat = std::make_shared<bench::FlatData const> (bench::makeFlat (scaled (scale, 100000)));
+    addCases (cases, "flat", flat);
+    addRapidJsonCases (cases, flat);
+
+    // A binary tree with 2^(depth+1) - 1 nodes.
+    int depth = 1;
+    while ((std::size_t {2} << depth) <= scaled (scale, 65536))
+      ++depth;
+    addCases (cases, "deep", std::make_shared<bench::Node const> (bench::makeDeep (depth)));
+
+    addCases (cases, "polymorphic", std::make_shared<bench::PolymorphicData const> (
+      bench::makePolymorphic (scaled (scale, 50000))));
+
+    auto const numericCount = scaled (scale, 1000000);
+    addCases (cases, "numeric", std::make_shared<bench::NumericData const> (bench::makeNumeric (numericCount, false)));
+    addCases (cases, "numeric-codecs", std::make_shared<bench::NumericData const> (bench::makeNumeric (numericCount, true)));
+
+    addCases (cases, "strings", std::make_shared<bench::StringData const> (bench::makeStrings (scaled (scale, 50000))));
+    return cases;
+  }
+
+  void printUsage ()
+  {
+    std::cerr << "usage: moose_bench [--scale <factor>] [--repetitions <count>] [--filter <substring>] [--output <file>]\n"
+                 "Runs the moose benchmarks and prints the results as json. Only cases whose name\n"
+                 "(dataset/format/operation) contains the filter are run.\n";
+  }
+
+  auto parseOptions (int argc, char** argv) -> Options
+  {
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+      std::string const arg = argv [i];
+      if (arg == "--help" || arg == "-h")
+      {
+        printUsage ();
+        std::exit (0);
+      }
+
+      if (i + 1 >= argc)
+      {
+        printUsage ();
+        std::exit (1);
+      }
+
+      std::string const value = argv [++i];
+      if (arg == "--scale")
+        options.scale = std::stod (value);
+      else if (arg == "--repetitions")
+        options.repetitions = std::max (1, std::stoi (value));
+      else if (arg == "--filter")
+        options.filter = value;
+      else if (arg == "--output")
+        options.output = value;
+      else
+      {
+        printUsage ();
+        std::exit (1);
+      }
+    }
+    return options;
+  }
+}
+
+int main (int argc, char** argv)
+{
+  try
+  {
+    auto const options = parseOptions (argc, argv);
+    bench::registerTypes ();
+
+    Report report {options.scale, options.repetitions, {}};
+    for (auto const& c : makeCases (options.scale))
+    {
+      auto const name = c.dataset + "/" + c.format + "/" + c.operation;
+      if (name.find (options.filter) == std::string::npos)
+        continue;
+
+      std::cerr << name << "\n";
+      report.results.push_back (measure (c, options.repetitions));
+    }
+
+    auto const json = moose::toJson ("benchmark", report);
+    if (options.output.empty ())
+      std::cout << json << "\n";
+    else
+    {
+      std::ofstream out {options.output};
+      out << json << "\n";
+    }
+  }
+  catch (std::exception const& e)
+  {
+    std::cerr << "moose_bench: " << e.what () << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -62,6 +62,8 @@ namespace moose
 
     /** \brief Read/write with default value
       If the archive is reading and the given name can not be found, the default value is returned.
+      The default value is also returned if a mandatory entry inside the value is missing. Such
+      errors are handled without exceptions.
     */
     template <class T>
     void operator () (const char* name, T& value, const T& defVal, Hint hint = Hint::None);
@@ -91,14 +93,48 @@ namespace moose
     MOOSE_EXPORT bool is_reading () const;
     MOOSE_EXPORT bool is_writing () const;
 
+    /** \brief Returns the format of the underlying reader or writer.
+      Types whose traits specify `EntryType::PerFormat` are serialized with the traits for this format.
+      `Serialize` functions may also query it to choose a representation per format.*/
+    MOOSE_EXPORT auto format () const -> Format;
+
+    /** \brief Reports read errors through `error ()` instead of exceptions.
+      By default, a reading archive throws an `ArchiveError` if an entry without default value is missing.
+      Afterwards, such errors are recorded instead and all remaining entries are skipped.
+      Errors raised by the underlying reader, e.g. for corrupt data, are still thrown.*/
+    MOOSE_EXPORT void record_errors ();
+
+    /// Returns the description of the recorded error, or an empty string if no error was recorded.
+    MOOSE_EXPORT auto error () const -> std::string const&;
+
   private:
     MOOSE_EXPORT bool begin_entry (const char* name, ContentType contentType, Hint hint);
     MOOSE_EXPORT void end_entry (const char* name, ContentType contentType);
 
+    /** Throws an `ArchiveError` with the given message, unless errors are currently handled without exceptions.
+      In that case, the archive is marked as failed and all entries are skipped until the failure was handled.
+      The message is only built if it is reported.*/
+    template <class... ARGS>
+    void fail (ARGS const&... message);
+
+    /// Returns `true` if the writer wrote the entry from its encoding cache.
+    template <class T>
+    bool write_cached (const char* name, T const& value, ContentType contentType, Hint hint);
+
     /// Used to allow for different overloads based on the entryType.
     template <EntryType entryType>
     struct EntryTypeDummy {};
 
+    /** If the writer describes a schema, describes a default constructed instance of `T` in place of the pointee
+      of a null pointer or of the elements of an empty range, see `Writer::describes_schema`.
+      \{ */
+    template <class T>
+    void describe_pointee ();
+
+    template <class T>
+    void describe_element ();
+    /** \} */
+
   /** If a concrete type is defined by the current entry in the archive,
     the corresponding Type object is returned. If not, the Type object
     corresponding to the given template argument is returned.
@@ -133,6 +169,13 @@ namespace moose
     template <class T>
     void archive (const char* name, T& value, EntryTypeDummy <EntryType::ForwardReference>);
 
+    template <class T>
+    void archive (const char* name, T& value, EntryTypeDummy <EntryType::PerFormat>);
+
+    /// Serializes `value` with the traits which its `TypeTraits` specify for `FORMAT`.
+    template <Format FORMAT, class T>
+    void archive_in_format (const char* name, T& value);
+
     template <class T>
     void archive (const char* name, T& value);
     
@@ -154,9 +197,18 @@ namespace moose
     template <class TRAITS>
     auto contentType (TRAITS const&, EntryTypeDummy<EntryType::ForwardReference>) -> ContentType;
 
+    template <class TRAITS>
+    auto contentType (TRAITS const&, EntryTypeDummy<EntryType::PerFormat>) -> ContentType;
+
   private:
     std::shared_ptr<Reader> mInput;
     std::shared_ptr<Writer> mOutput;
+    /// Number of entries with default values which are currently being read. Errors inside them are not thrown.
+    std::size_t mDefaultScopes {0};
+    bool mRecordErrors {false};
+    /// Set while the entries which are skipped after an error are being unwound.
+    bool mFailed {false};
+    std::string mError;
   };
 }// end of namespace moose
 
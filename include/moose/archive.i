@@ -30,7 +30,16 @@
 #include <moose/serialize.h>
 #include <moose/type_traits.h>
 #include <moose/types.h>
+#include <moose/detail/field_counter.h>
+#include <moose/detail/in_format.h>
+#include <algorithm>
 #include <cassert>
+#include <concepts>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <typeinfo>
+#include <utility>
 
 namespace moose::detail
 {
@@ -62,6 +71,94 @@ namespace moose::detail
       return hint;
     return getDefaultHint (t);
   }
+
+  /// Vectors which store their elements contiguously may be resized and read/written in one go.
+  template <class T>
+  concept ContiguousVector =
+    isVector<T> () &&
+    requires (T& v, std::size_t n)
+    {
+      v.resize (n);
+      {v.data ()} -> std::same_as<typename TypeTraits<T>::ValueType*>;
+      {v.size ()} -> std::convertible_to<std::size_t>;
+    };
+
+  template <class T>
+  using RangeIterator = decltype (TypeTraits<T>::toRange (std::declval<T&> ()).begin);
+
+  template <class T>
+  concept ContiguousRange = isRange<T> () && std::contiguous_iterator<RangeIterator<T>>;
+
+  template <class T>
+  concept ContiguousNumberVector = ContiguousVector<T> && isNumber<typename TypeTraits<T>::ValueType> ();
+
+  template <class T>
+  concept ContiguousNumberRange = ContiguousRange<T> && isNumber<std::iter_value_t<RangeIterator<T>>> ();
+
+  template <class T>
+  concept ContiguousRawVector = ContiguousVector<T> && isRawBinary<typename TypeTraits<T>::ValueType> ();
+
+  template <class T>
+  concept ContiguousRawRange = ContiguousRange<T> && isRawBinary<std::iter_value_t<RangeIterator<T>>> ();
+
+  /// The layout of a trivially copyable type. The number of fields is determined once by serializing a default instance.
+  template <class T>
+  auto rawLayout () -> RawLayout const&
+  {
+    static RawLayout const layout = []
+    {
+      auto counter = std::make_shared<FieldCounter> ();
+      Archive archive {counter};
+      T instance {};
+      Serialize (archive, instance);
+      return RawLayout {sizeof (T), alignof (T), counter->count ()};
+    } ();
+    return layout;
+  }
+
+  /// Encodings of pointers are cached for the object they point to.
+  template <class T>
+  struct CachedObject
+  {
+    using Type = T;
+    static auto get (T const& value) -> T const* {return &value;}
+  };
+
+  template <class T>
+  struct CachedObject<std::shared_ptr<T>>
+  {
+    using Type = T;
+    static auto get (std::shared_ptr<T> const& value) -> T const* {return value.get ();}
+  };
+
+  template <class T>
+  struct CachedObject<std::unique_ptr<T>>
+  {
+    using Type = T;
+    static auto get (std::unique_ptr<T> const& value) -> T const* {return value.get ();}
+  };
+
+  template <class T>
+  struct CachedObject<T*>
+  {
+    using Type = T;
+    static auto get (T* const& value) -> T const* {return value;}
+  };
+
+  template <class T>
+  constexpr bool usesEncodingCache ()
+  {
+    return isEncodingCached<std::remove_const_t<typename CachedObject<T>::Type>> ();
+  }
+
+  template <class ITERATOR>
+  auto rangeSize (ITERATOR const& begin, ITERATOR const& end) -> std::optional<std::size_t>
+  {
+    if constexpr (std::forward_iterator<ITERATOR> || std::sized_sentinel_for<ITERATOR, ITERATOR>)
+      return static_cast<std::size_t> (std::ranges::distance (begin, end));
+    else
+      return std::nullopt;
+  }
 }// end of namespace
 
 namespace moose
@@ -72,9 +169,20 @@ namespace moose
     static constexpr EntryType entryType = TypeTraits <T>::entryType;
     auto const contentType = this->contentType (TypeTraits <T> {}, EntryTypeDummy<entryType> {});
 
+    if constexpr (detail::usesEncodingCache<T> ())
+    {
+      if (write_cached (name, value, contentType, detail::hintOrDefault (value, hint)))
+        return;
+    }
+
+    if (mFailed)
+      return;
+
     if (!begin_entry (name, contentType, detail::hintOrDefault (value, hint)))
-      throw ArchiveError () << "No entry with name '" << name
-        << "' found in current object '" << name << "'.";
+    {
+      fail ("No entry with name '", name, "' found in current object.");
+      return;
+    }
     archive (name, value, EntryTypeDummy <entryType> ());
     end_entry (name, contentType);
   }
@@ -85,18 +193,44 @@ namespace moose
     static constexpr EntryType entryType = TypeTraits <T>::entryType;
     auto const contentType = this->contentType (TypeTraits <T> {}, EntryTypeDummy<entryType> {});
 
+    if constexpr (detail::usesEncodingCache<T> ())
+    {
+      if (write_cached (name, value, contentType, detail::hintOrDefault (value, hint)))
+        return;
+    }
+
+    if (mFailed)
+      return;
+
     if (!begin_entry (name, contentType, detail::hintOrDefault (value, hint)))
     {
       value = defVal;
       return;
     }
 
-    try
+    // Missing entries inside the value mark the archive as failed instead of throwing.
     {
-      archive (name, value, EntryTypeDummy <entryType> ());
+      // Leaves the scope also if other exceptions escape from the value.
+      struct DefaultScope
+      {
+        std::size_t& mScopes;
+        explicit DefaultScope (std::size_t& scopes) : mScopes (scopes) {++mScopes;}
+        ~DefaultScope () {--mScopes;}
+      } const scope {mDefaultScopes};
+
+      try
+      {
+        archive (name, value, EntryTypeDummy <entryType> ());
+      }
+      catch(ArchiveError&)
+      {
+        mFailed = true;
+      }
     }
-    catch(ArchiveError&)
+
+    if (mFailed)
     {
+      mFailed = false;
       value = defVal;
     }
 
@@ -133,6 +267,38 @@ namespace moose
     (*this) ("", value, hint);
   }
 
+  template <class... ARGS>
+  void Archive::fail (ARGS const&... message)
+  {
+    if (mDefaultScopes > 0)
+    {
+      mFailed = true;
+      return;
+    }
+
+    ArchiveError error;
+    (error << ... << message);
+    if (!mRecordErrors)
+      throw error;
+
+    mFailed = true;
+    mError = error.what ();
+  }
+
+  template <class T>
+  bool Archive::write_cached (const char* name, T const& value, ContentType contentType, Hint hint)
+  {
+    if (!is_writing ())
+      return false;
+
+    auto const* const object = detail::CachedObject<T>::get (value);
+    if (object == nullptr)
+      return false;
+
+    CacheKey const key {object, typeid (T), encodingGeneration (*object), hint};
+    return mOutput->write_cached (name, contentType, hint, key);
+  }
+
   template <class T>
   Type const& Archive::archive_type (T& instance)
   {
@@ -158,14 +324,27 @@ namespace moose
   }
 
   template <class T>
-  void Archive::archive (const char* /*name*/, T& value, EntryTypeDummy <EntryType::Struct>)
+  void Archive::archive (const char* name, T& value, EntryTypeDummy <EntryType::Struct>)
   {
+    if constexpr (isRawBinary<T> ())
+    {
+      auto const& layout = detail::rawLayout<T> ();
+      if (is_reading () ? mInput->read_raw (name, layout, &value, 1)
+                        : mOutput->write_raw (name, layout, &value, 1))
+      {
+        return;
+      }
+    }
+
     Serialize (*this, value);
   }
 
   template <class T>
   void Archive::archive (const char* name, std::shared_ptr<T>& sp, EntryTypeDummy <EntryType::Struct>)
   {
+    if (sp == nullptr && is_writing () && mOutput->describes_schema ())
+      return describe_pointee<T> ();
+
     Type const& type = archive_type <T> (*sp);
     if(sp == nullptr)
     {
@@ -181,6 +360,9 @@ namespace moose
   template <class T>
   void Archive::archive (const char* name, std::unique_ptr<T>& up, EntryTypeDummy <EntryType::Struct>)
   {
+    if (up == nullptr && is_writing () && mOutput->describes_schema ())
+      return describe_pointee<T> ();
+
     Type const& type = archive_type <T> (*up);
     if(up == nullptr)
     {
@@ -196,6 +378,9 @@ namespace moose
   template <class T>
   void Archive::archive (const char* name, T*& p, EntryTypeDummy <EntryType::Struct>)
   {
+    if (p == nullptr && is_writing () && mOutput->describes_schema ())
+      return describe_pointee<T> ();
+
     Type const& type = archive_type <T> (*p );
     if(p ==  nullptr)
     {
@@ -219,16 +404,51 @@ namespace moose
     if (is_reading ())
     {
       Traits::clear (value);
+      if constexpr (detail::ContiguousRawVector<T>)
+      {
+        if (auto const size = mInput->array_size (name))
+        {
+          // The storage grows with the values read, see `Reader::array_size`.
+          constexpr auto chunk = std::max<std::size_t> (detail::readChunkBytes / sizeof (ValueType), 1);
+          bool raw = true;
+          for (std::size_t begin = 0; begin < *size && raw; begin += chunk)
+          {
+            auto const count = std::min (chunk, *size - begin);
+            value.resize (begin + count);
+            raw = mInput->read_raw (name, detail::rawLayout<ValueType> (), value.data () + begin, count);
+          }
+          if (raw)
+            return;
+          Traits::clear (value);
+        }
+      }
+
+      if constexpr (detail::ContiguousNumberVector<T>)
+      {
+        if (auto const size = mInput->array_size (name))
+        {
+          // The storage grows with the values read, see `Reader::array_size`.
+          constexpr std::size_t chunk = detail::readChunkBytes / sizeof (ValueType);
+          for (std::size_t begin = 0; begin < *size; begin += chunk)
+          {
+            auto const count = std::min (chunk, *size - begin);
+            value.resize (begin + count);
+            mInput->read_array (name, std::span<ValueType> {value.data () + begin, count});
+          }
+          return;
+        }
+      }
+
       if constexpr (unpack)
       {
-        while(mInput->array_has_next (name))
+        while(!mFailed && mInput->array_has_next (name))
         {
           ValueType childValue;
           auto childRange = TypeTraits<ValueType>::toRange (childValue);
-          for (auto i = childRange.begin; i != childRange.end; ++i)
+          for (auto i = childRange.begin; i != childRange.end && !mFailed; ++i)
           {
             if (!mInput->array_has_next (name))
-              throw ArchiveError () << "Too few entries while reading range '" << name << "'";
+              return fail ("Too few entries while reading range '", name, "'");
 
             (*this) ("", *i);
           }
@@ -237,25 +457,46 @@ namespace moose
       }
       else
       {
-        while(mInput->array_has_next (name))
+        while(!mFailed && mInput->array_has_next (name))
         {
           ValueType tmpVal = detail::GetInitialValue <ValueType> ();
           (*this) ("", tmpVal);
-          Traits::pushBack (value, tmpVal);
+          Traits::pushBack (value, std::move (tmpVal));
         }
       }
     }
     else
     {
-      if constexpr (unpack)
+      if constexpr (detail::ContiguousRawVector<T>)
+      {
+        if (mOutput->write_raw (name, detail::rawLayout<ValueType> (), value.data (), value.size ()))
+          return;
+      }
+
+      if constexpr (detail::ContiguousNumberVector<T>)
+      {
+        mOutput->write_array (name, std::span<ValueType const> {value.data (), value.size ()});
+      }
+      else if constexpr (unpack)
       {
         auto range = Traits::toRange (value);
+        std::size_t size = 0;
+        for (auto i = range.begin; i != range.end; ++i)
+        {
+          auto childRange = TypeTraits<ValueType>::toRange (*i);
+          size += static_cast<std::size_t> (std::distance (childRange.begin, childRange.end));
+        }
+        mOutput->write_array_size (size);
+
         for (auto i = range.begin; i != range.end; ++i)
         {
           auto childRange = TypeTraits<ValueType>::toRange (*i);
           for (auto j = childRange.begin; j != childRange.end; ++j)
             (*this) ("", *j);
         }
+
+        if (size == 0 && mOutput->describes_schema ())
+          describe_element<std::iter_value_t<detail::RangeIterator<ValueType>>> ();
       }
       else
       {
@@ -271,21 +512,101 @@ namespace moose
     auto const range = TypeTraits<T>::toRange (value);
     if (is_reading ())
     {
-      for (auto i = range.begin; i != range.end; ++i)
+      if constexpr (detail::ContiguousNumberRange<T>)
+      {
+        auto const size = static_cast<std::size_t> (std::distance (range.begin, range.end));
+        if (auto const available = mInput->array_size (name))
+        {
+          if (*available < size)
+            return fail ("Too few entries while reading range '", name, "'");
+          if (*available > size)
+            return fail ("Too many entries while reading range '", name, "'");
+
+          mInput->read_array (name, std::span {std::to_address (range.begin), size});
+          return;
+        }
+      }
+
+      if constexpr (detail::ContiguousRawRange<T>)
+      {
+        auto const size = static_cast<std::size_t> (std::distance (range.begin, range.end));
+        if (auto const available = mInput->array_size (name))
+        {
+          if (*available < size)
+            return fail ("Too few entries while reading range '", name, "'");
+          if (*available > size)
+            return fail ("Too many entries while reading range '", name, "'");
+
+          using ValueType = std::iter_value_t<detail::RangeIterator<T>>;
+          if (mInput->read_raw (name, detail::rawLayout<ValueType> (), std::to_address (range.begin), size))
+            return;
+        }
+      }
+
+      for (auto i = range.begin; i != range.end && !mFailed; ++i)
       {
         if (!mInput->array_has_next (name))
-          throw ArchiveError () << "Too few entries while reading range '" << name << "'";
+          return fail ("Too few entries while reading range '", name, "'");
 
         (*this) ("", *i);
       }
 
-      if (mInput->array_has_next (name))
-        throw ArchiveError () << "Too many entries while reading range '" << name << "'";
+      if (!mFailed && mInput->array_has_next (name))
+        fail ("Too many entries while reading range '", name, "'");
     }
     else
     {
-      for (auto i = range.begin; i != range.end; ++i)
-        (*this) ("", *i);
+      if constexpr (detail::ContiguousNumberRange<T>)
+      {
+        auto const size = static_cast<std::size_t> (std::distance (range.begin, range.end));
+        using ValueType = std::iter_value_t<detail::RangeIterator<T>>;
+        mOutput->write_array (name, std::span<ValueType const> {std::to_address (range.begin), size});
+      }
+      else
+      {
+        if constexpr (detail::ContiguousRawRange<T>)
+        {
+          auto const size = static_cast<std::size_t> (std::distance (range.begin, range.end));
+          using ValueType = std::iter_value_t<detail::RangeIterator<T>>;
+          if (mOutput->write_raw (name, detail::rawLayout<ValueType> (), std::to_address (range.begin), size))
+            return;
+        }
+
+        if (auto const size = detail::rangeSize (range.begin, range.end))
+          mOutput->write_array_size (*size);
+
+        for (auto i = range.begin; i != range.end; ++i)
+          (*this) ("", *i);
+
+        if (range.begin == range.end && mOutput->describes_schema ())
+          describe_element<std::iter_value_t<detail::RangeIterator<T>>> ();
+      }
+    }
+  }
+
+  template <class T>
+  void Archive::describe_pointee ()
+  {
+    if constexpr (std::is_default_constructible_v<T> && !std::is_abstract_v<T>)
+    {
+      if (types ().get_if (typeid (T)) == nullptr || !mOutput->begin_schema_element (typeid (T)))
+        return;
+      T instance {};
+      archive_type <T> (instance).serialize (*this, instance);
+      mOutput->end_schema_element ();
+    }
+  }
+
+  template <class T>
+  void Archive::describe_element ()
+  {
+    if constexpr (std::is_default_constructible_v<T>)
+    {
+      if (!mOutput->begin_schema_element (typeid (T)))
+        return;
+      T element = detail::GetInitialValue <T> ();
+      (*this) ("", element);
+      mOutput->end_schema_element ();
     }
   }
 
@@ -329,6 +650,34 @@ namespace moose
     }
   }
 
+  template <class T>
+  void Archive::archive (const char* name, T& value, EntryTypeDummy <EntryType::PerFormat>)
+  {
+    switch (format ())
+    {
+      case Format::Json:   return archive_in_format<Format::Json> (name, value);
+      case Format::Binary: return archive_in_format<Format::Binary> (name, value);
+      case Format::Other:  return archive_in_format<Format::Other> (name, value);
+    }
+  }
+
+  template <Format FORMAT, class T>
+  void Archive::archive_in_format (const char* name, T& value)
+  {
+    using Traits = typename detail::InFormat<T, FORMAT>::Traits;
+    constexpr EntryType entryType = Traits::entryType;
+    static_assert (entryType != EntryType::Value && entryType != EntryType::PerFormat,
+                   "Format specific traits may not specify `EntryType::Value` or `EntryType::PerFormat`.");
+
+    if constexpr (entryType == EntryType::Struct)
+      archive (name, value, EntryTypeDummy<EntryType::Struct> {});
+    else
+    {
+      detail::InFormat<T, FORMAT> inFormat {value};
+      archive (name, inFormat, EntryTypeDummy<entryType> {});
+    }
+  }
+
   template <class T>
   void Archive::archive (const char* name, T& value)
   {
@@ -375,4 +724,20 @@ namespace moose
     using ForwardTraits = TypeTraits<typename TRAITS::ForwardedType>;
     return contentType (ForwardTraits {}, EntryTypeDummy<ForwardTraits::entryType> {});
   }
+
+  template <class TRAITS>
+  auto Archive::contentType (TRAITS const&, EntryTypeDummy<EntryType::PerFormat>) -> ContentType
+  {
+    using JsonTraits = typename TRAITS::template Traits<Format::Json>;
+    using BinaryTraits = typename TRAITS::template Traits<Format::Binary>;
+    using OtherTraits = typename TRAITS::template Traits<Format::Other>;
+
+    switch (format ())
+    {
+      case Format::Json:   return contentType (JsonTraits {}, EntryTypeDummy<JsonTraits::entryType> {});
+      case Format::Binary: return contentType (BinaryTraits {}, EntryTypeDummy<BinaryTraits::entryType> {});
+      case Format::Other:  break;
+    }
+    return contentType (OtherTraits {}, EntryTypeDummy<OtherTraits::entryType> {});
+  }
 }// end of namespace moose
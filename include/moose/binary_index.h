@@ -0,0 +1,162 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <moose/content_type.h>
+#include <moose/exceptions.h>
+#include <moose/detail/varint.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace moose
+{
+  /// A top-level entry of binary data, see `BinaryIndex`.
+  struct BinaryIndexEntry
+  {
+    std::string name;
+    ContentType type {ContentType::Value};
+    /// Position of the entry, relative to the first byte of the binary data.
+    std::size_t offset {0};
+    /** Only set for arrays whose elements were written one by one. `true` if the size of the array was
+      stored in front of its elements, `false` if each element is preceded by a marker.*/
+    bool sized {false};
+    std::size_t elementCount {0};
+    /// Positions of every `BinaryIndex::stride`-th element, starting with the first one.
+    std::vector<std::size_t> elementOffsets {};
+  };
+
+  /** Positions of the top-level entries of binary data and of elements of top-level arrays.
+    Written behind the data if `BinaryOptions::index` is set.*/
+  struct BinaryIndex
+  {
+    std::size_t stride {0};
+    std::vector<BinaryIndexEntry> entries {};
+
+    /// Returns the first entry with the given name or `nullptr`.
+    auto find (const char* name) const -> BinaryIndexEntry const*
+    {
+      for (auto const& entry : entries)
+      {
+        if (entry.name == name)
+          return &entry;
+      }
+      return nullptr;
+    }
+  };
+}// end of namespace moose
+
+namespace moose::detail
+{
+  /// Terminates binary data with an index. Preceded by the position of the index as 64 bit little endian value.
+  constexpr char indexMagic [4] = {'M', 'I', 'D', 'X'};
+  constexpr std::size_t indexTrailerSize = 8 + sizeof (indexMagic);
+
+  /** Appends the index to `out`. All numbers are stored as varints, element offsets as differences
+    to their predecessor, followed by the trailer.*/
+  inline void encodeIndex (BinaryIndex const& index, std::size_t position, std::vector<uint8_t>& out)
+  {
+    auto const add = [&out] (uint64_t value)
+    {
+      uint8_t buffer [maxVarintSize];
+      out.insert (out.end (), buffer, buffer + encodeVarint (value, buffer));
+    };
+
+    add (index.stride);
+    add (index.entries.size ());
+    for (auto const& entry : index.entries)
+    {
+      add (entry.name.size ());
+      out.insert (out.end (), entry.name.begin (), entry.name.end ());
+      out.push_back (static_cast<uint8_t> (entry.type));
+      add (entry.offset);
+      out.push_back (static_cast<uint8_t> (entry.sized));
+      add (entry.elementCount);
+      add (entry.elementOffsets.size ());
+      auto previous = entry.offset;
+      for (auto const offset : entry.elementOffsets)
+      {
+        add (offset - previous);
+        previous = offset;
+      }
+    }
+
+    for (int i = 0; i < 8; ++i)
+      out.push_back (static_cast<uint8_t> (static_cast<uint64_t> (position) >> (8 * i)));
+    out.insert (out.end (), indexMagic, indexMagic + sizeof (indexMagic));
+  }
+
+  /// Decodes an index written by `encodeIndex` from `[in, end)`, which must not include the trailer.
+  inline auto decodeIndex (uint8_t const* in, uint8_t const* end) -> BinaryIndex
+  {
+    auto const next = [&in, end]
+    {
+      uint64_t value;
+      in = in ? decodeVarint (in, end, value) : nullptr;
+      if (!in)
+        throw ArchiveError {} << "Invalid index in binary data.";
+      return static_cast<std::size_t> (value);
+    };
+    auto const nextByte = [&in, end]
+    {
+      if (in == end)
+        throw ArchiveError {} << "Invalid index in binary data.";
+      return *in++;
+    };
+
+    BinaryIndex index;
+    index.stride = next ();
+    auto const entryCount = next ();
+    if (entryCount > static_cast<std::size_t> (end - in))
+      throw ArchiveError {} << "Invalid index in binary data.";
+    index.entries.resize (entryCount);
+    for (auto& entry : index.entries)
+    {
+      auto const nameSize = next ();
+      if (static_cast<std::size_t> (end - in) < nameSize)
+        throw ArchiveError {} << "Invalid index in binary data.";
+      entry.name.assign (reinterpret_cast<char const*> (in), nameSize);
+      in += nameSize;
+
+      auto const type = nextByte ();
+      if (type > static_cast<uint8_t> (ContentType::Value))
+        throw ArchiveError {} << "Invalid index in binary data.";
+      entry.type = static_cast<ContentType> (type);
+      entry.offset = next ();
+      entry.sized = nextByte () != 0;
+      entry.elementCount = next ();
+
+      auto const offsetCount = next ();
+      if (offsetCount > static_cast<std::size_t> (end - in))
+        throw ArchiveError {} << "Invalid index in binary data.";
+      entry.elementOffsets.resize (offsetCount);
+      auto previous = entry.offset;
+      for (auto& offset : entry.elementOffsets)
+        previous = offset = previous + next ();
+    }
+    return index;
+  }
+}// end of namespace moose::detail
@@ -0,0 +1,102 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace moose
+{
+  class EncodingCache;
+
+  enum class IntegerEncoding
+  {
+    Fixed,  ///< Integers are stored with a fixed width, see `detail::BinaryStorage`.
+    Varint, ///< Integers, string lengths and array sizes are stored as LEB128 varints. Signed integers are zig-zag encoded.
+    /** The original layout: All numbers are stored as doubles and each array element is preceded by a marker.
+      Trivially copyable types are not stored as raw bytes and arrays are not stored column by column.
+      Integers beyond 2^53 lose precision.*/
+    Legacy
+  };
+
+  /// Options of the binary format. A `BinaryReader` has to use the options of the `BinaryWriter` which created the data.
+  struct BinaryOptions
+  {
+    /// The default keeps data compatible with earlier versions. `Fixed` and `Varint` are faster and more compact.
+    IntegerEncoding integerEncoding {IntegerEncoding::Legacy};
+
+    /** If set, the encodings of objects which opted in to caching are stored in and taken from this cache.
+      Only used by writers. Share the cache between consecutive writers to benefit from it.*/
+    std::shared_ptr<EncodingCache> encodingCache {};
+
+    /** Structs and arrays whose encoding has at least this many bytes are stored only once. Repetitions are
+      stored as references to the first occurrence, which readers decode again. `0` disables deduplication.
+      Readers only check whether the value is nonzero and require a seekable stream if it is.
+      A repetition is only replaced if its encoding equals that of an earlier occurrence, so deduplicating writers
+      keep the encodings of all structs and arrays of at least this size in memory, with references in place of
+      the nested ones. They neither store arrays column by column nor use the encoding cache.*/
+    std::size_t dedupThreshold {0};
+
+    /** Stores an id of the name and the length in bytes with each member of a struct and the length with
+      each struct inside an array. Readers then skip members which are not read, detect missing members
+      and look members up in any order, like in json. Readers require a seekable stream. Tagged writers
+      keep their output in memory until the outermost entry is done. They neither store structs as raw
+      bytes or arrays column by column nor use the encoding cache. Can not be combined with `dedupThreshold`.*/
+    bool tagged {false};
+
+    /** Appends a `BinaryIndex` with the positions of all top-level entries once the writer is finished.
+      `BinaryReader::seek_entry` and `BinaryReader::seek_element` then jump directly to an entry, see
+      `fromBinaryEntry` and `fromBinaryElements`. Readers require a seekable stream.*/
+    bool index {false};
+
+    /** If `index` is set, the position of every `indexStride`-th element of top-level arrays is stored as well,
+      if the elements are written one by one. `0` stores no positions of elements.*/
+    std::size_t indexStride {0};
+
+    /** Writes a header in front of the data, which holds a magic number, the version of the format, the byte
+      order and the flags of all options which readers need. Readers with this flag reject data without valid
+      header and take `integerEncoding`, `dedupThreshold`, `tagged`, `index`, `byteOrder` and `schema` from it.*/
+    bool header {false};
+
+    /** Byte order in which writers store fixed width numbers. Orders other than the native one require `header`.
+      Readers convert data of the other byte order while reading. Trivially copyable types are then read and
+      written value by value.*/
+    std::endian byteOrder {std::endian::native};
+
+    /** Fingerprint of the schema of the stored data, see `schemaFingerprint`. Only stored if `header` is set.
+      Readers with a nonzero fingerprint reject data with a different stored fingerprint before reading any
+      entry, unless the data is `tagged`. Otherwise they take the stored fingerprint, or `0` if the data has none.
+      `toBinary` and `fromBinary` set the fingerprint of the serialized type if `header` is set, `tagged` is not
+      set and no fingerprint is given, since tagged data can be read by types with added or removed members.*/
+    uint64_t schema {0};
+
+    /** Writers collect the elements of arrays with `Hint::Columnar` in memory until the array is done. Once the
+      collected elements take more than this many bytes, or differ in their structure, the array is stored
+      element by element instead and its remaining elements are no longer collected. Only possible for arrays
+      whose size is written before the elements, as by all ranges of known size.*/
+    std::size_t columnarLimit {std::size_t {1} << 24};
+  };
+}// end of namespace moose
@@ -0,0 +1,156 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <moose/archive.h>
+#include <moose/event_tape.h>
+#include <moose/export.h>
+#include <moose/writer.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace moose
+{
+  /** Creates a patch which transforms `baseline` into `current`.
+    Both tapes are compared entry by entry. The patch only contains the values which differ and,
+    for arrays, the elements which were appended. Removed trailing elements are recorded by
+    the new size of the array. Entries whose structure changed are stored as a whole.*/
+  MOOSE_EXPORT auto createPatch (EventTape const& baseline, EventTape const& current) -> std::string;
+
+  /** Creates a patch which transforms `baseline` into the entries and values written to this writer.
+    The written entries are compared with the baseline while they are written, so only the baseline is
+    recorded. `patch` returns the same patch as `createPatch` with a tape of the written entries.*/
+  class PatchWriter : public Writer
+  {
+  public:
+    MOOSE_EXPORT PatchWriter (EventTape const& baseline);
+
+    /// The patch, once all entries are done.
+    MOOSE_EXPORT auto patch () const -> std::string;
+
+    bool begin_entry (const char* name, ContentType type, Hint hint) override;
+    void end_entry (const char* name, ContentType type) override;
+
+    void write_type_name (std::string const& typeName) override;
+    void write_type_version (Version const& version) override;
+
+    void write (const char* name, bool value) override;
+    void write (const char* name, double value) override;
+    void write (const char* name, std::string const& value) override;
+    void write (const char* name, char value) override;
+    void write (const char* name, unsigned char value) override;
+    void write (const char* name, int value) override;
+    void write (const char* name, long int value) override;
+    void write (const char* name, long long int value) override;
+    void write (const char* name, unsigned int value) override;
+    void write (const char* name, unsigned long int value) override;
+    void write (const char* name, unsigned long long int value) override;
+    using Writer::write;
+
+  private:
+    /// An entry which is compared with an entry of the baseline, or the top level.
+    struct Level
+    {
+      /// Next child of the baseline entry and the end of its children.
+      std::size_t mBaseNext;
+      std::size_t mBaseLast;
+      std::size_t mCount {0};
+      std::size_t mChangeCount {0};
+      /// Index of the child after the last changed one.
+      std::size_t mExpected {0};
+      std::string mChanges {};
+      std::string mAppended {};
+    };
+
+    void leaf (EventTape::Value const& value);
+    /// Advances to the next child of `level`. Returns the child of the baseline it is compared with,
+    /// or `nullptr` if it is appended.
+    auto next_child (Level& level) const -> EventTape::Event const*;
+    /// Records that the last child of `level` changed. Returns the string to which its operation is appended.
+    auto begin_change (Level& level) const -> std::string&;
+
+  private:
+    EventTape const* mBaseline;
+    std::vector<Level> mLevels;
+    /// Entries which are written as a whole, since they are appended or replace an entry of the baseline.
+    std::size_t mRawDepth {0};
+    std::string* mRaw {nullptr};
+  };
+
+  /// Reconstructs the tape from which a patch was created from the baseline of the patch.
+  MOOSE_EXPORT auto applyPatch (EventTape const& baseline, std::string_view patch) -> EventTape;
+
+  /// Records all entries and values which `Serialize` writes for `t`.
+  template <class T>
+  auto toEventTape (T const& t) -> EventTape
+  {
+    EventTape tape;
+    Archive archive {std::make_shared<TapeWriter> (tape)};
+    archive ("", t);
+    return tape;
+  }
+
+  template <class T>
+  void fromEventTape (T& out, EventTape const& tape)
+  {
+    Archive archive {std::make_shared<TapeReader> (tape)};
+    archive ("", out);
+  }
+
+  /** Creates a binary patch which contains the changes from `baseline` to `current`.
+    The size of the patch is proportional to the number of changed values, but creating it is not:
+    Changes are not tracked, so both objects are serialized completely. `baseline` is recorded to a tape,
+    against which `current` is compared while it is serialized, see `PatchWriter`. The cost thus scales
+    with the size of the objects. Arrays are compared by position, so only appended and removed trailing
+    elements are stored compactly. Inserting or removing elements elsewhere changes all following elements.
+    Use `fromBinaryPatch` with the same `baseline` to reconstruct `current`, which serializes `baseline` again.*/
+  template <class T>
+  auto toBinaryPatch (T const& baseline, T const& current) -> std::shared_ptr<std::stringstream>
+  {
+    auto const tape = toEventTape (baseline);
+    auto const writer = std::make_shared<PatchWriter> (tape);
+    Archive archive {writer};
+    archive ("", current);
+    return std::make_shared<std::stringstream> (writer->patch ());
+  }
+
+  template <class T>
+  void fromBinaryPatch (T& out, T const& baseline, std::shared_ptr<std::stringstream> patch)
+  {
+    fromEventTape (out, applyPatch (toEventTape (baseline), patch->str ()));
+  }
+
+  template <class T>
+  T fromBinaryPatch (T const& baseline, std::shared_ptr<std::stringstream> patch)
+  {
+    T out;
+    fromBinaryPatch (out, baseline, std::move (patch));
+    return out;
+  }
+}// end of namespace moose
@@ -23,23 +23,39 @@
 // THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <moose/binary_index.h>
+#include <moose/binary_options.h>
 #include <moose/export.h>
 #include <moose/reader.h>
+#include <moose/detail/binary_encoding.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <ios>
 #include <memory>
+#include <optional>
+#include <span>
 #include <stack>
+#include <vector>
 
 namespace moose
 {
   class BinaryReader : public Reader {
   public:
-    MOOSE_EXPORT static auto fromFile (const char* filename) -> std::shared_ptr<BinaryReader>;
+    MOOSE_EXPORT static auto fromFile (const char* filename, BinaryOptions options = {}) -> std::shared_ptr<BinaryReader>;
 
   public:
     BinaryReader () = delete;
     MOOSE_EXPORT BinaryReader (BinaryReader&& other) = default;
-    MOOSE_EXPORT BinaryReader (std::istream& in);
-    MOOSE_EXPORT BinaryReader (std::shared_ptr<std::istream> in);
+    MOOSE_EXPORT BinaryReader (std::istream& in, BinaryOptions options = {});
+    MOOSE_EXPORT BinaryReader (std::shared_ptr<std::istream> in, BinaryOptions options = {});
+
+    /** Reads directly from memory, without a stream in between.
+      The data is not copied and has to outlive the reader.*/
+    MOOSE_EXPORT BinaryReader (std::span<std::byte const> data, BinaryOptions options = {});
+
+    /// Reads directly from memory, which is kept alive by the reader.
+    MOOSE_EXPORT BinaryReader (std::shared_ptr<std::vector<std::byte> const> data, BinaryOptions options = {});
 
     BinaryReader (BinaryReader const&) = delete;
 
@@ -48,10 +64,30 @@ namespace moose
     BinaryReader& operator = (BinaryReader const&) = delete;
     MOOSE_EXPORT BinaryReader& operator = (BinaryReader&& other) = default;
 
+    auto format () const -> Format override;
+
+    /** The schema fingerprint which is stored in the header of the data, or `0` if the data has none.
+      Allows to route data to the matching type, see `schemaFingerprint`.*/
+    auto schema_fingerprint () const -> uint64_t;
+
+    /// The index of the data. Throws if `BinaryOptions::index` is not set.
+    auto index () const -> BinaryIndex const&;
+
+    /** Positions the reader at the top-level entry with the given name, which is then read by
+      `begin_entry` with the same name. Returns `false` if the index does not contain the entry.*/
+    bool seek_entry (const char* name);
+
+    /** Positions the reader at an element of the top-level array with the given name. Elements are then
+      read through unnamed entries. Only the position of every `BinaryIndex::stride`-th element is stored.
+      Returns the number of elements in front of the requested one, which have to be read first.*/
+    auto seek_element (const char* name, std::size_t element) -> std::size_t;
+
     bool begin_entry (const char* name, ContentType type) override;
     void end_entry (const char* name, ContentType type) override;
 
     bool array_has_next (const char* name) const override;
+    /// Throws an `ArchiveError` if the remaining data can not hold the elements of an array of numbers.
+    auto array_size (const char* name) const -> std::optional<std::size_t> override;
 
     auto type_name () const -> std::string override;
     auto type_version () const -> Version override;
@@ -59,23 +95,138 @@ namespace moose
     void read (const char* name, bool& value) const override;
     void read (const char* name, double& value) const override;
     void read (const char* name, std::string& value) const override;
+    void read (const char* name, PackedBits& value) const override;
+    void read (const char* name, char& value) const override;
+    void read (const char* name, unsigned char& value) const override;
+    void read (const char* name, int& value) const override;
+    void read (const char* name, long int& value) const override;
+    void read (const char* name, long long int& value) const override;
+    void read (const char* name, unsigned int& value) const override;
+    void read (const char* name, unsigned long int& value) const override;
+    void read (const char* name, unsigned long long int& value) const override;
+    using Reader::read;
+
+    void read_array (const char* name, std::span<char> values) override;
+    void read_array (const char* name, std::span<unsigned char> values) override;
+    void read_array (const char* name, std::span<int> values) override;
+    void read_array (const char* name, std::span<long int> values) override;
+    void read_array (const char* name, std::span<long long int> values) override;
+    void read_array (const char* name, std::span<unsigned int> values) override;
+    void read_array (const char* name, std::span<unsigned long int> values) override;
+    void read_array (const char* name, std::span<unsigned long long int> values) override;
+    void read_array (const char* name, std::span<float> values) override;
+    void read_array (const char* name, std::span<double> values) override;
+
+    bool read_raw (const char* name, RawLayout const& layout, void* data, std::size_t count) override;
 
   private:
+    /// Block of an array which was stored with a codec. Decoded once the values are read.
+    struct EncodedValues;
+
     struct Entry
     {
       ContentType mType;
       bool mArrayHasNext {false};
+      bool mSized {false};
+      std::size_t mRemaining {0};
+      /// Size in bytes of a block of packed varints. Only valid as long as no element has been read.
+      std::size_t mPackedBytes {0};
+      /// Set for arrays of trivially copyable elements, which are stored as raw bytes.
+      std::optional<RawLayout> mRawLayout {};
+      /** Set for arrays which were stored with a codec and for their elements. Arrays of numbers which are
+        read as a whole are decoded into their destination. Otherwise, all values are decoded once the first
+        value is read. Arrays read from value `mSize - mRemaining` on.*/
+      std::shared_ptr<EncodedValues> mEncoded {};
+      /// Index of the value of an element of an array with encoded values.
+      std::size_t mEncodedIndex {0};
+      /// Set for entries which were stored as reference. Reading continues there once the entry is done.
+      std::optional<std::streampos> mReturnPosition {};
+      /** Only used for tagged data. The end of the entry, if its length was stored, and for structs the range
+        of their members and the position of the member which is expected to be read next.*/
+      std::optional<std::streampos> mEnd {};
+      std::streampos mMembersBegin {};
+      std::streampos mCursor {};
+    };
+
+    /// The encoded values of one member of all elements of a columnar array.
+    struct Column
+    {
+      std::vector<uint8_t> mBytes;
+      std::size_t mPosition {0};
+    };
+
+    /// The columns of the columnar array which is currently being read.
+    struct Columns
+    {
+      /// Size of the entry stack while the columnar array is the current entry.
+      std::size_t mDepth;
+      std::vector<detail::ColumnToken> mShape;
+      std::vector<Column> mColumns;
+      std::size_t mNextColumn {0};
+      Column* mCurrent {nullptr};
     };
 
   private:
+    void initialize ();
     auto current () -> Entry&;
     auto current () const -> Entry const&;
+    auto readArrayHeader () -> Entry;
+    void readIndex ();
+    /// Leaves all entries and positions the stream at the given offset from `mOrigin`.
+    void reset (std::size_t offset);
+    auto readStructTag () -> std::optional<std::streampos>;
+    auto followReference () -> std::streampos;
+    /// Positions the stream at the content of the member with the given name and returns its end.
+    auto findMember (const char* name) -> std::optional<std::streampos>;
+    bool atMembersEnd (Entry const& entry, std::streampos position) const;
+    auto readLayout () const -> RawLayout;
+    void readColumns ();
+    void begin_value (std::size_t depth) const;
     bool readArrayHasNext ();
     auto in () const -> std::istream&;
+    /// Returns `true` if the next bytes are taken directly from `mData`.
+    bool from_memory () const;
+    auto tell () const -> std::streampos;
+    void seek (std::streampos position) const;
+    /// Position behind the last byte of the data.
+    auto data_end () const -> std::streampos;
+    /** Number of bytes which can still be read, used to reject corrupt sizes before allocating. Only known
+      for data in memory and inside columnar arrays, since streams would have to seek.*/
+    auto remaining_bytes () const -> std::optional<std::size_t>;
+    void read_bytes (void* data, std::size_t size) const;
+    auto read_varint () const -> uint64_t;
+    /// Returns the next `size` bytes, which remain valid until the next call.
+    auto read_block (std::size_t size) -> uint8_t const*;
+
+    template <class FIXED>
+    auto read_size () const -> std::size_t;
+
+    template <class T>
+    void read_number (T& value) const;
+
+    template <class T>
+    void read_numbers (const char* name, std::span<T> values);
 
   private:
     std::shared_ptr<std::istream> mStreamStorage;
+    /// `nullptr` if the reader reads from `mData` instead.
     std::istream* mIn;
-    std::stack<Entry> mEntries;
+    BinaryOptions mOptions;
+    std::shared_ptr<std::vector<std::byte> const> mDataStorage;
+    std::span<std::byte const> mData;
+    mutable std::size_t mPosition {0};
+    /// Position of the first byte, to which the offsets of references refer.
+    std::streampos mOrigin {};
+    /// Position of the first entry, behind the header.
+    std::streampos mBegin {};
+    /// Set if fixed width numbers are stored in the other than the native byte order.
+    bool mSwapBytes {false};
+    std::stack<Entry, std::vector<Entry>> mEntries;
+    std::vector<uint8_t> mScratch;
+    /// Values are read from the current column instead of the stream while this is set.
+    mutable std::optional<Columns> mColumnar;
+    BinaryIndex mIndex;
+    /// Position of the index, which ends the data, if `BinaryOptions::index` is set.
+    std::optional<std::streampos> mDataEnd;
   };
 }// end of namespace moose
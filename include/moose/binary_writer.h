@@ -24,10 +24,22 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <stack>
 #include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+#include <moose/binary_index.h>
+#include <moose/binary_options.h>
+#include <moose/encoding_cache.h>
 #include <moose/writer.h>
+#include <moose/detail/binary_encoding.h>
+#include <moose/detail/subtree_hash.h>
+
+#include <unordered_map>
 
 namespace moose
 {
@@ -39,22 +51,29 @@ template <class STREAM = std::ofstream>
 class BinaryWriter : public Writer
 {
 public:
-  static auto toFile (const char* filename) -> std::shared_ptr<BinaryWriter>;
+  static auto toFile (const char* filename, BinaryOptions options = {}) -> std::shared_ptr<BinaryWriter>;
 
-  BinaryWriter (STREAM& out);
-  BinaryWriter (std::shared_ptr<STREAM> out);
+  BinaryWriter (STREAM& out, BinaryOptions options = {});
+  BinaryWriter (std::shared_ptr<STREAM> out, BinaryOptions options = {});
   
   BinaryWriter (BinaryWriter const&) = delete;
   BinaryWriter (BinaryWriter&& other) = default;
   
 
-  ~BinaryWriter () override = default;
+  ~BinaryWriter () override;
 
   BinaryWriter& operator = (BinaryWriter const&) = delete;
   BinaryWriter& operator = (BinaryWriter&& other) = default;
 
+  auto format () const -> Format override;
+
+  /** Writes the index, if `BinaryOptions::index` is set. Called by the destructor, if it was not called before.
+    No further entries may be written afterwards.*/
+  void finish ();
+
   bool begin_entry (const char* name, ContentType type, Hint hint) override;
   void end_entry (const char* name, ContentType type) override;
+  void write_array_size (std::size_t size) override;
 
   void write_type_name (std::string const& typeName) override;
   void write_type_version (Version const& version) override;
@@ -62,15 +81,160 @@ public:
   void write (const char* name, bool value) override;
   void write (const char* name, double value) override;
   void write (const char* name, std::string const& value) override;
+  void write (const char* name, PackedBits const& value) override;
+  void write (const char* name, char value) override;
+  void write (const char* name, unsigned char value) override;
+  void write (const char* name, int value) override;
+  void write (const char* name, long int value) override;
+  void write (const char* name, long long int value) override;
+  void write (const char* name, unsigned int value) override;
+  void write (const char* name, unsigned long int value) override;
+  void write (const char* name, unsigned long long int value) override;
+  using Writer::write;
+
+  void write_array (const char* name, std::span<char const> values) override;
+  void write_array (const char* name, std::span<unsigned char const> values) override;
+  void write_array (const char* name, std::span<int const> values) override;
+  void write_array (const char* name, std::span<long int const> values) override;
+  void write_array (const char* name, std::span<long long int const> values) override;
+  void write_array (const char* name, std::span<unsigned int const> values) override;
+  void write_array (const char* name, std::span<unsigned long int const> values) override;
+  void write_array (const char* name, std::span<unsigned long long int const> values) override;
+  void write_array (const char* name, std::span<float const> values) override;
+  void write_array (const char* name, std::span<double const> values) override;
+
+  bool write_raw (const char* name, RawLayout const& layout, void const* data, std::size_t count) override;
+  bool write_cached (const char* name, ContentType type, Hint hint, CacheKey const& key) override;
+
+private:
+  /// The layout of an array is decided when its size or its first element is written.
+  enum class ArrayLayout
+  {
+    Undecided,
+    Markers,
+    Sized
+  };
+
+  /** Encoding of a subtree which repetitions may reference. Children which repetitions may reference
+    are replaced by references in `mBytes`, since repetitions store them as references as well.*/
+  struct Occurrence
+  {
+    std::size_t mOffset;
+    std::vector<uint8_t> mBytes;
+  };
+
+  /// A child in `mBuffer` which was stored inline and which repetitions may reference.
+  struct InlineSubtree
+  {
+    std::size_t mBegin;
+    std::size_t mEnd;
+    std::size_t mOffset;
+    ContentType mType;
+  };
+
+  struct Entry
+  {
+    ContentType mType;
+    ArrayLayout mLayout {ArrayLayout::Undecided};
+    bool mColumnar {false};
+    Hint mHint {Hint::None};
+    /// Set if the content of the entry was spliced from the encoding cache.
+    bool mComplete {false};
+    /// Set if the encoding of the entry is recorded for the encoding cache.
+    std::optional<CacheKey> mCacheKey {};
+    std::size_t mRecordingBegin {0};
+    /// Position of the entry in `mBuffer`, hash of its content and children which may be referenced.
+    /// Only used while deduplicating.
+    std::size_t mBegin {0};
+    detail::SubtreeHash mHash {};
+    std::vector<InlineSubtree> mInlineChildren {};
+    /// Position of the length of the entry in `mBuffer`, if the data is tagged and the entry stores its length.
+    std::optional<std::size_t> mLengthPosition {};
+  };
+
+  /** Collects the elements of an array with `Hint::Columnar` until the array is done, or until the array is
+    written element by element since its elements differ or exceed `BinaryOptions::columnarLimit`.
+    The bytes of all elements are stored in their regular order, together with the
+    offset at which each value begins.*/
+  struct Capture
+  {
+    /// Size of the entry stack while the columnar array is the current entry.
+    std::size_t mDepth;
+    /// Number of elements, if it was written before the elements.
+    std::optional<std::size_t> mSize {};
+    std::size_t mElementCount {0};
+    /// Offsets of the elements which are stored in the index, if the array is a top-level entry.
+    std::vector<std::size_t> mElementBegins {};
+    std::vector<uint8_t> mBytes {};
+    std::vector<std::size_t> mValueOffsets {};
+    /// The tokens of the first element. All other elements are compared against it.
+    std::vector<detail::ColumnToken> mShape {};
+    std::size_t mShapePosition {0};
+    /// Set to `false` if the elements can not be stored column by column.
+    bool mColumnar {true};
+  };
 
 private:
+  void initialize ();
   auto out () -> STREAM&;
+  bool in_columnar_element () const;
+  bool deduplicating () const;
+  bool tagged () const;
+  /// Returns `true` if the output is collected in `mBuffer` first.
+  bool buffering () const;
+  /// Position of the next byte, relative to the first byte written by this writer.
+  auto position () const -> std::size_t;
+  void add_to_index (const char* name, ContentType type);
+  void add_element_to_index (Entry const& parent);
+  void begin_frame (ContentType parentType, const char* name, ContentType type);
+  void end_frame (std::size_t lengthPosition);
+  /** Adds the finished entry to its parent and replaces it by a reference if an equal encoding was stored before.
+    Returns `true` if the entry was replaced.*/
+  bool deduplicate (Entry const& entry, ContentType type, detail::SubtreeHash const& hash);
+  /// Stores the encoding of `entry` in `mCanonical`, with references in place of its inline children.
+  void canonical_encoding (Entry const& entry);
+  void flush_buffer ();
+  void add_column_token (detail::ColumnToken token);
+  void begin_value ();
+  void write_columns ();
+  /// Writes the collected elements one after another and the remaining elements directly.
+  void write_captured_rows ();
+  void write_rows (Capture const& capture, std::size_t count, bool topLevel);
+  void write_bytes (void const* data, std::size_t size);
+  void write_marker (char marker);
+  void write_layout (RawLayout const& layout);
+
+  template <class FIXED>
+  void write_size (std::size_t size);
+
+  template <class T>
+  void write_number (T value);
+
+  template <class T>
+  void write_numbers (std::span<T const> values);
 
 private:
   std::shared_ptr<STREAM> mStreamStorage;
   STREAM* mOut;
-  std::stack<ContentType> mContentStack;
-  std::stack<std::string> mNameStack;
+  BinaryOptions mOptions;
+  std::stack<Entry, std::vector<Entry>> mEntries;
+  std::vector<uint8_t> mScratch;
+  std::optional<Capture> mCapture;
+  /// Key for the encoding of the next entry, if it shall be recorded.
+  std::optional<CacheKey> mPendingCacheKey;
+  /// All bytes written since the outermost recorded entry began.
+  std::vector<uint8_t> mRecording;
+  std::size_t mActiveRecordings {0};
+  /// Output which may still be modified, while deduplicating or writing tagged data.
+  std::vector<uint8_t> mBuffer;
+  /// Number of bytes written to the stream.
+  std::size_t mFlushedBytes {0};
+  BinaryIndex mIndex;
+  /** Occurrences of all subtrees which may be referenced, by the hash of their content. A subtree only has
+    more than one occurrence if the hashes of different encodings collide.*/
+  std::unordered_map<detail::SubtreeKey, std::vector<Occurrence>, detail::SubtreeKeyHash> mSubtrees;
+  /// Encoding of the subtree which is currently deduplicated, see `canonical_encoding`.
+  std::vector<uint8_t> mCanonical;
 };
 
 }// end of namespace moose
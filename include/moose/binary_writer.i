@@ -21,96 +21,464 @@
 // ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
 // THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-
 #pragma once
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
 #include <moose/binary_writer.h>
 #include <moose/exceptions.h>
+#include <moose/packed_bits.h>
+#include <moose/detail/binary_encoding.h>
+#include <moose/detail/byte_order.h>
+#include <moose/detail/codecs.h>
 #include <moose/detail/forward_if_not_nullptr.h>
+#include <moose/detail/varint.h>
 
 namespace moose
 {
   template <class STREAM>
-  auto BinaryWriter<STREAM>::toFile (const char* filename) -> std::shared_ptr<BinaryWriter>
+  auto BinaryWriter<STREAM>::toFile (const char* filename, BinaryOptions options) -> std::shared_ptr<BinaryWriter>
   {
     auto out = std::make_shared<std::ofstream> (filename, std::ios::out | std::ios::binary);
     if (!(*out)) throw ArchiveError () << "File not accessible: " << filename;
-    return std::make_shared<BinaryWriter> (std::move (out));
+    return std::make_shared<BinaryWriter> (std::move (out), options);
   }
 
   template <class STREAM>
-  BinaryWriter<STREAM>::BinaryWriter (STREAM& out)
+  BinaryWriter<STREAM>::BinaryWriter (STREAM& out, BinaryOptions options)
     : mOut {&out}
+    , mOptions {options}
   {
-    mContentStack.push (ContentType::Struct);
-    mNameStack.push ("");
+    initialize ();
   }
 
   template <class STREAM>
-  BinaryWriter<STREAM>::BinaryWriter (std::shared_ptr<STREAM> out)
+  BinaryWriter<STREAM>::BinaryWriter (std::shared_ptr<STREAM> out, BinaryOptions options)
     : mStreamStorage {detail::forwardIfNotNullptr<ArchiveError> (std::move (out), "Invalid stream provided")}
     , mOut {mStreamStorage.get ()}
+    , mOptions {options}
+  {
+    initialize ();
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::initialize ()
   {
-    mContentStack.push (ContentType::Struct);
-    mNameStack.push ("");
+    detail::checkBinaryOptions (mOptions);
+    mEntries.push ({ContentType::Struct});
+    if (mOptions.header)
+    {
+      auto const header = detail::encodeHeader (mOptions);
+      out ().write (reinterpret_cast<char const*> (header.data ()), static_cast<std::streamsize> (header.size ()));
+      mFlushedBytes += header.size ();
+    }
   }
 
   template <class STREAM>
-  bool BinaryWriter<STREAM>::begin_entry (const char* name, ContentType type, Hint)
+  BinaryWriter<STREAM>::~BinaryWriter ()
   {
-    if (mContentStack.top () == ContentType::Array)
+    // Moved-from writers and writers which were left by an exception have no pending index.
+    if (mEntries.size () == 1)
+      finish ();
+  }
+
+  template <class STREAM>
+  auto BinaryWriter<STREAM>::format () const -> Format
+  {
+    return Format::Binary;
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::finish ()
+  {
+    if (!mOptions.index)
+      return;
+    if (mEntries.size () != 1)
+      throw ArchiveError () << "The index can only be written once all entries are done.";
+
+    mOptions.index = false;
+    mScratch.clear ();
+    detail::encodeIndex (mIndex, position (), mScratch);
+    out ().write (reinterpret_cast<char const*> (mScratch.data ()), static_cast<std::streamsize> (mScratch.size ()));
+    mFlushedBytes += mScratch.size ();
+  }
+
+  template <class STREAM>
+  bool BinaryWriter<STREAM>::begin_entry (const char* name, ContentType type, Hint hint)
+  {
+    auto& parent = mEntries.top ();
+    if (mOptions.index && mEntries.size () == 1)
+      add_to_index (name, type);
+
+    if (parent.mColumnar)
+    {
+      // The positions of elements are needed if the array is stored element by element later on.
+      auto& capture = *mCapture;
+      if (mOptions.index && mEntries.size () == 2 && mOptions.indexStride > 0 && capture.mElementCount % mOptions.indexStride == 0)
+        capture.mElementBegins.push_back (capture.mBytes.size ());
+      ++capture.mElementCount;
+      capture.mShapePosition = 0;
+    }
+    else if (parent.mType == ContentType::Array)
+    {
+      if (parent.mLayout == ArrayLayout::Undecided)
+        parent.mLayout = ArrayLayout::Markers;
+
+      if (parent.mLayout == ArrayLayout::Markers)
+      {
+        if (in_columnar_element ())
+          mCapture->mColumnar = false;
+        write_marker (static_cast<char> (detail::ArrayMarker::Element)); // add marker that an array element follows
+      }
+
+      if (mOptions.index && mEntries.size () == 2 && !mCapture)
+        add_element_to_index (parent);
+    }
+
+    auto const parentType = parent.mType;
+    mEntries.push ({type, ArrayLayout::Undecided, false, hint});
+
+    if (tagged ())
+      begin_frame (parentType, name, type);
+
+    if (deduplicating ())
+    {
+      mEntries.top ().mBegin = mBuffer.size ();
+      if (type == ContentType::Struct)
+        mBuffer.push_back (static_cast<uint8_t> (detail::SubtreeTag::Inline));
+    }
+
+    if (type == ContentType::Array && hint == Hint::Columnar && !mCapture && !buffering ()
+        && mOptions.integerEncoding != IntegerEncoding::Legacy)
+    {
+      mEntries.top ().mColumnar = true;
+      mCapture.emplace (mEntries.size ());
+    }
+    else if (in_columnar_element ())
+    {
+      switch (type)
+      {
+        case ContentType::Array:  add_column_token (detail::ColumnToken::BeginArray); break;
+        case ContentType::Struct: add_column_token (detail::ColumnToken::BeginStruct); break;
+        case ContentType::Value:  add_column_token (detail::ColumnToken::BeginValue); break;
+      }
+    }
+
+    if (mPendingCacheKey)
     {
-      char constexpr arrayElement = 1;
-      out ().write (&arrayElement, 1); // add marker that an array element follows
+      auto& entry = mEntries.top ();
+      entry.mCacheKey = std::move (mPendingCacheKey);
+      entry.mRecordingBegin = mRecording.size ();
+      mPendingCacheKey.reset ();
+      ++mActiveRecordings;
     }
-    mContentStack.push (type);
-    mNameStack.push (name); // DEBUG CODE
     return true;
   }
 
   template <class STREAM>
   void BinaryWriter<STREAM>::end_entry (const char*, ContentType type)
   {
-    if (type == ContentType::Array)
+    auto entry = std::move (mEntries.top ());
+    if (entry.mColumnar)
     {
-      char constexpr noArrayElement = 0;
-      out ().write (&noArrayElement, 1); // add marker that the array is done
+      mEntries.pop ();
+      write_columns ();
+    }
+    else
+    {
+      if (type == ContentType::Array && entry.mLayout != ArrayLayout::Sized && !entry.mComplete)
+      {
+        if (in_columnar_element ())
+          mCapture->mColumnar = false;
+        write_marker (static_cast<char> (detail::ArrayMarker::End)); // add marker that the array is done
+      }
+
+      bool writeRows = false;
+      if (in_columnar_element ())
+      {
+        add_column_token (detail::ColumnToken::End);
+        auto const& capture = *mCapture;
+        bool const elementDone = mEntries.size () == capture.mDepth + 1;
+        if (elementDone && capture.mElementCount > 1 && capture.mShapePosition != capture.mShape.size ())
+          mCapture->mColumnar = false;
+
+        // Collecting the elements is only worth it while they can be stored as columns and fit into memory.
+        auto const collected = capture.mBytes.size () + capture.mValueOffsets.size () * sizeof (std::size_t);
+        writeRows = elementDone && capture.mSize && (!capture.mColumnar || collected > mOptions.columnarLimit);
+      }
+
+      // The end marker was added to the entry on the stack, not to the moved one.
+      auto const hash = mEntries.top ().mHash;
+      mEntries.pop ();
+      if (writeRows)
+        write_captured_rows ();
+
+      if (deduplicating () && deduplicate (entry, type, hash) && mOptions.index && mEntries.size () == 1)
+      {
+        // the elements of a replaced top-level array are stored elsewhere
+        mIndex.entries.back ().elementOffsets.clear ();
+        mIndex.entries.back ().elementCount = 0;
+      }
+      if (entry.mLengthPosition)
+        end_frame (*entry.mLengthPosition);
+      if (buffering () && mEntries.size () == 1)
+        flush_buffer ();
+    }
+
+    if (entry.mCacheKey)
+    {
+      auto const recorded = std::span {mRecording}.subspan (entry.mRecordingBegin);
+      mOptions.encodingCache->insert (*entry.mCacheKey, recorded);
+      if (--mActiveRecordings == 0)
+        mRecording.clear ();
     }
-    mContentStack.pop ();
-    mNameStack.pop ();
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write_array_size (std::size_t size)
+  {
+    auto& entry = mEntries.top ();
+    if (entry.mType != ContentType::Array || entry.mLayout != ArrayLayout::Undecided)
+      throw ArchiveError () << "The size of an array has to be written before its elements.";
+
+    if (entry.mColumnar)
+    {
+      entry.mLayout = ArrayLayout::Sized;
+      mCapture->mSize = size;
+      return; // the size is written together with the columns
+    }
+    if (mOptions.integerEncoding == IntegerEncoding::Legacy)
+      return; // each element is preceded by a marker instead
+
+    entry.mLayout = ArrayLayout::Sized;
+    if (in_columnar_element ())
+      mCapture->mColumnar = false;
+
+    write_marker (static_cast<char> (detail::ArrayMarker::Sized));
+    write_size<uint64_t> (size);
   }
 
   template <class STREAM>
   void BinaryWriter<STREAM>::write_type_name (std::string const& name)
   {
+    if (!tagged ())
+      return write ("", name);
+
+    begin_entry ("@type", ContentType::Value, Hint::None);
     write ("", name);
+    end_entry ("@type", ContentType::Value);
   }
 
   template <class STREAM>
   void BinaryWriter<STREAM>::write_type_version (Version const& version)
   {
+    if (!tagged ())
+      return write ("", version.toString ());
+
+    begin_entry ("@version", ContentType::Value, Hint::None);
     write ("", version.toString ());
+    end_entry ("@version", ContentType::Value);
   }
   
   template <class STREAM>
   void BinaryWriter<STREAM>::write (const char*, bool value)
   {
+    begin_value ();
     auto const charValue = static_cast<char> (value);
-    out ().write (&charValue, 1);
+    write_bytes (&charValue, 1);
   }
 
   template <class STREAM>
   void BinaryWriter<STREAM>::write (const char*, double value)
   {
-    out ().write (reinterpret_cast<char*> (&value), sizeof (double));
+    begin_value ();
+    write_number (value);
   }
 
   template <class STREAM>
   void BinaryWriter<STREAM>::write (const char*, std::string const& value)
   {
-    auto size = static_cast<uint32_t> (value.size ());
-    out ().write (reinterpret_cast<char*> (&size), sizeof (uint32_t));
-    out ().write (value.data (), size);
+    begin_value ();
+    write_size<uint32_t> (value.size ());
+    write_bytes (value.data (), value.size ());
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write (const char*, PackedBits const& value)
+  {
+    // The bits are stored as bytes, which are the bytes of the words in little endian order.
+    begin_value ();
+    write_size<uint64_t> (value.size);
+    auto const byteCount = (value.size + 7) / 8;
+    if constexpr (std::endian::native == std::endian::little)
+      write_bytes (value.words.data (), byteCount);
+    else
+    {
+      mScratch.resize (value.words.size () * sizeof (uint64_t));
+      for (std::size_t i = 0; i < value.words.size (); ++i)
+      {
+        auto const word = detail::littleEndian (value.words [i]);
+        std::memcpy (mScratch.data () + i * sizeof (uint64_t), &word, sizeof (uint64_t));
+      }
+      write_bytes (mScratch.data (), byteCount);
+    }
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write (const char*, char value)
+  {
+    begin_value ();
+    write_number (value);
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write (const char*, unsigned char value)
+  {
+    begin_value ();
+    write_number (value);
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write (const char*, int value)
+  {
+    begin_value ();
+    write_number (value);
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write (const char*, long int value)
+  {
+    begin_value ();
+    write_number (value);
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write (const char*, long long int value)
+  {
+    begin_value ();
+    write_number (value);
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write (const char*, unsigned int value)
+  {
+    begin_value ();
+    write_number (value);
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write (const char*, unsigned long int value)
+  {
+    begin_value ();
+    write_number (value);
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write (const char*, unsigned long long int value)
+  {
+    begin_value ();
+    write_number (value);
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write_array (const char*, std::span<char const> values)
+  {write_numbers (values);}
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write_array (const char*, std::span<unsigned char const> values)
+  {write_numbers (values);}
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write_array (const char*, std::span<int const> values)
+  {write_numbers (values);}
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write_array (const char*, std::span<long int const> values)
+  {write_numbers (values);}
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write_array (const char*, std::span<long long int const> values)
+  {write_numbers (values);}
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write_array (const char*, std::span<unsigned int const> values)
+  {write_numbers (values);}
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write_array (const char*, std::span<unsigned long int const> values)
+  {write_numbers (values);}
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write_array (const char*, std::span<unsigned long long int const> values)
+  {write_numbers (values);}
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write_array (const char*, std::span<float const> values)
+  {write_numbers (values);}
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write_array (const char*, std::span<double const> values)
+  {write_numbers (values);}
+
+  template <class STREAM>
+  bool BinaryWriter<STREAM>::write_raw (const char*, RawLayout const& layout, void const* data, std::size_t count)
+  {
+    auto& entry = mEntries.top ();
+    if (entry.mColumnar)
+      return false; // the elements are split into columns instead
+    if (tagged () && entry.mType == ContentType::Struct)
+      return false; // the members are tagged instead
+    if (detail::swapsBytes (mOptions))
+      return false; // the bytes of each value are swapped instead
+    if (mOptions.integerEncoding == IntegerEncoding::Legacy)
+      return false; // the values are widened to double instead
+
+    begin_value ();
+    if (entry.mType == ContentType::Array)
+    {
+      if (entry.mLayout != ArrayLayout::Undecided)
+        throw ArchiveError () << "Raw arrays have to be written directly after `begin_entry`.";
+
+      write_marker (static_cast<char> (detail::ArrayMarker::Raw));
+      write_layout (layout);
+      write_size<uint64_t> (count);
+      entry.mLayout = ArrayLayout::Sized;
+    }
+    else
+      write_layout (layout);
+
+    write_bytes (data, static_cast<std::size_t> (layout.size) * count);
+    return true;
+  }
+
+  template <class STREAM>
+  bool BinaryWriter<STREAM>::write_cached (const char* name, ContentType type, Hint, CacheKey const& key)
+  {
+    // Values inside of columnar arrays have to pass through `begin_value`.
+    auto const& cache = mOptions.encodingCache;
+    if (!cache || mCapture || buffering ())
+      return false;
+
+    // Every option which changes the bytes of the entry is part of the key. Tagged and deduplicating
+    // writers buffer their output and never get here.
+    auto formatKey = key;
+    formatKey.mFormat = 1 + static_cast<uint32_t> (mOptions.integerEncoding) * 2 + (detail::swapsBytes (mOptions) ? 1 : 0);
+    formatKey.mColumnarLimit = mOptions.columnarLimit;
+
+    if (auto const* const bytes = cache->find (formatKey))
+    {
+      // The hint only matters while the content is written, which is already done.
+      begin_entry (name, type, Hint::None);
+      write_bytes (bytes->data (), bytes->size ());
+      mEntries.top ().mComplete = true;
+      end_entry (name, type);
+      return true;
+    }
+
+    mPendingCacheKey = formatKey;
+    return false;
   }
 
   template <class STREAM>
@@ -118,4 +486,404 @@ namespace moose
   {
     return *mOut;
   }
+
+  template <class STREAM>
+  bool BinaryWriter<STREAM>::in_columnar_element () const
+  {
+    return mCapture && mEntries.size () > mCapture->mDepth;
+  }
+
+  template <class STREAM>
+  bool BinaryWriter<STREAM>::deduplicating () const
+  {
+    return mOptions.dedupThreshold > 0;
+  }
+
+  template <class STREAM>
+  bool BinaryWriter<STREAM>::tagged () const
+  {
+    return mOptions.tagged;
+  }
+
+  template <class STREAM>
+  bool BinaryWriter<STREAM>::buffering () const
+  {
+    return deduplicating () || tagged ();
+  }
+
+  template <class STREAM>
+  auto BinaryWriter<STREAM>::position () const -> std::size_t
+  {
+    return mFlushedBytes + mBuffer.size ();
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::add_to_index (const char* name, ContentType type)
+  {
+    mIndex.stride = mOptions.indexStride;
+    mIndex.entries.push_back ({name, type, position ()});
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::add_element_to_index (Entry const& parent)
+  {
+    auto& entry = mIndex.entries.back ();
+    entry.sized = parent.mLayout == ArrayLayout::Sized;
+    if (mOptions.indexStride > 0 && entry.elementCount % mOptions.indexStride == 0)
+      entry.elementOffsets.push_back (position ());
+    ++entry.elementCount;
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::begin_frame (ContentType parentType, const char* name, ContentType type)
+  {
+    if (parentType == ContentType::Struct)
+    {
+      auto const id = detail::fieldId (name);
+      uint8_t const bytes [] = {static_cast<uint8_t> (id), static_cast<uint8_t> (id >> 8),
+                                static_cast<uint8_t> (id >> 16), static_cast<uint8_t> (id >> 24)};
+      mBuffer.insert (mBuffer.end (), bytes, bytes + 4);
+    }
+    else if (type != ContentType::Struct)
+      return; // elements of arrays are read in order and do not need their length
+
+    // Most entries are short. Longer lengths are inserted once the entry is done.
+    mEntries.top ().mLengthPosition = mBuffer.size ();
+    mBuffer.push_back (0);
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::end_frame (std::size_t lengthPosition)
+  {
+    uint8_t length [detail::maxVarintSize];
+    auto const size = detail::encodeVarint (mBuffer.size () - lengthPosition - 1, length);
+    auto const position = mBuffer.begin () + static_cast<std::ptrdiff_t> (lengthPosition);
+    mBuffer.insert (position + 1, size - 1, 0);
+    std::copy (length, length + size, mBuffer.begin () + static_cast<std::ptrdiff_t> (lengthPosition));
+
+    // Indexed elements behind the length moved as well.
+    if (mOptions.index && size > 1 && !mIndex.entries.empty ())
+    {
+      auto& offsets = mIndex.entries.back ().elementOffsets;
+      for (auto offset = offsets.rbegin (); offset != offsets.rend () && *offset > mFlushedBytes + lengthPosition; ++offset)
+        *offset += size - 1;
+    }
+  }
+
+  template <class STREAM>
+  bool BinaryWriter<STREAM>::deduplicate (Entry const& entry, ContentType type, detail::SubtreeHash const& hash)
+  {
+    auto const key = hash.key (type);
+    auto& parent = mEntries.top ();
+    parent.mHash.add (key);
+    if (type == ContentType::Value || key.mSize < mOptions.dedupThreshold)
+      return false;
+
+    // The hash only selects candidates. References are emitted for equal encodings, which decode equally.
+    // Repetitions already store the children of the subtree as references, so encodings are compared
+    // with references in place of the children which are stored inline.
+    canonical_encoding (entry);
+    auto& occurrences = mSubtrees [key];
+    auto const match = std::ranges::find (occurrences, mCanonical, &Occurrence::mBytes);
+    if (match == occurrences.end ())
+    {
+      auto const offset = mFlushedBytes + entry.mBegin;
+      occurrences.push_back ({offset, mCanonical});
+      parent.mInlineChildren.push_back ({entry.mBegin, mBuffer.size (), offset, type});
+      return false;
+    }
+
+    mBuffer.resize (entry.mBegin);
+    detail::encodeReference (type, match->mOffset, mBuffer);
+    return true;
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::canonical_encoding (Entry const& entry)
+  {
+    mCanonical.clear ();
+    auto begin = mBuffer.begin () + static_cast<std::ptrdiff_t> (entry.mBegin);
+    for (auto const& child : entry.mInlineChildren)
+    {
+      mCanonical.insert (mCanonical.end (), begin, mBuffer.begin () + static_cast<std::ptrdiff_t> (child.mBegin));
+      detail::encodeReference (child.mType, child.mOffset, mCanonical);
+      begin = mBuffer.begin () + static_cast<std::ptrdiff_t> (child.mEnd);
+    }
+    mCanonical.insert (mCanonical.end (), begin, mBuffer.end ());
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::flush_buffer ()
+  {
+    out ().write (reinterpret_cast<char const*> (mBuffer.data ()), static_cast<std::streamsize> (mBuffer.size ()));
+    mFlushedBytes += mBuffer.size ();
+    mBuffer.clear ();
+    mEntries.top ().mInlineChildren.clear ();
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::add_column_token (detail::ColumnToken token)
+  {
+    auto& capture = *mCapture;
+    if (capture.mElementCount == 1)
+      capture.mShape.push_back (token);
+    else
+    {
+      if (capture.mShapePosition >= capture.mShape.size () || capture.mShape [capture.mShapePosition] != token)
+        capture.mColumnar = false;
+      ++capture.mShapePosition;
+    }
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::begin_value ()
+  {
+    if (!in_columnar_element ())
+      return;
+
+    mCapture->mValueOffsets.push_back (mCapture->mBytes.size ());
+    add_column_token (detail::ColumnToken::Value);
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write_columns ()
+  {
+    auto capture = std::move (*mCapture);
+    mCapture.reset ();
+
+    auto const count = capture.mElementCount;
+    if (!capture.mColumnar || count == 0)
+    {
+      // The array was already removed from the entry stack.
+      write_rows (capture, count, mEntries.size () == 1);
+      return;
+    }
+
+    // All elements share the same shape and thus the same number of values.
+    auto const valuesPerElement = capture.mValueOffsets.size () / count;
+    capture.mValueOffsets.push_back (capture.mBytes.size ());
+    auto const& offsets = capture.mValueOffsets;
+
+    write_marker (static_cast<char> (detail::ArrayMarker::Columnar));
+    write_size<uint64_t> (count);
+    write_size<uint64_t> (capture.mShape.size ());
+    write_bytes (capture.mShape.data (), capture.mShape.size ());
+    write_size<uint64_t> (valuesPerElement);
+
+    for (std::size_t column = 0; column < valuesPerElement; ++column)
+    {
+      std::size_t columnSize = 0;
+      for (auto i = column; i < offsets.size () - 1; i += valuesPerElement)
+        columnSize += offsets [i + 1] - offsets [i];
+
+      write_size<uint64_t> (columnSize);
+      for (auto i = column; i < offsets.size () - 1; i += valuesPerElement)
+        write_bytes (capture.mBytes.data () + offsets [i], offsets [i + 1] - offsets [i]);
+    }
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write_captured_rows ()
+  {
+    auto const capture = std::move (*mCapture);
+    mCapture.reset ();
+
+    // The remaining elements are written directly, like those of arrays without hint.
+    mEntries.top ().mColumnar = false;
+    write_rows (capture, *capture.mSize, mEntries.size () == 2);
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write_rows (Capture const& capture, std::size_t count, bool topLevel)
+  {
+    write_marker (static_cast<char> (detail::ArrayMarker::Sized));
+    write_size<uint64_t> (count);
+
+    if (mOptions.index && topLevel)
+    {
+      auto& entry = mIndex.entries.back ();
+      entry.sized = true;
+      entry.elementCount = capture.mElementCount;
+      for (auto const begin : capture.mElementBegins)
+        entry.elementOffsets.push_back (position () + begin);
+    }
+    write_bytes (capture.mBytes.data (), capture.mBytes.size ());
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write_bytes (void const* data, std::size_t size)
+  {
+    if (mCapture)
+    {
+      auto const* const bytes = static_cast<uint8_t const*> (data);
+      mCapture->mBytes.insert (mCapture->mBytes.end (), bytes, bytes + size);
+    }
+    else if (buffering ())
+    {
+      auto const* const bytes = static_cast<uint8_t const*> (data);
+      if (deduplicating ())
+        mEntries.top ().mHash.update (bytes, size);
+      mBuffer.insert (mBuffer.end (), bytes, bytes + size);
+    }
+    else
+    {
+      out ().write (static_cast<char const*> (data), static_cast<std::streamsize> (size));
+      mFlushedBytes += size;
+      if (mActiveRecordings > 0)
+      {
+        auto const* const bytes = static_cast<uint8_t const*> (data);
+        mRecording.insert (mRecording.end (), bytes, bytes + size);
+      }
+    }
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write_marker (char marker)
+  {
+    write_bytes (&marker, 1);
+  }
+
+  template <class STREAM>
+  void BinaryWriter<STREAM>::write_layout (RawLayout const& layout)
+  {
+    // Layouts are always stored as varints, since they usually consist of small numbers.
+    uint8_t buffer [3 * detail::maxVarintSize];
+    auto size = detail::encodeVarint (layout.size, buffer);
+    size += detail::encodeVarint (layout.alignment, buffer + size);
+    size += detail::encodeVarint (layout.fieldCount, buffer + size);
+    write_bytes (buffer, size);
+  }
+
+  template <class STREAM>
+  template <class FIXED>
+  void BinaryWriter<STREAM>::write_size (std::size_t size)
+  {
+    if (mOptions.integerEncoding == IntegerEncoding::Varint)
+    {
+      uint8_t buffer [detail::maxVarintSize];
+      write_bytes (buffer, detail::encodeVarint (size, buffer));
+    }
+    else
+    {
+      auto fixedSize = static_cast<FIXED> (size);
+      if (detail::swapsBytes (mOptions))
+        fixedSize = detail::byteSwap (fixedSize);
+      write_bytes (&fixedSize, sizeof (FIXED));
+    }
+  }
+
+  template <class STREAM>
+  template <class T>
+  void BinaryWriter<STREAM>::write_number (T value)
+  {
+    if constexpr (!std::is_same_v<T, double>)
+    {
+      if (mOptions.integerEncoding == IntegerEncoding::Legacy)
+        return write_number (static_cast<double> (value));
+    }
+
+    if constexpr (detail::isVarintEncoded<T> ())
+    {
+      if (mOptions.integerEncoding == IntegerEncoding::Varint)
+      {
+        uint8_t buffer [detail::maxVarintSize];
+        write_bytes (buffer, detail::encodeVarint (detail::toVarint (value), buffer));
+        return;
+      }
+    }
+
+    auto stored = static_cast<detail::BinaryStorageType<T>> (value);
+    if (detail::swapsBytes (mOptions))
+      stored = detail::byteSwap (stored);
+    write_bytes (&stored, sizeof (stored));
+  }
+
+  template <class STREAM>
+  template <class T>
+  void BinaryWriter<STREAM>::write_numbers (std::span<T const> values)
+  {
+    auto& entry = mEntries.top ();
+    if (entry.mType != ContentType::Array || entry.mLayout != ArrayLayout::Undecided)
+      throw ArchiveError () << "Arrays of numbers have to be written directly after `begin_entry`.";
+    entry.mLayout = ArrayLayout::Sized;
+    begin_value ();
+
+    if (entry.mColumnar)
+    {
+      // Numbers are already stored contiguously.
+      entry.mColumnar = false;
+      mCapture.reset ();
+    }
+
+    // Legacy data only consists of the markers which readers of earlier versions know.
+    if (auto const codec = detail::codecMarker<T> (entry.mHint);
+        codec && mOptions.integerEncoding != IntegerEncoding::Legacy && detail::canEncode (*codec, values))
+    {
+      mScratch.clear ();
+      detail::encodeWithCodec (*codec, values, mScratch);
+      write_marker (static_cast<char> (*codec));
+      write_size<uint64_t> (values.size ());
+      write_size<uint64_t> (mScratch.size ());
+      write_bytes (mScratch.data (), mScratch.size ());
+      return;
+    }
+
+    if constexpr (detail::isVarintEncoded<T> ())
+    {
+      if (mOptions.integerEncoding == IntegerEncoding::Varint)
+      {
+        // The block size allows readers to fetch and decode all values at once.
+        std::size_t blockSize = 0;
+        for (auto const value : values)
+          blockSize += detail::varintSize (detail::toVarint (value));
+
+        write_marker (static_cast<char> (detail::ArrayMarker::PackedVarints));
+        write_size<uint64_t> (values.size ());
+        write_size<uint64_t> (blockSize);
+
+        constexpr std::size_t chunkSize = 1024;
+        mScratch.resize (chunkSize * detail::maxVarintSize);
+        for (std::size_t chunkBegin = 0; chunkBegin < values.size (); chunkBegin += chunkSize)
+        {
+          auto const chunkEnd = std::min (values.size (), chunkBegin + chunkSize);
+          std::size_t bytes = 0;
+          for (auto i = chunkBegin; i < chunkEnd; ++i)
+            bytes += detail::encodeVarint (detail::toVarint (values [i]), mScratch.data () + bytes);
+          write_bytes (mScratch.data (), bytes);
+        }
+        return;
+      }
+    }
+
+    if (mOptions.integerEncoding == IntegerEncoding::Legacy)
+    {
+      // The end marker is written here as well, since the layout is already decided.
+      for (auto const value : values)
+      {
+        write_marker (static_cast<char> (detail::ArrayMarker::Element));
+        write_number (value);
+      }
+      write_marker (static_cast<char> (detail::ArrayMarker::End));
+      return;
+    }
+
+    write_marker (static_cast<char> (detail::ArrayMarker::Sized));
+    write_size<uint64_t> (values.size ());
+
+    if constexpr (detail::hasBinaryLayout<T> ())
+    {
+      if (!detail::swapsBytes (mOptions))
+        return write_bytes (values.data (), values.size_bytes ());
+
+      mScratch.resize (values.size_bytes ());
+      std::memcpy (mScratch.data (), values.data (), values.size_bytes ());
+      detail::byteSwapArray<sizeof (T)> (mScratch.data (), values.size ());
+      write_bytes (mScratch.data (), mScratch.size ());
+    }
+    else
+    {
+      for (auto const value : values)
+        write_number (value);
+    }
+  }
 }// end of namespace moose
@@ -0,0 +1,66 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <cstddef>
+#include <ios>
+#include <vector>
+
+namespace moose
+{
+  /** A contiguous sink for `BinaryWriter`, which appends all written bytes to a `std::vector<std::byte>`.
+    Reserve capacity or pass a cleared vector of a previous call to avoid reallocations.*/
+  class ByteBuffer
+  {
+  public:
+    explicit ByteBuffer (std::size_t capacity = 0)
+    {
+      mBytes.reserve (capacity);
+    }
+
+    /// Appends to the given bytes.
+    explicit ByteBuffer (std::vector<std::byte> bytes)
+      : mBytes {std::move (bytes)}
+    {}
+
+    void write (const char* data, std::streamsize count)
+    {
+      auto const* const bytes = reinterpret_cast<std::byte const*> (data);
+      mBytes.insert (mBytes.end (), bytes, bytes + count);
+    }
+
+    auto bytes () const -> std::vector<std::byte> const& {return mBytes;}
+
+    /// Moves the bytes out of the buffer, which is empty afterwards.
+    auto take () -> std::vector<std::byte>
+    {
+      auto bytes = std::move (mBytes);
+      mBytes.clear ();
+      return bytes;
+    }
+
+  private:
+    std::vector<std::byte> mBytes;
+  };
+}// end of namespace moose
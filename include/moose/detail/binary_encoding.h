@@ -0,0 +1,220 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <moose/binary_options.h>
+#include <moose/content_type.h>
+#include <moose/exceptions.h>
+#include <moose/detail/varint.h>
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace moose::detail
+{
+  /// Markers which precede the elements of an array in the binary format.
+  enum class ArrayMarker : char
+  {
+    End = 0,           ///< No further elements follow.
+    Element = 1,       ///< A single element follows, which is again followed by a marker.
+    Sized = 2,         ///< The number of elements follows, then all elements without further markers.
+    PackedVarints = 3, ///< The number of elements and the size of the block in bytes follow, then all elements as varints.
+    Raw = 4,           ///< A `RawLayout` and the number of elements follow, then all elements as raw bytes.
+    Columnar = 5,      ///< The number of elements, the shape of an element and one column per value of an element follow.
+    Delta = 6,         ///< The number of elements and the size of the block in bytes follow, then the delta encoded block.
+    XorFloat = 7,      ///< The number of elements and the size of the block in bytes follow, then the XOR encoded block.
+    RunLength = 8,     ///< The number of elements and the size of the block in bytes follow, then the run-length encoded block.
+    Reference = 9,     ///< Offset of an identical array, which was stored before, follows as varint. See `BinaryOptions::dedupThreshold`.
+    Float32 = 10,      ///< The number of elements and the size of the block in bytes follow, then all elements as little endian floats.
+    Float16 = 11,      ///< The number of elements and the size of the block in bytes follow, then all elements as little endian half floats.
+    Quantized16 = 12   ///< The number of elements and the size of the block in bytes follow, then the quantized block.
+  };
+
+  /// Precedes each struct in the binary format, if `BinaryOptions::dedupThreshold` is set.
+  enum class SubtreeTag : char
+  {
+    Inline = 0,   ///< The content of the struct follows.
+    Reference = 1 ///< Offset of an identical struct, which was stored before, follows as varint.
+  };
+
+  /// Appends a reference to the struct or array at `offset` to `out`.
+  inline void encodeReference (ContentType type, std::size_t offset, std::vector<uint8_t>& out)
+  {
+    out.push_back (type == ContentType::Struct ? static_cast<uint8_t> (SubtreeTag::Reference)
+                                               : static_cast<uint8_t> (ArrayMarker::Reference));
+    uint8_t bytes [maxVarintSize];
+    out.insert (out.end (), bytes, bytes + encodeVarint (offset, bytes));
+  }
+
+  /// The id of a member of a struct in the tagged binary format. The FNV-1a hash of its name.
+  inline auto fieldId (const char* name) -> uint32_t
+  {
+    uint32_t hash = 2166136261u;
+    for (; *name != 0; ++name)
+      hash = (hash ^ static_cast<uint8_t> (*name)) * 16777619u;
+    return hash;
+  }
+
+  inline void checkBinaryOptions (BinaryOptions const& options)
+  {
+    if (options.tagged && options.dedupThreshold > 0)
+      throw ArchiveError {} << "Tagged binary data can not be deduplicated.";
+    if (options.byteOrder != std::endian::native && !options.header)
+      throw ArchiveError {} << "Binary data in non-native byte order requires a header.";
+  }
+
+  /// Returns `true` if fixed width numbers are stored in the other than the native byte order.
+  inline bool swapsBytes (BinaryOptions const& options)
+  {
+    return options.byteOrder != std::endian::native;
+  }
+
+  /** The header of binary data, see `BinaryOptions::header`: The magic number, the version of the format,
+    the byte order (0 for little, 1 for big endian) and the `HeaderFlag`s as 16 bit little endian value.
+    If `HeaderFlag::Schema` is set, the schema fingerprint follows as 64 bit little endian value.*/
+  constexpr char headerMagic [4] = {'M', 'O', 'O', 'B'};
+  constexpr uint8_t formatVersion = 1;
+  constexpr std::size_t headerSize = 8;
+
+  enum class HeaderFlag : uint16_t
+  {
+    Varint = 1,
+    Deduplicated = 2,
+    Tagged = 4,
+    Indexed = 8,
+    Schema = 16,
+    LegacyNumbers = 32
+  };
+
+  constexpr std::size_t schemaSize = 8;
+
+  inline auto encodeHeader (BinaryOptions const& options) -> std::vector<uint8_t>
+  {
+    uint16_t flags = 0;
+    auto const set = [&flags] (bool enabled, HeaderFlag flag)
+    {
+      if (enabled)
+        flags |= static_cast<uint16_t> (flag);
+    };
+    set (options.integerEncoding == IntegerEncoding::Varint, HeaderFlag::Varint);
+    set (options.integerEncoding == IntegerEncoding::Legacy, HeaderFlag::LegacyNumbers);
+    set (options.dedupThreshold > 0, HeaderFlag::Deduplicated);
+    set (options.tagged, HeaderFlag::Tagged);
+    set (options.index, HeaderFlag::Indexed);
+    set (options.schema != 0, HeaderFlag::Schema);
+
+    std::vector<uint8_t> header {
+      static_cast<uint8_t> (headerMagic [0]), static_cast<uint8_t> (headerMagic [1]),
+      static_cast<uint8_t> (headerMagic [2]), static_cast<uint8_t> (headerMagic [3]), formatVersion,
+      static_cast<uint8_t> (options.byteOrder == std::endian::big ? 1 : 0),
+      static_cast<uint8_t> (flags), static_cast<uint8_t> (flags >> 8)};
+    if (options.schema != 0)
+    {
+      for (std::size_t i = 0; i < schemaSize; ++i)
+        header.push_back (static_cast<uint8_t> (options.schema >> (8 * i)));
+    }
+    return header;
+  }
+
+  /** Validates the fixed part of the header and takes the options which it stores.
+    Returns `true` if the schema fingerprint follows, which `decodeSchema` decodes.*/
+  inline bool decodeHeader (std::array<uint8_t, headerSize> const& header, BinaryOptions& options)
+  {
+    for (std::size_t i = 0; i < sizeof (headerMagic); ++i)
+    {
+      if (header [i] != static_cast<uint8_t> (headerMagic [i]))
+        throw ArchiveError {} << "Invalid binary data: The header is missing.";
+    }
+    if (header [4] == 0 || header [4] > formatVersion)
+      throw ArchiveError {} << "Unsupported version " << static_cast<int> (header [4]) << " of the binary format.";
+    if (header [5] > 1)
+      throw ArchiveError {} << "Invalid byte order in the header of binary data.";
+
+    auto const flags = static_cast<uint16_t> (header [6] | (header [7] << 8));
+    if ((flags & ~0x3Fu) != 0)
+      throw ArchiveError {} << "Unsupported features in the header of binary data.";
+
+    auto const has = [flags] (HeaderFlag flag) {return (flags & static_cast<uint16_t> (flag)) != 0;};
+    options.integerEncoding = has (HeaderFlag::Varint)        ? IntegerEncoding::Varint
+                            : has (HeaderFlag::LegacyNumbers) ? IntegerEncoding::Legacy
+                                                              : IntegerEncoding::Fixed;
+    options.dedupThreshold = has (HeaderFlag::Deduplicated) ? 1 : 0;
+    options.tagged = has (HeaderFlag::Tagged);
+    options.index = has (HeaderFlag::Indexed);
+    options.byteOrder = header [5] == 1 ? std::endian::big : std::endian::little;
+    return has (HeaderFlag::Schema);
+  }
+
+  inline auto decodeSchema (std::array<uint8_t, schemaSize> const& bytes) -> uint64_t
+  {
+    uint64_t schema = 0;
+    for (std::size_t i = 0; i < schemaSize; ++i)
+      schema |= static_cast<uint64_t> (bytes [i]) << (8 * i);
+    return schema;
+  }
+
+  /** Tokens describing the shape of the elements of a columnar array.
+    All elements of a columnar array share the same sequence of tokens. Each `Value` token
+    corresponds to one column, which holds the encoded values of all elements.*/
+  enum class ColumnToken : uint8_t
+  {
+    End = 0,         ///< End of an entry.
+    BeginArray = 1,  ///< Begin of an array entry. Only arrays which are written as a single value may be part of a column.
+    BeginStruct = 2, ///< Begin of a struct entry.
+    BeginValue = 3,  ///< Begin of a value entry.
+    Value = 4        ///< A single value, e.g. a number, a string, or a whole array of numbers.
+  };
+
+  /** The type through which a number is stored in the binary format, if `IntegerEncoding::Fixed` is used.
+    The width does not depend on the platform, i.e., `long` is always stored with 64 bits.*/
+  template <class T> struct BinaryStorage {using type = T;};
+  template <> struct BinaryStorage <int> {using type = int32_t;};
+  template <> struct BinaryStorage <unsigned int> {using type = uint32_t;};
+  template <> struct BinaryStorage <long int> {using type = int64_t;};
+  template <> struct BinaryStorage <unsigned long int> {using type = uint64_t;};
+  template <> struct BinaryStorage <long long int> {using type = int64_t;};
+  template <> struct BinaryStorage <unsigned long long int> {using type = uint64_t;};
+  template <> struct BinaryStorage <float> {using type = double;};
+
+  template <class T>
+  using BinaryStorageType = typename BinaryStorage<T>::type;
+
+  /// Returns `true` if values of type `T` are stored as varints if `IntegerEncoding::Varint` is used.
+  template <class T>
+  constexpr bool isVarintEncoded ()
+  {
+    return std::is_integral_v<T> && sizeof (T) > 1 && !std::is_same_v<T, bool>;
+  }
+
+  /// Returns `true` if an array of `T` has the same memory layout as its fixed width binary representation.
+  template <class T>
+  constexpr bool hasBinaryLayout ()
+  {
+    using Storage = BinaryStorageType<T>;
+    return sizeof (Storage) == sizeof (T) && std::is_floating_point_v<Storage> == std::is_floating_point_v<T>;
+  }
+}// end of namespace moose::detail
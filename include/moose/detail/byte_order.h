@@ -0,0 +1,99 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace moose::detail
+{
+  /** Reverses the bytes of each `SIZE` byte lane of `word`. Only uses shifts and masks, so that loops over
+    many words are vectorized by the compiler.*/
+  template <std::size_t SIZE>
+  constexpr auto byteSwapLanes (uint64_t word) -> uint64_t
+  {
+    static_assert (SIZE == 2 || SIZE == 4 || SIZE == 8);
+    word = ((word & 0x00FF00FF00FF00FFull) << 8) | ((word >> 8) & 0x00FF00FF00FF00FFull);
+    if constexpr (SIZE >= 4)
+      word = ((word & 0x0000FFFF0000FFFFull) << 16) | ((word >> 16) & 0x0000FFFF0000FFFFull);
+    if constexpr (SIZE == 8)
+      word = (word << 32) | (word >> 32);
+    return word;
+  }
+
+  /// Reverses the bytes of an arithmetic value.
+  template <class T>
+  constexpr auto byteSwap (T value) -> T
+  {
+    if constexpr (sizeof (T) == 1)
+      return value;
+    else
+    {
+      using Bits = std::conditional_t<sizeof (T) == 2, uint16_t, std::conditional_t<sizeof (T) == 4, uint32_t, uint64_t>>;
+      auto const bits = static_cast<uint64_t> (std::bit_cast<Bits> (value));
+      return std::bit_cast<T> (static_cast<Bits> (byteSwapLanes<sizeof (T)> (bits)));
+    }
+  }
+
+  /// Reverses the bytes of each of the `count` values of `SIZE` bytes at `data`.
+  template <std::size_t SIZE>
+  void byteSwapArray (void* data, std::size_t count)
+  {
+    if constexpr (SIZE > 1)
+    {
+      auto* const bytes = static_cast<uint8_t*> (data);
+      auto const size = count * SIZE;
+      std::size_t i = 0;
+      for (; i + 8 <= size; i += 8)
+      {
+        uint64_t word;
+        std::memcpy (&word, bytes + i, 8);
+        word = byteSwapLanes<SIZE> (word);
+        std::memcpy (bytes + i, &word, 8);
+      }
+
+      // at most three values of two or four bytes remain
+      for (; i < size; i += SIZE)
+      {
+        uint64_t word = 0;
+        std::memcpy (&word, bytes + i, SIZE);
+        word = byteSwapLanes<SIZE> (word);
+        std::memcpy (bytes + i, &word, SIZE);
+      }
+    }
+  }
+
+  /// Converts between the native byte order and little endian.
+  template <class T>
+  constexpr auto littleEndian (T value) -> T
+  {
+    if constexpr (std::endian::native == std::endian::big)
+      return byteSwap (value);
+    else
+      return value;
+  }
+}// end of namespace moose::detail
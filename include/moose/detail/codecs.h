@@ -0,0 +1,643 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <moose/hint.h>
+#include <moose/detail/binary_encoding.h>
+#include <moose/detail/byte_order.h>
+#include <moose/detail/varint.h>
+
+/** Codecs for arrays of numbers in the binary format.
+
+  Internally, each value is handled as a 64 bit pattern: integers as (sign extended) 64 bit
+  integers and floating point values as the bits of a `double`. The decoders convert the
+  patterns to the requested type with `fromCodecBits`, or keep them if `CodecBits` are requested.*/
+namespace moose::detail
+{
+  /// Returns the marker of the codec which is selected by `hint` for arrays of `T`, if any.
+  template <class T>
+  constexpr auto codecMarker (Hint hint) -> std::optional<ArrayMarker>
+  {
+    if constexpr (std::is_integral_v<T>)
+    {
+      if (hint == Hint::Delta)
+        return ArrayMarker::Delta;
+    }
+    if constexpr (std::is_floating_point_v<T>)
+    {
+      switch (hint)
+      {
+        case Hint::XorFloat:    return ArrayMarker::XorFloat;
+        case Hint::Float32:     return ArrayMarker::Float32;
+        case Hint::Float16:     return ArrayMarker::Float16;
+        case Hint::Quantized16: return ArrayMarker::Quantized16;
+        default:                break;
+      }
+    }
+    if (hint == Hint::RunLength)
+      return ArrayMarker::RunLength;
+    return std::nullopt;
+  }
+
+  template <class T>
+  auto toCodecBits (T value) -> uint64_t
+  {
+    if constexpr (std::is_floating_point_v<T>)
+      return std::bit_cast<uint64_t> (static_cast<double> (value));
+    else if constexpr (std::is_signed_v<T>)
+      return static_cast<uint64_t> (static_cast<int64_t> (value));
+    else
+      return static_cast<uint64_t> (value);
+  }
+
+  /// The unconverted 64 bit pattern of a value, for decoding values before their type is known.
+  struct CodecBits
+  {
+    uint64_t mBits;
+  };
+
+  template <class T>
+  auto fromCodecBits (uint64_t bits, bool floatingPoint) -> T
+  {
+    if constexpr (std::is_same_v<T, CodecBits>)
+      return {bits};
+    else if (floatingPoint)
+      return static_cast<T> (std::bit_cast<double> (bits));
+    else if constexpr (std::is_signed_v<T> || std::is_floating_point_v<T>)
+      return static_cast<T> (static_cast<int64_t> (bits));
+    else
+      return static_cast<T> (bits);
+  }
+
+  /// Writes values with an arbitrary number of bits, most significant bit first.
+  class BitWriter
+  {
+  public:
+    explicit BitWriter (std::vector<uint8_t>& out) : mOut {out} {}
+
+    /// Writes the lowest `count` bits of `value`, where `count <= 64`.
+    void write (uint64_t value, unsigned count)
+    {
+      while (count > 0)
+      {
+        auto const take = std::min (count, 8u - mUsed);
+        count -= take;
+        auto const bits = static_cast<unsigned> (value >> count) & ((1u << take) - 1);
+        mCurrent = static_cast<uint8_t> (mCurrent | (bits << (8u - mUsed - take)));
+        mUsed += take;
+        if (mUsed == 8)
+        {
+          mOut.push_back (mCurrent);
+          mCurrent = 0;
+          mUsed = 0;
+        }
+      }
+    }
+
+    /// Writes the last, partially filled byte.
+    void flush ()
+    {
+      if (mUsed > 0)
+        mOut.push_back (mCurrent);
+      mCurrent = 0;
+      mUsed = 0;
+    }
+
+  private:
+    std::vector<uint8_t>& mOut;
+    uint8_t mCurrent {0};
+    unsigned mUsed {0};
+  };
+
+  class BitReader
+  {
+  public:
+    BitReader (uint8_t const* in, uint8_t const* end) : mIn {in}, mEnd {end} {}
+
+    /// Reads `count <= 64` bits. Returns `false` if the input is exhausted.
+    bool read (unsigned count, uint64_t& value)
+    {
+      value = 0;
+      while (count > 0)
+      {
+        if (mIn == mEnd)
+          return false;
+
+        auto const take = std::min (count, 8u - mUsed);
+        auto const bits = static_cast<unsigned> (*mIn >> (8u - mUsed - take)) & ((1u << take) - 1);
+        value = (value << take) | bits;
+        count -= take;
+        mUsed += take;
+        if (mUsed == 8)
+        {
+          ++mIn;
+          mUsed = 0;
+        }
+      }
+      return true;
+    }
+
+    /// Returns the position behind the last byte which was (partially) read.
+    auto end () const -> uint8_t const*
+    {
+      return mUsed > 0 ? mIn + 1 : mIn;
+    }
+
+  private:
+    uint8_t const* mIn;
+    uint8_t const* mEnd;
+    unsigned mUsed {0};
+  };
+
+  /** Delta encoding for integers: The differences of consecutive values are stored as zig-zag encoded varints.
+    Sorted or slowly growing sequences like indices and time stamps thus mostly take one byte per value.*/
+  template <class T>
+  void encodeDelta (std::span<T const> values, std::vector<uint8_t>& out)
+  {
+    auto offset = out.size ();
+    out.resize (offset + values.size () * maxVarintSize);
+
+    uint64_t previous = 0;
+    for (auto const value : values)
+    {
+      auto const bits = toCodecBits (value);
+      offset += encodeVarint (zigZagEncode (static_cast<int64_t> (bits - previous)), out.data () + offset);
+      previous = bits;
+    }
+    out.resize (offset);
+  }
+
+  template <class T>
+  bool decodeDelta (uint8_t const* in, uint8_t const* end, std::span<T> out)
+  {
+    // The deltas are decoded in chunks on the stack, which keeps the bulk decoding of varints.
+    int64_t deltas [256];
+    uint64_t sum = 0;
+    for (std::size_t i = 0; i < out.size (); i += std::size (deltas))
+    {
+      auto const count = std::min (out.size () - i, std::size (deltas));
+      in = decodeVarints (in, end, deltas, count);
+      if (in == nullptr)
+        return false;
+
+      for (std::size_t j = 0; j < count; ++j)
+      {
+        sum += static_cast<uint64_t> (deltas [j]);
+        out [i + j] = fromCodecBits<T> (sum, false);
+      }
+    }
+    return in == end;
+  }
+
+  /** Gorilla style XOR encoding for floating point values: Each value is XORed with its predecessor and
+    only the bits between the leading and trailing zeros of the result are stored. Slowly varying
+    signals share sign, exponent and leading mantissa bits with their predecessors and thus compress well.*/
+  template <class T>
+  void encodeXor (std::span<T const> values, std::vector<uint8_t>& out)
+  {
+    if (values.empty ())
+      return;
+
+    BitWriter writer {out};
+    auto previous = toCodecBits (values [0]);
+    writer.write (previous, 64);
+
+    unsigned previousLeading = 64;
+    unsigned previousTrailing = 0;
+    for (auto const value : values.subspan (1))
+    {
+      auto const bits = toCodecBits (value);
+      auto const x = bits ^ previous;
+      previous = bits;
+
+      if (x == 0)
+      {
+        writer.write (0, 1);
+        continue;
+      }
+
+      auto const leading = std::min (static_cast<unsigned> (std::countl_zero (x)), 31u);
+      auto const trailing = static_cast<unsigned> (std::countr_zero (x));
+      if (previousLeading < 64 && leading >= previousLeading && trailing >= previousTrailing)
+      {
+        // the meaningful bits fit into the window of the previous value
+        writer.write (0b10, 2);
+        writer.write (x >> previousTrailing, 64 - previousLeading - previousTrailing);
+      }
+      else
+      {
+        auto const meaningful = 64 - leading - trailing;
+        writer.write (0b11, 2);
+        writer.write (leading, 5);
+        writer.write (meaningful - 1, 6);
+        writer.write (x >> trailing, meaningful);
+        previousLeading = leading;
+        previousTrailing = trailing;
+      }
+    }
+    writer.flush ();
+  }
+
+  template <class T>
+  bool decodeXor (uint8_t const* in, uint8_t const* end, std::span<T> out)
+  {
+    if (out.empty ())
+      return in == end;
+
+    BitReader reader {in, end};
+    uint64_t previous;
+    if (!reader.read (64, previous))
+      return false;
+    out [0] = fromCodecBits<T> (previous, true);
+
+    unsigned leading = 64;
+    unsigned trailing = 0;
+    for (auto& value : out.subspan (1))
+    {
+      uint64_t control;
+      if (!reader.read (1, control))
+        return false;
+
+      if (control != 0)
+      {
+        if (!reader.read (1, control))
+          return false;
+
+        if (control != 0)
+        {
+          uint64_t storedLeading, storedMeaningful;
+          if (!reader.read (5, storedLeading) || !reader.read (6, storedMeaningful))
+            return false;
+
+          leading = static_cast<unsigned> (storedLeading);
+          auto const meaningful = static_cast<unsigned> (storedMeaningful) + 1;
+          if (leading + meaningful > 64)
+            return false;
+          trailing = 64 - leading - meaningful;
+        }
+        else if (leading == 64)
+          return false;
+
+        uint64_t x;
+        if (!reader.read (64 - leading - trailing, x))
+          return false;
+        previous ^= x << trailing;
+      }
+      value = fromCodecBits<T> (previous, true);
+    }
+    return reader.end () == end;
+  }
+
+  /** Run-length encoding: Each run of equal values is stored as its length followed by the value.
+    The first byte tells whether the values are integers (stored as zig-zag encoded varints)
+    or floating point values (stored as the 8 bytes of a little endian `double`).*/
+  template <class T>
+  void encodeRunLength (std::span<T const> values, std::vector<uint8_t>& out)
+  {
+    constexpr bool floatingPoint = std::is_floating_point_v<T>;
+    out.push_back (floatingPoint ? 1 : 0);
+
+    uint8_t buffer [2 * maxVarintSize];
+    for (std::size_t i = 0; i < values.size ();)
+    {
+      auto const bits = toCodecBits (values [i]);
+      auto runEnd = i + 1;
+      while (runEnd < values.size () && toCodecBits (values [runEnd]) == bits)
+        ++runEnd;
+
+      auto size = encodeVarint (runEnd - i, buffer);
+      if constexpr (floatingPoint)
+      {
+        auto const stored = littleEndian (bits);
+        std::memcpy (buffer + size, &stored, sizeof (stored));
+        size += sizeof (bits);
+      }
+      else
+        size += encodeVarint (zigZagEncode (static_cast<int64_t> (bits)), buffer + size);
+
+      out.insert (out.end (), buffer, buffer + size);
+      i = runEnd;
+    }
+  }
+
+  template <class T>
+  bool decodeRunLength (uint8_t const* in, uint8_t const* end, std::span<T> out, bool& floatingPoint)
+  {
+    if (in == end)
+      return false;
+    floatingPoint = *in++ != 0;
+
+    std::size_t i = 0;
+    while (i < out.size ())
+    {
+      uint64_t runLength;
+      in = decodeVarint (in, end, runLength);
+      if (in == nullptr || runLength == 0 || runLength > out.size () - i)
+        return false;
+
+      uint64_t bits;
+      if (floatingPoint)
+      {
+        if (end - in < static_cast<std::ptrdiff_t> (sizeof (bits)))
+          return false;
+        std::memcpy (&bits, in, sizeof (bits));
+        bits = littleEndian (bits);
+        in += sizeof (bits);
+      }
+      else
+      {
+        in = decodeVarint (in, end, bits);
+        if (in == nullptr)
+          return false;
+        bits = static_cast<uint64_t> (zigZagDecode (bits));
+      }
+
+      std::fill_n (out.begin () + static_cast<std::ptrdiff_t> (i), runLength, fromCodecBits<T> (bits, floatingPoint));
+      i += runLength;
+    }
+    return in == end;
+  }
+
+  /** Converts to the nearest half precision value, rounding ties to even.
+    Values beyond the range of half precision become infinite.*/
+  inline auto toHalf (float value) -> uint16_t
+  {
+    auto bits = std::bit_cast<uint32_t> (value);
+    auto const sign = static_cast<uint16_t> ((bits >> 16) & 0x8000);
+    bits &= 0x7FFFFFFF;
+
+    if (bits >= 0x7F800000) // infinity or NaN
+      return static_cast<uint16_t> (sign | 0x7C00 | (bits > 0x7F800000 ? 0x200 : 0));
+    if (bits >= 0x477FF000) // rounds to infinity
+      return static_cast<uint16_t> (sign | 0x7C00);
+    if (bits < 0x38800000) // subnormal, in multiples of 2^-24
+      return static_cast<uint16_t> (sign | static_cast<uint16_t> (std::nearbyint (std::bit_cast<float> (bits) * 0x1p24f)));
+
+    // Rebiases the exponent from 127 to 15 and rounds the dropped 13 bits of the mantissa to nearest even.
+    bits += 0xC8000FFF + ((bits >> 13) & 1);
+    return static_cast<uint16_t> (sign | (bits >> 13));
+  }
+
+  inline auto fromHalf (uint16_t half) -> float
+  {
+    auto const sign = static_cast<uint32_t> (half & 0x8000) << 16;
+    auto const exponent = (half >> 10) & 0x1F;
+    auto const mantissa = static_cast<uint32_t> (half & 0x3FF);
+
+    if (exponent == 0)
+      return std::bit_cast<float> (sign | std::bit_cast<uint32_t> (static_cast<float> (mantissa) * 0x1p-24f));
+    if (exponent == 0x1F)
+      return std::bit_cast<float> (sign | 0x7F800000 | (mantissa << 13));
+    return std::bit_cast<float> (sign | (static_cast<uint32_t> (exponent + 112) << 23) | (mantissa << 13));
+  }
+
+  /// Stores each value as little endian `float`, or as half float if `half` is set.
+  template <class T>
+  void encodeReduced (std::span<T const> values, std::vector<uint8_t>& out, bool half)
+  {
+    auto const offset = out.size ();
+    if (half)
+    {
+      out.resize (offset + values.size () * sizeof (uint16_t));
+      for (std::size_t i = 0; i < values.size (); ++i)
+      {
+        auto const bits = littleEndian (toHalf (static_cast<float> (values [i])));
+        std::memcpy (out.data () + offset + i * sizeof (bits), &bits, sizeof (bits));
+      }
+    }
+    else
+    {
+      out.resize (offset + values.size () * sizeof (float));
+      for (std::size_t i = 0; i < values.size (); ++i)
+      {
+        auto const bits = littleEndian (std::bit_cast<uint32_t> (static_cast<float> (values [i])));
+        std::memcpy (out.data () + offset + i * sizeof (bits), &bits, sizeof (bits));
+      }
+    }
+  }
+
+  template <class T>
+  bool decodeReduced (uint8_t const* in, uint8_t const* end, std::span<T> out, bool half)
+  {
+    auto const valueSize = half ? sizeof (uint16_t) : sizeof (float);
+    if (static_cast<std::size_t> (end - in) != out.size () * valueSize)
+      return false;
+
+    if (half)
+    {
+      for (std::size_t i = 0; i < out.size (); ++i)
+      {
+        uint16_t bits;
+        std::memcpy (&bits, in + i * sizeof (bits), sizeof (bits));
+        out [i] = fromCodecBits<T> (std::bit_cast<uint64_t> (static_cast<double> (fromHalf (littleEndian (bits)))), true);
+      }
+    }
+    else
+    {
+      for (std::size_t i = 0; i < out.size (); ++i)
+      {
+        uint32_t bits;
+        std::memcpy (&bits, in + i * sizeof (bits), sizeof (bits));
+        out [i] = fromCodecBits<T> (std::bit_cast<uint64_t> (static_cast<double> (std::bit_cast<float> (littleEndian (bits)))), true);
+      }
+    }
+    return true;
+  }
+
+  /** Quantization to 16 bit fixed point numbers: The minimum and the maximum of the values are stored as
+    little endian `double`s, followed by each value as the nearest of 65536 equidistant steps between them.
+    Only finite values can be quantized, see `canEncode`.*/
+  template <class T>
+  void encodeQuantized (std::span<T const> values, std::vector<uint8_t>& out)
+  {
+    double min = 0;
+    double max = 0;
+    if (!values.empty ())
+    {
+      auto const [minIt, maxIt] = std::minmax_element (values.begin (), values.end ());
+      min = static_cast<double> (*minIt);
+      max = static_cast<double> (*maxIt);
+    }
+
+    auto const offset = out.size ();
+    out.resize (offset + 2 * sizeof (double) + values.size () * sizeof (uint16_t));
+    auto* const data = out.data () + offset;
+    auto const storedMin = littleEndian (std::bit_cast<uint64_t> (min));
+    auto const storedMax = littleEndian (std::bit_cast<uint64_t> (max));
+    std::memcpy (data, &storedMin, sizeof (double));
+    std::memcpy (data + sizeof (double), &storedMax, sizeof (double));
+
+    // Values are not below `min`, so adding 0.5 before the truncation rounds to the nearest step.
+    auto const scale = max > min ? 65535.0 / (max - min) : 0.0;
+    auto* const steps = data + 2 * sizeof (double);
+    for (std::size_t i = 0; i < values.size (); ++i)
+    {
+      auto const step = littleEndian (static_cast<uint16_t> ((static_cast<double> (values [i]) - min) * scale + 0.5));
+      std::memcpy (steps + i * sizeof (step), &step, sizeof (step));
+    }
+  }
+
+  template <class T>
+  bool decodeQuantized (uint8_t const* in, uint8_t const* end, std::span<T> out)
+  {
+    if (static_cast<std::size_t> (end - in) != 2 * sizeof (double) + out.size () * sizeof (uint16_t))
+      return false;
+
+    uint64_t storedMin, storedMax;
+    std::memcpy (&storedMin, in, sizeof (double));
+    std::memcpy (&storedMax, in + sizeof (double), sizeof (double));
+    auto const min = std::bit_cast<double> (littleEndian (storedMin));
+    auto const max = std::bit_cast<double> (littleEndian (storedMax));
+    auto const stepSize = (max - min) / 65535.0;
+
+    auto const* const steps = in + 2 * sizeof (double);
+    for (std::size_t i = 0; i < out.size (); ++i)
+    {
+      uint16_t step;
+      std::memcpy (&step, steps + i * sizeof (step), sizeof (step));
+      out [i] = fromCodecBits<T> (std::bit_cast<uint64_t> (min + littleEndian (step) * stepSize), true);
+    }
+    return true;
+  }
+
+  /** Returns `false` if the codec `marker` can not encode `values`. The array is then stored without codec.
+    `ArrayMarker::Float32` and `ArrayMarker::Float16` require finite values to be within the reduced range,
+    since they would become infinite otherwise. `ArrayMarker::Quantized16` requires finite values with a finite range.*/
+  template <class T>
+  bool canEncode (ArrayMarker marker, std::span<T const> values)
+  {
+    if (values.empty ())
+      return true;
+
+    if (marker == ArrayMarker::Float32 || marker == ArrayMarker::Float16)
+    {
+      auto const limit = marker == ArrayMarker::Float16 ? 65504.0 : static_cast<double> (std::numeric_limits<float>::max ());
+      return std::all_of (values.begin (), values.end (),
+                          [limit] (T value) {return !std::isfinite (value) || std::abs (static_cast<double> (value)) <= limit;});
+    }
+
+    if (marker != ArrayMarker::Quantized16)
+      return true;
+    if (!std::all_of (values.begin (), values.end (), [] (T value) {return std::isfinite (value);}))
+      return false;
+    auto const [minIt, maxIt] = std::minmax_element (values.begin (), values.end ());
+    return std::isfinite (static_cast<double> (*maxIt) - static_cast<double> (*minIt));
+  }
+
+  /// Appends `values` encoded by the codec `marker` to `out`.
+  template <class T>
+  void encodeWithCodec (ArrayMarker marker, std::span<T const> values, std::vector<uint8_t>& out)
+  {
+    if (marker == ArrayMarker::Delta)
+      encodeDelta (values, out);
+    else if (marker == ArrayMarker::XorFloat)
+      encodeXor (values, out);
+    else if (marker == ArrayMarker::Float32 || marker == ArrayMarker::Float16)
+      encodeReduced (values, out, marker == ArrayMarker::Float16);
+    else if (marker == ArrayMarker::Quantized16)
+      encodeQuantized (values, out);
+    else
+      encodeRunLength (values, out);
+  }
+
+  /** Returns `false` if the block `[in, end)`, which was encoded by the codec `marker`, can not contain `size`
+    values. Checks the size of the block, or counts the values of run-length encoded blocks, without
+    decoding them. Callers can thus allocate `size` values before decoding the block.*/
+  inline bool codecBlockFits (ArrayMarker marker, uint8_t const* in, uint8_t const* end, uint64_t size)
+  {
+    auto const blockSize = static_cast<uint64_t> (end - in);
+    switch (marker)
+    {
+      case ArrayMarker::Delta:
+        return size <= blockSize; // each delta takes at least one byte
+      case ArrayMarker::XorFloat:
+        return size == 0 ? blockSize == 0 : blockSize >= 8 && size - 1 <= (blockSize - 8) * 8; // at least one bit per value
+      case ArrayMarker::Float32:
+        return blockSize % sizeof (float) == 0 && size == blockSize / sizeof (float);
+      case ArrayMarker::Float16:
+        return blockSize % sizeof (uint16_t) == 0 && size == blockSize / sizeof (uint16_t);
+      case ArrayMarker::Quantized16:
+        return blockSize >= 2 * sizeof (double) && (blockSize - 2 * sizeof (double)) % sizeof (uint16_t) == 0
+            && size == (blockSize - 2 * sizeof (double)) / sizeof (uint16_t);
+      default:
+        break;
+    }
+
+    // Run-length encoded blocks are counted run by run.
+    if (in == end)
+      return false;
+    bool const floatingPoint = *in++ != 0;
+    uint64_t count = 0;
+    while (in != end)
+    {
+      uint64_t runLength, bits;
+      in = decodeVarint (in, end, runLength);
+      if (in == nullptr || runLength > size - count)
+        return false;
+      count += runLength;
+
+      if (floatingPoint)
+      {
+        if (end - in < static_cast<std::ptrdiff_t> (sizeof (bits)))
+          return false;
+        in += sizeof (bits);
+      }
+      else if ((in = decodeVarint (in, end, bits)) == nullptr)
+        return false;
+    }
+    return count == size;
+  }
+
+  /** Decodes the block `[in, end)`, which was encoded by the codec `marker`, into `out`.
+    Returns `false` if the block is malformed or does not contain exactly `out.size ()` values.*/
+  template <class T>
+  bool decodeWithCodec (ArrayMarker marker, uint8_t const* in, uint8_t const* end, std::span<T> out, bool& floatingPoint)
+  {
+    floatingPoint = marker != ArrayMarker::Delta && marker != ArrayMarker::RunLength;
+    if (marker == ArrayMarker::Delta)
+      return decodeDelta (in, end, out);
+    else if (marker == ArrayMarker::XorFloat)
+      return decodeXor (in, end, out);
+    else if (marker == ArrayMarker::Float32 || marker == ArrayMarker::Float16)
+      return decodeReduced (in, end, out, marker == ArrayMarker::Float16);
+    else if (marker == ArrayMarker::Quantized16)
+      return decodeQuantized (in, end, out);
+    else
+      return decodeRunLength (in, end, out, floatingPoint);
+  }
+}// end of namespace moose::detail
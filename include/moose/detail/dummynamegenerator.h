@@ -1,6 +1,8 @@
 #pragma once
 
-#include <string>
+#include <array>
+#include <charconv>
+#include <cstring>
 
 namespace moose::detail
 {
@@ -8,13 +10,25 @@ namespace moose::detail
   class DummyNameGenerator
   {
   public:
-    inline auto getNext () -> std::string
+    DummyNameGenerator ()
     {
-      return mPrefix + std::to_string (mNumber++);
+      std::memcpy (mBuffer.data (), mPrefix, sizeof (mPrefix) - 1);
+    }
+
+    /** Returns the next name. The returned string is owned by the generator and stays valid
+      until the next call. No memory is allocated.*/
+    inline auto getNext () -> const char*
+    {
+      auto* const digits = mBuffer.data () + sizeof (mPrefix) - 1;
+      auto const result = std::to_chars (digits, mBuffer.data () + mBuffer.size () - 1, mNumber++);
+      *result.ptr = 0;
+      return mBuffer.data ();
     }
 
   private:
-    inline static const std::string mPrefix {"@noname"};
+    static constexpr char mPrefix [] = "@noname";
+    // The prefix followed by up to 20 digits and the terminating zero.
+    std::array<char, sizeof (mPrefix) + 20> mBuffer;
     size_t mNumber {0};
   };
 }
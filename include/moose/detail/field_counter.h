@@ -0,0 +1,55 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <moose/writer.h>
+
+namespace moose::detail
+{
+  /// Counts the direct child entries which are written by a `Serialize` method.
+  class FieldCounter : public Writer
+  {
+  public:
+    auto count () const -> uint32_t {return mCount;}
+
+    bool begin_entry (const char*, ContentType, Hint) override
+    {
+      if (mDepth++ == 0)
+        ++mCount;
+      return true;
+    }
+
+    void end_entry (const char*, ContentType) override {--mDepth;}
+
+    void write_type_name (std::string const&) override {}
+    void write_type_version (Version const&) override {}
+    void write (const char*, bool) override {}
+    void write (const char*, double) override {}
+    void write (const char*, std::string const&) override {}
+
+  private:
+    uint32_t mCount {0};
+    uint32_t mDepth {0};
+  };
+}// end of namespace moose::detail
@@ -0,0 +1,106 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <moose/format.h>
+#include <moose/type_traits.h>
+
+#include <utility>
+
+namespace moose::detail
+{
+  /** Refers to an instance whose traits specify `EntryType::PerFormat`.
+    The archive serializes the wrapper instead of the instance, so that the traits of `FORMAT` are used.*/
+  template <class T, Format FORMAT>
+  struct InFormat
+  {
+    using Traits = typename TypeTraits<T>::template Traits<FORMAT>;
+    T& value;
+  };
+
+  template <class T, Format FORMAT, EntryType entryType = InFormat<T, FORMAT>::Traits::entryType>
+  struct InFormatTraits;
+
+  template <class T, Format FORMAT>
+  struct InFormatTraits<T, FORMAT, EntryType::Range>
+  {
+    using Traits = typename InFormat<T, FORMAT>::Traits;
+    static constexpr EntryType entryType = EntryType::Range;
+
+    static auto toRange (InFormat<T, FORMAT>& from)
+    { return Traits::toRange (from.value); }
+  };
+
+  template <class T, Format FORMAT>
+  struct InFormatTraits<T, FORMAT, EntryType::Vector>
+  {
+    using Traits = typename InFormat<T, FORMAT>::Traits;
+    using ValueType = typename Traits::ValueType;
+    static constexpr EntryType entryType = EntryType::Vector;
+
+    static auto toRange (InFormat<T, FORMAT>& from)
+    { return Traits::toRange (from.value); }
+
+    static void pushBack (InFormat<T, FORMAT>& to, ValueType value)
+    { Traits::pushBack (to.value, std::move (value)); }
+
+    static void clear (InFormat<T, FORMAT>& to)
+    { Traits::clear (to.value); }
+  };
+
+  template <class T, Format FORMAT>
+  struct InFormatTraits<T, FORMAT, EntryType::ForwardValue>
+  {
+    using Traits = typename InFormat<T, FORMAT>::Traits;
+    using ForwardedType = typename Traits::ForwardedType;
+    static constexpr EntryType entryType = EntryType::ForwardValue;
+
+    static auto getForwardedValue (InFormat<T, FORMAT> const& from) -> ForwardedType
+    { return Traits::getForwardedValue (from.value); }
+
+    static void setForwardedValue (InFormat<T, FORMAT>& to, ForwardedType&& value)
+    { Traits::setForwardedValue (to.value, std::move (value)); }
+  };
+
+  template <class T, Format FORMAT>
+  struct InFormatTraits<T, FORMAT, EntryType::ForwardReference>
+  {
+    using Traits = typename InFormat<T, FORMAT>::Traits;
+    using ForwardedType = typename Traits::ForwardedType;
+    static constexpr EntryType entryType = EntryType::ForwardReference;
+
+    static auto getForwardedValue (InFormat<T, FORMAT> const& from) -> decltype (auto)
+    { return Traits::getForwardedValue (from.value); }
+
+    static void setForwardedValue (InFormat<T, FORMAT>& to, ForwardedType&& value)
+    { Traits::setForwardedValue (to.value, std::move (value)); }
+  };
+}// end of namespace moose::detail
+
+namespace moose
+{
+  template <class T, Format FORMAT>
+  struct TypeTraits <detail::InFormat<T, FORMAT>> : detail::InFormatTraits<T, FORMAT> {};
+}// end of namespace moose
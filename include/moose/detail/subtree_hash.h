@@ -0,0 +1,108 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <moose/content_type.h>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace moose::detail
+{
+  /// Identifies the content of a subtree. Subtrees with equal keys are compared byte by byte before being shared.
+  struct SubtreeKey
+  {
+    uint64_t mLow {0};
+    uint64_t mHigh {0};
+    std::size_t mSize {0};
+    ContentType mType {ContentType::Struct};
+
+    bool operator == (SubtreeKey const&) const = default;
+  };
+
+  struct SubtreeKeyHash
+  {
+    auto operator () (SubtreeKey const& key) const -> std::size_t
+    { return static_cast<std::size_t> (key.mLow); }
+  };
+
+  /** Computes a 128 bit hash of the encoding of a subtree.
+    Children are added through their keys, so that a subtree has the same key no matter
+    whether its children were stored inline or as references.*/
+  class SubtreeHash
+  {
+  public:
+    void update (void const* data, std::size_t size)
+    {
+      auto const* bytes = static_cast<uint8_t const*> (data);
+      mSize += size;
+      for (; size >= 8; size -= 8, bytes += 8)
+      {
+        uint64_t word;
+        std::memcpy (&word, bytes, 8);
+        mix (word);
+      }
+      if (size > 0)
+      {
+        uint64_t word = 0;
+        std::memcpy (&word, bytes, size);
+        mix (word ^ (static_cast<uint64_t> (size) << 56));
+      }
+    }
+
+    void add (SubtreeKey const& child)
+    {
+      mSize += child.mSize;
+      mix (child.mLow);
+      mix (child.mHigh ^ static_cast<uint64_t> (child.mType));
+    }
+
+    auto key (ContentType type) const -> SubtreeKey
+    {
+      return {finalize (mLow ^ mSize), finalize (mHigh + mSize), mSize, type};
+    }
+
+  private:
+    void mix (uint64_t word)
+    {
+      mLow = (mLow ^ word) * 0x100000001b3ull;
+      mLow ^= mLow >> 29;
+      mHigh = std::rotl (mHigh + word * 0x9e3779b97f4a7c15ull, 31) * 0xc2b2ae3d27d4eb4full;
+    }
+
+    static auto finalize (uint64_t h) -> uint64_t
+    {
+      h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+      h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+      return h ^ (h >> 31);
+    }
+
+    uint64_t mLow {0xcbf29ce484222325ull};
+    uint64_t mHigh {0x84222325cbf29ce4ull};
+    std::size_t mSize {0};
+  };
+}// end of namespace moose::detail
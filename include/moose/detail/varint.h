@@ -0,0 +1,136 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace moose::detail
+{
+  /// Maximum number of bytes of a LEB128 encoded 64 bit value.
+  constexpr size_t maxVarintSize = 10;
+
+  inline auto zigZagEncode (int64_t value) -> uint64_t
+  {
+    return (static_cast<uint64_t> (value) << 1) ^ static_cast<uint64_t> (value >> 63);
+  }
+
+  inline auto zigZagDecode (uint64_t value) -> int64_t
+  {
+    return static_cast<int64_t> (value >> 1) ^ -static_cast<int64_t> (value & 1);
+  }
+
+  /// Converts an integer to the unsigned value which is stored as varint. Signed values are zig-zag encoded.
+  template <class T>
+  auto toVarint (T value) -> uint64_t
+  {
+    if constexpr (std::is_signed_v<T>)
+      return zigZagEncode (static_cast<int64_t> (value));
+    else
+      return static_cast<uint64_t> (value);
+  }
+
+  template <class T>
+  auto fromVarint (uint64_t value) -> T
+  {
+    if constexpr (std::is_signed_v<T>)
+      return static_cast<T> (zigZagDecode (value));
+    else
+      return static_cast<T> (value);
+  }
+
+  /// Returns the number of bytes of the LEB128 encoding of `value`.
+  inline auto varintSize (uint64_t value) -> size_t
+  {
+    return static_cast<size_t> (64 - std::countl_zero (value | 1) + 6) / 7;
+  }
+
+  /** Writes `value` LEB128 encoded to `out`, which has to provide space for at least `maxVarintSize` bytes.
+    Returns the number of written bytes.*/
+  inline auto encodeVarint (uint64_t value, uint8_t* out) -> size_t
+  {
+    size_t size = 0;
+    while (value >= 0x80)
+    {
+      out [size++] = static_cast<uint8_t> (value | 0x80);
+      value >>= 7;
+    }
+    out [size++] = static_cast<uint8_t> (value);
+    return size;
+  }
+
+  /** Decodes a single LEB128 encoded value from the range `[in, end)`.
+    Returns the position behind the decoded value or `nullptr` if the input is truncated or malformed.*/
+  inline auto decodeVarint (uint8_t const* in, uint8_t const* end, uint64_t& value) -> uint8_t const*
+  {
+    value = 0;
+    for (unsigned shift = 0; shift < 64 && in != end; shift += 7)
+    {
+      auto const byte = *in++;
+      value |= static_cast<uint64_t> (byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+        return in;
+    }
+    return nullptr;
+  }
+
+  /** Decodes `count` LEB128 encoded values from the range `[in, end)` into `out`.
+    Signed target types are zig-zag decoded. Small values dominate typical data, so the input is
+    inspected eight bytes at a time and runs of single byte varints are decoded without branching
+    on individual bytes, which allows the compiler to vectorize the inner loop.
+    Returns the position behind the last decoded value or `nullptr` if the input is truncated or malformed.*/
+  template <class T>
+  auto decodeVarints (uint8_t const* in, uint8_t const* end, T* out, size_t count) -> uint8_t const*
+  {
+    constexpr uint64_t continuationBits = 0x8080808080808080ull;
+
+    size_t i = 0;
+    while (i < count)
+    {
+      if (count - i >= 8 && end - in >= 8)
+      {
+        uint64_t word;
+        std::memcpy (&word, in, 8);
+        if ((word & continuationBits) == 0)
+        {
+          for (size_t j = 0; j < 8; ++j)
+            out [i + j] = fromVarint<T> (in [j]);
+          in += 8;
+          i += 8;
+          continue;
+        }
+      }
+
+      uint64_t value;
+      in = decodeVarint (in, end, value);
+      if (in == nullptr)
+        return nullptr;
+      out [i++] = fromVarint<T> (value);
+    }
+    return in;
+  }
+}// end of namespace moose::detail
@@ -0,0 +1,111 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <moose/export.h>
+#include <moose/hint.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <span>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace moose
+{
+  /** Identifies the encoding of an object in an `EncodingCache`.
+    Objects are identified by their address and type. Since an object at the same address
+    may change or be replaced, a user supplied generation counter is part of the key.
+    See `TypeTraits` on how to opt in to caching.*/
+  struct CacheKey
+  {
+    void const* mAddress;
+    std::type_index mType;
+    uint64_t mGeneration {0};
+    Hint mHint {Hint::None};
+    /// Set by the writer to distinguish the encodings of different formats and options.
+    uint32_t mFormat {0};
+    /// Set by the writer, since the limit decides whether nested arrays are stored column by column.
+    std::size_t mColumnarLimit {0};
+
+    bool operator == (CacheKey const&) const = default;
+  };
+
+  /** Stores the encodings of objects, so that writers can splice them into their output
+    instead of serializing the objects again. A cache may be shared by several consecutive writers,
+    e.g. through `BinaryOptions::encodingCache`. If the total size of all encodings exceeds the size
+    limit, the least recently used encodings are evicted.
+    \note Caches are not thread safe.*/
+  class EncodingCache
+  {
+  public:
+    struct Statistics
+    {
+      std::size_t hits {0};
+      std::size_t misses {0};
+      std::size_t evictions {0};
+    };
+
+  public:
+    MOOSE_EXPORT explicit EncodingCache (std::size_t maxBytes = 64 * 1024 * 1024);
+
+    /// Returns the encoding stored for `key` or `nullptr`. Updates the hit and miss counters.
+    MOOSE_EXPORT auto find (CacheKey const& key) -> std::vector<uint8_t> const*;
+
+    /// Stores a copy of `bytes` for `key`. Encodings larger than the size limit are not stored.
+    MOOSE_EXPORT void insert (CacheKey const& key, std::span<uint8_t const> bytes);
+
+    MOOSE_EXPORT void clear ();
+
+    MOOSE_EXPORT auto statistics () const -> Statistics const&;
+    MOOSE_EXPORT auto size () const -> std::size_t;
+    MOOSE_EXPORT auto size_in_bytes () const -> std::size_t;
+    MOOSE_EXPORT auto max_size_in_bytes () const -> std::size_t;
+
+  private:
+    struct KeyHash
+    {
+      auto operator () (CacheKey const& key) const -> std::size_t;
+    };
+
+    struct Item
+    {
+      CacheKey mKey;
+      std::vector<uint8_t> mBytes;
+    };
+
+    void evict_until (std::size_t maxBytes);
+
+  private:
+    std::size_t mMaxBytes;
+    std::size_t mBytes {0};
+    Statistics mStatistics;
+    /// Most recently used items first.
+    std::list<Item> mItems;
+    std::unordered_map<CacheKey, std::list<Item>::iterator, KeyHash> mIndex;
+  };
+}// end of namespace moose
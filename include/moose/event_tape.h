@@ -0,0 +1,147 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <moose/content_type.h>
+#include <moose/export.h>
+#include <moose/reader.h>
+#include <moose/writer.h>
+
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace moose
+{
+  /** An in-memory sequence of the entries and values which `Serialize` writes to an archive.
+    Each entry is stored as a `Begin` event, followed by the events of its children and an `End` event.
+    Values are stored as `Leaf` events. Tapes are used to compare serialized objects, e.g. to create patches.*/
+  class EventTape
+  {
+  public:
+    using Value = std::variant<bool, int64_t, uint64_t, double, std::string>;
+
+    enum class Kind : uint8_t
+    {
+      Begin,
+      End,
+      Leaf
+    };
+
+    struct Event
+    {
+      Kind mKind;
+      ContentType mType {ContentType::Value};
+      Value mValue {};
+      /// Index behind the last event of the entry or value which starts at this event.
+      std::size_t mEnd {0};
+    };
+
+  public:
+    MOOSE_EXPORT void begin (ContentType type);
+    MOOSE_EXPORT void end ();
+    MOOSE_EXPORT void leaf (Value value);
+
+    /// Appends copies of the events `[first, last)` of `other`, which have to form complete entries.
+    MOOSE_EXPORT void append (EventTape const& other, std::size_t first, std::size_t last);
+
+    MOOSE_EXPORT auto events () const -> std::vector<Event> const&;
+
+  private:
+    std::vector<Event> mEvents;
+    /// Indices of the `Begin` events of all entries which have not been ended yet.
+    std::vector<std::size_t> mOpen;
+  };
+
+  /// Records the entries and values of an archive to an `EventTape`.
+  class TapeWriter : public Writer
+  {
+  public:
+    MOOSE_EXPORT TapeWriter (EventTape& tape);
+
+    bool begin_entry (const char* name, ContentType type, Hint hint) override;
+    void end_entry (const char* name, ContentType type) override;
+
+    void write_type_name (std::string const& typeName) override;
+    void write_type_version (Version const& version) override;
+
+    void write (const char* name, bool value) override;
+    void write (const char* name, double value) override;
+    void write (const char* name, std::string const& value) override;
+    void write (const char* name, char value) override;
+    void write (const char* name, unsigned char value) override;
+    void write (const char* name, int value) override;
+    void write (const char* name, long int value) override;
+    void write (const char* name, long long int value) override;
+    void write (const char* name, unsigned int value) override;
+    void write (const char* name, unsigned long int value) override;
+    void write (const char* name, unsigned long long int value) override;
+    using Writer::write;
+
+  private:
+    EventTape* mTape;
+  };
+
+  /// Reads the entries and values of an archive from an `EventTape`.
+  class TapeReader : public Reader
+  {
+  public:
+    MOOSE_EXPORT TapeReader (EventTape const& tape);
+
+    bool begin_entry (const char* name, ContentType type) override;
+    void end_entry (const char* name, ContentType type) override;
+
+    bool array_has_next (const char* name) const override;
+    auto array_size (const char* name) const -> std::optional<std::size_t> override;
+
+    auto type_name () const -> std::string override;
+    auto type_version () const -> Version override;
+
+    void read (const char* name, bool& value) const override;
+    void read (const char* name, double& value) const override;
+    void read (const char* name, std::string& value) const override;
+    void read (const char* name, char& value) const override;
+    void read (const char* name, unsigned char& value) const override;
+    void read (const char* name, int& value) const override;
+    void read (const char* name, long int& value) const override;
+    void read (const char* name, long long int& value) const override;
+    void read (const char* name, unsigned int& value) const override;
+    void read (const char* name, unsigned long int& value) const override;
+    void read (const char* name, unsigned long long int& value) const override;
+    using Reader::read;
+
+  private:
+    auto next_leaf (const char* name) const -> EventTape::Value const&;
+
+    template <class T>
+    void read_number (const char* name, T& value) const;
+
+  private:
+    EventTape const* mTape;
+    mutable std::size_t mCursor {0};
+    std::vector<std::size_t> mOpen;
+  };
+}// end of namespace moose
@@ -26,24 +26,126 @@
 
 #include <moose/binary_reader.h>
 #include <moose/archive.h>
+#include <moose/result.h>
+#include <moose/schema.h>
 
+#include <cstddef>
+#include <exception>
+#include <span>
 #include <sstream>
+#include <vector>
 
 namespace moose
 {
   template <class T>
-  void fromBinary (T& out, std::shared_ptr<std::stringstream> binaryData)
+  void fromBinary (T& out, std::shared_ptr<std::stringstream> binaryData, BinaryOptions options = {})
   {
-    moose::Archive archive {std::make_shared<moose::BinaryReader> (binaryData)};
+    moose::Archive archive {std::make_shared<moose::BinaryReader> (binaryData, detail::withSchemaOf<T> (options))};
     archive ("", out);
   }
 
   template <class T>
-  T fromBinary (std::shared_ptr<std::stringstream> binaryData)
+  T fromBinary (std::shared_ptr<std::stringstream> binaryData, BinaryOptions options = {})
   {
     T out;
-    fromBinary (out, binaryData);
+    fromBinary (out, binaryData, options);
     return out;
   }
+
+  /// Reads directly from memory. The data is not copied.
+  template <class T>
+  void fromBinary (T& out, std::span<std::byte const> binaryData, BinaryOptions options = {})
+  {
+    moose::Archive archive {std::make_shared<moose::BinaryReader> (binaryData, detail::withSchemaOf<T> (options))};
+    archive ("", out);
+  }
+
+  template <class T>
+  T fromBinary (std::span<std::byte const> binaryData, BinaryOptions options = {})
+  {
+    T out;
+    fromBinary (out, binaryData, options);
+    return out;
+  }
+
+  namespace detail
+  {
+    template <class T, class DATA>
+    auto tryFromBinary (DATA const& binaryData, BinaryOptions options) -> Result<T>
+    {
+      try
+      {
+        T out;
+        moose::Archive archive {std::make_shared<moose::BinaryReader> (binaryData, detail::withSchemaOf<T> (options))};
+        archive.record_errors ();
+        archive ("", out);
+        if (!archive.error ().empty ())
+          return Result<T>::failure (archive.error ());
+        return out;
+      }
+      catch (std::exception const& e)
+      {
+        return Result<T>::failure (e.what ());
+      }
+    }
+  }
+
+  /** Reads an object like `fromBinary`, but returns errors instead of throwing them.
+    Missing entries are detected without exceptions. Other errors, e.g. for corrupt data, are caught and returned.*/
+  template <class T>
+  auto tryFromBinary (std::shared_ptr<std::stringstream> binaryData, BinaryOptions options = {}) -> Result<T>
+  {
+    return detail::tryFromBinary<T> (binaryData, options);
+  }
+
+  template <class T>
+  auto tryFromBinary (std::span<std::byte const> binaryData, BinaryOptions options = {}) -> Result<T>
+  {
+    return detail::tryFromBinary<T> (binaryData, options);
+  }
+
+  /** Reads the top-level entry with the given name from binary data which was written with `BinaryOptions::index`.
+    The entries in front of it are not decoded.*/
+  template <class T>
+  void fromBinaryEntry (T& out, std::shared_ptr<BinaryReader> reader, const char* name)
+  {
+    if (!reader->seek_entry (name))
+      throw ArchiveError () << "Entry '" << name << "' not found in index.";
+    moose::Archive archive {std::move (reader)};
+    archive (name, out);
+  }
+
+  template <class T>
+  T fromBinaryEntry (std::shared_ptr<BinaryReader> reader, const char* name)
+  {
+    T out;
+    fromBinaryEntry (out, std::move (reader), name);
+    return out;
+  }
+
+  /** Reads `count` elements of the top-level array with the given name, starting with element `first`.
+    Requires `BinaryOptions::indexStride`. At most `indexStride - 1` elements in front of `first` are decoded.
+    Disjoint ranges may be read in parallel, each through its own reader.*/
+  template <class T>
+  auto fromBinaryElements (std::shared_ptr<BinaryReader> reader, const char* name, std::size_t first, std::size_t count)
+    -> std::vector<T>
+  {
+    auto const skipped = reader->seek_element (name, first);
+    moose::Archive archive {reader};
+
+    std::vector<T> elements;
+    elements.reserve (count);
+    for (std::size_t i = 0; i < skipped + count; ++i)
+    {
+      if (!reader->array_has_next (name))
+        throw ArchiveError () << "Array '" << name << "' has less than " << first + count << " elements.";
+
+      T element {};
+      archive ("", element);
+      if (i >= skipped)
+        elements.push_back (std::move (element));
+    }
+    return elements;
+  }
 }
 
@@ -27,6 +27,9 @@
 
 #include <moose/json_reader.h>
 #include <moose/archive.h>
+#include <moose/result.h>
+
+#include <exception>
 
 namespace moose
 {
@@ -45,6 +48,27 @@ namespace moose
     return out;
   }
 
+  /** Reads an object like `fromJson`, but returns errors instead of throwing them.
+    Missing entries are detected without exceptions. Other errors, e.g. syntax errors, are caught and returned.*/
+  template <class T>
+  auto tryFromJson (const char* name, const char* jsonString) -> Result<T>
+  {
+    try
+    {
+      T out;
+      moose::Archive archive {moose::JSONReader::fromString (jsonString)};
+      archive.record_errors ();
+      archive (name, out);
+      if (!archive.error ().empty ())
+        return Result<T>::failure (archive.error ());
+      return out;
+    }
+    catch (std::exception const& e)
+    {
+      return Result<T>::failure (e.what ());
+    }
+  }
+
   template <class T>
   void fromJsonFile (T& out, const char* name, const char* fileName)
   {
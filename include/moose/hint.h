@@ -31,6 +31,25 @@ namespace moose
   {
     None,
     OneLine,
-    ChildrenOneLine
+    ChildrenOneLine,
+    /** Stores the elements of an array column by column, i.e., all values of the first
+      member of the elements, then all values of the second member, and so on.
+      Only affects formats which support it (e.g. the binary format, unless it uses
+      `IntegerEncoding::Legacy`). Arrays whose elements do not share the same structure
+      are stored element by element.*/
+    Columnar,
+    // The following hints select a codec for arrays of numbers which are written as a whole,
+    // e.g. `std::vector<int>`. They only affect the binary format, unless it uses `IntegerEncoding::Legacy`,
+    // and are ignored for types they do not apply to.
+    Delta,     ///< Stores differences of consecutive integers. Suited for sorted indices and time stamps.
+    XorFloat,  ///< Stores each floating point value XORed with its predecessor. Suited for slowly varying signals.
+    RunLength, ///< Stores runs of equal values as length and value.
+    // The following hints reduce the precision of floating point values. The binary format applies them
+    // to arrays of floating point numbers which are written as a whole, unless it uses `IntegerEncoding::Legacy`. JSON applies them to all
+    // floating point values of the entry and its children and writes integral values unchanged.
+    // Values beyond the reduced range are kept with full precision instead of becoming infinite.
+    Float32,   ///< Stores values with single precision. JSON writes the shortest representation of the single precision value.
+    Float16,   ///< Stores values with half precision, i.e., with 11 significant bits. JSON writes 5 significant digits.
+    Quantized16 ///< Stores values as 16 bit fixed point numbers between the minimum and maximum of the array. JSON writes 5 significant digits.
   };
 }
@@ -0,0 +1,48 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+namespace moose
+{
+  enum class UnnamedEntries
+  {
+    /** A struct whose first member is unnamed is stored as a JSON array. All of its members are then
+      identified by their position only, so members may only be added at the end.*/
+    Positional,
+    /// Unnamed members are stored with generated names `@noname0`, `@noname1`, ... This is the default.
+    Named
+  };
+
+  /** Options of the JSON format. The `JSONReader` reads both representations of unnamed entries,
+    so these only have to be specified for writing.*/
+  struct JSONOptions
+  {
+    UnnamedEntries unnamedEntries {UnnamedEntries::Named};
+
+    /** Number of significant digits of floating point values which have no precision hint,
+      see `Hint::Float32`, `Hint::Float16` and `Hint::Quantized16`.*/
+    int significantDigits {15};
+  };
+}// end of namespace moose
@@ -50,6 +50,8 @@ namespace moose
     void parse_stream (std::istream& in);
     void parse_string (const char* str);
 
+    auto format () const -> Format override;
+
     bool begin_entry (const char* name, ContentType type) override;
     void end_entry (const char* name, ContentType type) override;
 
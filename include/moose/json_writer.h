@@ -27,7 +27,9 @@
 
 #include <stack>
 #include <memory>
+#include <vector>
 #include <moose/export.h>
+#include <moose/json_options.h>
 #include <moose/writer.h>
 #include <moose/detail/dummynamegenerator.h>
 
@@ -37,10 +39,10 @@ namespace moose
 class JSONWriter : public Writer
 {
 public:
-  MOOSE_EXPORT static auto toFile (const char* filename) -> std::shared_ptr<JSONWriter>;
+  MOOSE_EXPORT static auto toFile (const char* filename, JSONOptions options = {}) -> std::shared_ptr<JSONWriter>;
 
-  MOOSE_EXPORT JSONWriter (const char* filename);
-  MOOSE_EXPORT JSONWriter (std::shared_ptr<std::ostream> out);
+  MOOSE_EXPORT JSONWriter (const char* filename, JSONOptions options = {});
+  MOOSE_EXPORT JSONWriter (std::shared_ptr<std::ostream> out, JSONOptions options = {});
   MOOSE_EXPORT JSONWriter (JSONWriter&& other);
   
   JSONWriter (JSONWriter const&) = delete;
@@ -50,6 +52,8 @@ public:
   JSONWriter& operator = (JSONWriter const&) = delete;
   MOOSE_EXPORT JSONWriter& operator = (JSONWriter&& other);
 
+  auto format () const -> Format override;
+
   bool begin_entry (const char* name, ContentType type, Hint hint) override;
   void end_entry (const char* name, ContentType type) override;
 
@@ -65,21 +69,33 @@ private:
   {
     Entry (ContentType type) : mContentType {type} {}
     ContentType mContentType;
+    /// Set for structs whose opening bracket was not written yet, since their representation is not decided.
+    bool mPending {false};
+    /// Set for structs which are stored as arrays, since their first member is unnamed.
+    bool mPositional {false};
     detail::DummyNameGenerator mDummyNameGenerator;
   };
 
 private:
+  /// Writes the opening bracket of the current struct, if it is still pending.
+  void open_struct (bool positional);
   void prepare_content ();
   void optional_endl ();
   Hint hint () const;
+  /// The precision hint of the current entry or of its closest parent with a precision hint.
+  Hint precision () const;
   auto out () -> std::ostream &;
 
 private:
   std::shared_ptr <std::ostream> m_out;
+  JSONOptions mOptions;
   size_t m_currentDepth {0};
   size_t m_lastWrittenDepth {0};
-  std::stack <Hint> m_hints;
-  std::stack<Entry> mEntryStack;
+  std::stack <Hint, std::vector <Hint>> m_hints;
+  std::stack <Hint, std::vector <Hint>> mPrecisions;
+  std::stack<Entry, std::vector<Entry>> mEntryStack;
+  /// Names of unnamed entries of the root object.
+  detail::DummyNameGenerator mRootDummyNameGenerator;
 };
 
 }// end of namespace moose
@@ -0,0 +1,221 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <moose/archive.h>
+#include <moose/binary_reader.h>
+#include <moose/exceptions.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace moose
+{
+  /** Read-only view of a map which is stored as top-level entry of indexed binary data, e.g. a `std::map<K, V>`
+    which was written with `BinaryOptions::index` and `BinaryOptions::indexStride`. The keys have to be sorted
+    by `COMPARE`, as in a `std::map`. Lookups binary search the keys through the positions of the elements in
+    the index and decode only the keys they compare and the values they return. With an `indexStride` of 1,
+    each compared key decodes a single element, larger strides decode up to `indexStride - 1` elements in front
+    of it. Readers from memory, see `BinaryReader (std::span<std::byte const>)`, decode memory mapped files
+    without copying them.
+
+    If `sampleStride` is nonzero, the key of every `sampleStride`-th element is read upfront. Lookups then
+    search those in memory and only decode the keys of one sample interval.
+
+    The view reads through the given reader, which may not be used concurrently.*/
+  template <class K, class V, class COMPARE = std::less<K>>
+  class MappedMap
+  {
+  public:
+    MappedMap (std::shared_ptr<BinaryReader> reader, std::string name, std::size_t sampleStride = 0)
+      : mReader {std::move (reader)}
+      , mName {std::move (name)}
+      , mSampleStride {sampleStride}
+    {
+      auto const* const entry = mReader->index ().find (mName.c_str ());
+      if (!entry || entry->type != ContentType::Array || entry->elementOffsets.empty ())
+        throw ArchiveError () << "Map '" << mName << "' not found in index or stored without positions of its elements.";
+      mSize = entry->elementCount;
+
+      for (std::size_t i = 0; mSampleStride > 0 && i < mSize; i += mSampleStride)
+        mSamples.push_back (key (i));
+    }
+
+    auto size () const -> std::size_t {return mSize;}
+    bool empty () const {return mSize == 0;}
+
+    /// Returns the key of the `i`-th element.
+    auto key (std::size_t i) const -> K
+    {
+      Archive archive {begin_element (i)};
+      K key {};
+      archive ("key", key);
+      return key;
+    }
+
+    /// Returns the value of the `i`-th element.
+    auto value (std::size_t i) const -> V
+    {
+      return element (i).second;
+    }
+
+    /// Returns the index of the first element whose key is not less than `key`, or `size ()` if there is none.
+    auto lower_bound (K const& key) const -> std::size_t
+    {
+      std::size_t first = 0;
+      std::size_t last = mSize;
+      if (!mSamples.empty ())
+      {
+        // the first sample is not less than `key` or `key` lies within the interval of the previous sample
+        auto const sample = static_cast<std::size_t> (
+          std::lower_bound (mSamples.begin (), mSamples.end (), key, mCompare) - mSamples.begin ());
+        if (sample > 0)
+          first = (sample - 1) * mSampleStride + 1;
+        last = std::min (mSize, sample * mSampleStride);
+      }
+
+      while (first < last)
+      {
+        auto const middle = first + (last - first) / 2;
+        if (mCompare (this->key (middle), key))
+          first = middle + 1;
+        else
+          last = middle;
+      }
+      return first;
+    }
+
+    /// Returns the value of `key`, or `std::nullopt` if the map does not contain `key`.
+    auto find (K const& key) const -> std::optional<V>
+    {
+      auto const i = lower_bound (key);
+      if (i == mSize)
+        return std::nullopt;
+
+      Archive archive {begin_element (i)};
+      K found {};
+      archive ("key", found);
+      if (mCompare (key, found))
+        return std::nullopt;
+
+      V value {};
+      archive ("value", value);
+      return value;
+    }
+
+    bool contains (K const& key) const
+    {
+      auto const i = lower_bound (key);
+      return i < mSize && !mCompare (key, this->key (i));
+    }
+
+    /// Returns the value of `key`. Throws an `ArchiveError` if the map does not contain `key`.
+    auto at (K const& key) const -> V
+    {
+      auto value = find (key);
+      if (!value)
+        throw ArchiveError () << "Key not found in map '" << mName << "'.";
+      return std::move (*value);
+    }
+
+    /** Calls `visit (key, value)` for all elements whose keys are in `[first, last)`, in the order of the keys.
+      The elements are decoded one after another, without further lookups.*/
+    template <class VISITOR>
+    void scan (K const& first, K const& last, VISITOR&& visit) const
+    {
+      auto i = lower_bound (first);
+      if (i == mSize)
+        return;
+
+      Archive archive {seek (i)};
+      for (; i < mSize; ++i)
+      {
+        begin_pair ();
+        std::pair<K, V> element;
+        archive ("key", element.first);
+        if (!mCompare (element.first, last))
+          return;
+        archive ("value", element.second);
+        mReader->end_entry ("", ContentType::Struct);
+        visit (std::as_const (element.first), std::as_const (element.second));
+      }
+    }
+
+  private:
+    /// Positions the reader inside of the `i`-th element, in front of its key.
+    auto begin_element (std::size_t i) const -> std::shared_ptr<BinaryReader> const&
+    {
+      if (i >= mSize)
+        throw ArchiveError () << "Map '" << mName << "' has no element " << i << ".";
+      seek (i);
+      begin_pair ();
+      return mReader;
+    }
+
+    /// Positions the reader in front of the `i`-th element, decoding the elements between it and the closest stored position.
+    auto seek (std::size_t i) const -> std::shared_ptr<BinaryReader> const&
+    {
+      auto const skipped = mReader->seek_element (mName.c_str (), i);
+      Archive archive {mReader};
+      for (std::size_t j = 0; j < skipped; ++j)
+      {
+        if (!mReader->array_has_next (mName.c_str ()))
+          throw ArchiveError () << "Map '" << mName << "' has less elements than stored in its index.";
+        std::pair<K, V> element;
+        archive ("", element);
+      }
+      return mReader;
+    }
+
+    void begin_pair () const
+    {
+      if (!mReader->array_has_next (mName.c_str ()) || !mReader->begin_entry ("", ContentType::Struct))
+        throw ArchiveError () << "Map '" << mName << "' has less elements than stored in its index.";
+    }
+
+    auto element (std::size_t i) const -> std::pair<K, V>
+    {
+      Archive archive {begin_element (i)};
+      std::pair<K, V> element;
+      archive ("key", element.first);
+      archive ("value", element.second);
+      return element;
+    }
+
+  private:
+    std::shared_ptr<BinaryReader> mReader;
+    std::string mName;
+    std::size_t mSize {0};
+    std::size_t mSampleStride {0};
+    /// Keys of every `mSampleStride`-th element.
+    std::vector<K> mSamples;
+    COMPARE mCompare {};
+  };
+}// end of namespace moose
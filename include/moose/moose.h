@@ -33,5 +33,6 @@
 #include <moose/json_writer.h>
 #include <moose/serialize.h>
 #include <moose/stl_serialization.h>
+#include <moose/streaming.h>
 #include <moose/to_json.h>
 #include <moose/types.h>
@@ -0,0 +1,115 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <moose/exceptions.h>
+#include <moose/type_traits.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace moose
+{
+  /** A sequence of bools which is packed into 64 bit words. Bit `i` is stored in bit `i % 64` of `words [i / 64]`.
+    Unused bits of the last word are zero. Containers of bools, e.g. `std::vector<bool>` and `std::bitset`,
+    forward to `PackedBits`. The binary format stores 8 bits per byte, text formats store a string of '0's and '1's.*/
+  struct PackedBits
+  {
+    static constexpr std::size_t wordBits = 64;
+
+    std::size_t size {0};
+    std::vector<uint64_t> words;
+
+    static auto wordCount (std::size_t bitCount) -> std::size_t
+    {
+      return (bitCount + wordBits - 1) / wordBits;
+    }
+
+    bool test (std::size_t i) const
+    {
+      return ((words [i / wordBits] >> (i % wordBits)) & 1u) != 0;
+    }
+
+    /** Packs `bits [0]`, ..., `bits [bitCount - 1]`. The bits are tested one by one, since containers like
+      `std::vector<bool>` do not expose their words, but each word is only stored once it is complete.*/
+    template <class BITS>
+    static auto pack (BITS const& bits, std::size_t bitCount) -> PackedBits
+    {
+      PackedBits packed {bitCount, std::vector<uint64_t> (wordCount (bitCount))};
+      for (std::size_t w = 0; w < packed.words.size (); ++w)
+      {
+        uint64_t word = 0;
+        auto const end = std::min (bitCount, (w + 1) * wordBits);
+        for (auto i = w * wordBits; i < end; ++i)
+          word |= static_cast<uint64_t> (static_cast<bool> (bits [i])) << (i % wordBits);
+        packed.words [w] = word;
+      }
+      return packed;
+    }
+
+    /// Assigns the bits to `bits [0]`, ..., `bits [size - 1]` one by one.
+    template <class BITS>
+    void unpack (BITS& bits) const
+    {
+      for (std::size_t w = 0; w < words.size (); ++w)
+      {
+        auto word = words [w];
+        auto const end = std::min (size, (w + 1) * wordBits);
+        for (auto i = w * wordBits; i < end; ++i, word >>= 1)
+          bits [i] = (word & 1u) != 0;
+      }
+    }
+
+    auto to_string () const -> std::string
+    {
+      std::string text (size, '0');
+      for (std::size_t i = 0; i < size; ++i)
+      {
+        if (test (i))
+          text [i] = '1';
+      }
+      return text;
+    }
+
+    static auto from_string (std::string const& text) -> PackedBits
+    {
+      PackedBits packed {text.size (), std::vector<uint64_t> (wordCount (text.size ()))};
+      for (std::size_t i = 0; i < text.size (); ++i)
+      {
+        if (text [i] == '1')
+          packed.words [i / wordBits] |= uint64_t {1} << (i % wordBits);
+        else if (text [i] != '0')
+          throw ArchiveError {} << "Invalid character '" << text [i] << "' in bits.";
+      }
+      return packed;
+    }
+  };
+
+  template <>
+  struct TypeTraits <PackedBits>
+  {static constexpr EntryType entryType = EntryType::Value;};
+}// end of namespace moose
@@ -0,0 +1,288 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <moose/content_type.h>
+#include <moose/export.h>
+#include <moose/reader.h>
+#include <moose/writer.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace moose
+{
+  /// Aggregated statistics of all entries with the same field path or type.
+  struct ProfileStatistics
+  {
+    /// Number of entries.
+    uint64_t count {0};
+    /// Number of entries whose time and size were measured.
+    uint64_t measured {0};
+    /// Bytes produced or consumed by the measured entries, including their children.
+    uint64_t bytes {0};
+    /// Wall time in seconds spent in the measured entries, including their children.
+    double seconds {0};
+
+    /// Bytes of all entries, extrapolated from the measured ones.
+    MOOSE_EXPORT auto estimated_bytes () const -> double;
+
+    /// Wall time of all entries, extrapolated from the measured ones.
+    MOOSE_EXPORT auto estimated_seconds () const -> double;
+  };
+
+  struct ProfilingOptions
+  {
+    /** Time and size are measured for every n-th entry of each field path. Entry counts are always exact.
+      Larger intervals reduce the overhead of profiling.*/
+    uint32_t samplingInterval {1};
+
+    /// Records an event for each measured entry, see `Profile::write_chrome_trace`.
+    bool trace {false};
+
+    /// Upper bound for the number of recorded trace events. Further events are dropped.
+    std::size_t maxTraceEvents {1u << 20};
+
+    /** Returns the current position in the serialized data. Bytes are only reported if this is set.
+      Note that the position only advances when the wrapped archive actually accesses its stream.
+      Readers which parse the whole input upfront, like the `JSONReader`, thus report no bytes.*/
+    std::function<std::size_t ()> position {};
+  };
+
+  /// Returns a function which reports the write position of `out`, to be used as `ProfilingOptions::position`.
+  MOOSE_EXPORT auto writePosition (std::ostream& out) -> std::function<std::size_t ()>;
+
+  /// Returns a function which reports the read position of `in`, to be used as `ProfilingOptions::position`.
+  MOOSE_EXPORT auto readPosition (std::istream& in) -> std::function<std::size_t ()>;
+
+  /** Statistics collected by a `ProfilingWriter` or `ProfilingReader`.
+    Entries are aggregated per field path, where all elements of an array share the path component `[]`,
+    and per type name, for entries of polymorphic types which store their type name.
+    A profile may be shared by several archives, but not concurrently.*/
+  class Profile
+  {
+  public:
+    struct Field
+    {
+      /// Names of the entries from the root to the field, separated by `/`.
+      std::string path;
+      ProfileStatistics statistics;
+    };
+
+  public:
+    MOOSE_EXPORT Profile ();
+
+    /// Returns the statistics of all fields, parents before their children.
+    MOOSE_EXPORT auto fields () const -> std::vector<Field>;
+
+    /// Returns the statistics of the entries of each type name.
+    MOOSE_EXPORT auto types () const -> std::map<std::string, ProfileStatistics, std::less<>> const&;
+
+    /// Writes the statistics of all fields and types as JSON.
+    MOOSE_EXPORT void write_json (std::ostream& out) const;
+
+    /** Writes the recorded trace events in the Chrome trace event format.
+      The output can be loaded into chrome://tracing, Perfetto or speedscope for flame views.
+      Events are only recorded if `ProfilingOptions::trace` is set.*/
+    MOOSE_EXPORT void write_chrome_trace (std::ostream& out) const;
+
+    MOOSE_EXPORT void clear ();
+
+  private:
+    friend class ProfileRecorder;
+
+    struct Node
+    {
+      std::string mName;
+      std::size_t mParent;
+      std::vector<std::size_t> mChildren {};
+      ProfileStatistics mStatistics {};
+    };
+
+    struct TraceEvent
+    {
+      std::size_t mNode;
+      std::chrono::steady_clock::duration mStart;
+      std::chrono::steady_clock::duration mDuration;
+    };
+
+  private:
+    auto child (std::size_t parent, const char* name) -> std::size_t;
+    auto path (std::size_t node) const -> std::string;
+
+  private:
+    std::chrono::steady_clock::time_point mEpoch;
+    /// The tree of field paths. The first node is the root.
+    std::vector<Node> mNodes;
+    std::map<std::string, ProfileStatistics, std::less<>> mTypes;
+    std::vector<TraceEvent> mTraceEvents;
+  };
+
+  /// Collects the entries of a decorated reader or writer in a `Profile`.
+  class ProfileRecorder
+  {
+  public:
+    ProfileRecorder (std::shared_ptr<Profile> profile, ProfilingOptions options);
+
+    void begin (const char* name, ContentType type);
+    void end ();
+    /// Ends the current entry without recording it.
+    void cancel ();
+    /// Attributes the current entry to the given type name.
+    void type (std::string const& name);
+
+  private:
+    struct Frame
+    {
+      std::size_t mNode;
+      ContentType mType;
+      bool mMeasured;
+      ProfileStatistics* mTypeStatistics {nullptr};
+      std::chrono::steady_clock::time_point mStart {};
+      std::size_t mPosition {0};
+    };
+
+  private:
+    std::shared_ptr<Profile> mProfile;
+    ProfilingOptions mOptions;
+    std::vector<Frame> mFrames;
+  };
+
+  /** Forwards all calls to another writer and records statistics about the written entries in a `Profile`.
+    \code
+      auto profile = std::make_shared<Profile> ();
+      auto out = std::make_shared<std::stringstream> ();
+      Archive archive {std::make_shared<ProfilingWriter> (std::make_shared<BinaryWriter<std::stringstream>> (out), profile,
+                                                         ProfilingOptions {.position = writePosition (*out)})};
+    \endcode*/
+  class ProfilingWriter : public Writer
+  {
+  public:
+    MOOSE_EXPORT ProfilingWriter (std::shared_ptr<Writer> writer, std::shared_ptr<Profile> profile,
+                                  ProfilingOptions options = {});
+
+    auto format () const -> Format override;
+
+    bool begin_entry (const char* name, ContentType type, Hint hint) override;
+    void end_entry (const char* name, ContentType type) override;
+    void write_array_size (std::size_t size) override;
+
+    void write_type_name (std::string const& typeName) override;
+    void write_type_version (Version const& version) override;
+
+    void write (const char* name, bool value) override;
+    void write (const char* name, double value) override;
+    void write (const char* name, std::string const& value) override;
+    void write (const char* name, PackedBits const& value) override;
+    void write (const char* name, char value) override;
+    void write (const char* name, unsigned char value) override;
+    void write (const char* name, int value) override;
+    void write (const char* name, long int value) override;
+    void write (const char* name, long long int value) override;
+    void write (const char* name, unsigned int value) override;
+    void write (const char* name, unsigned long int value) override;
+    void write (const char* name, unsigned long long int value) override;
+    void write (const char* name, float value) override;
+
+    void write_array (const char* name, std::span<char const> values) override;
+    void write_array (const char* name, std::span<unsigned char const> values) override;
+    void write_array (const char* name, std::span<int const> values) override;
+    void write_array (const char* name, std::span<long int const> values) override;
+    void write_array (const char* name, std::span<long long int const> values) override;
+    void write_array (const char* name, std::span<unsigned int const> values) override;
+    void write_array (const char* name, std::span<unsigned long int const> values) override;
+    void write_array (const char* name, std::span<unsigned long long int const> values) override;
+    void write_array (const char* name, std::span<float const> values) override;
+    void write_array (const char* name, std::span<double const> values) override;
+
+    bool write_raw (const char* name, RawLayout const& layout, void const* data, std::size_t count) override;
+    bool write_cached (const char* name, ContentType type, Hint hint, CacheKey const& key) override;
+
+    bool describes_schema () const override;
+    bool begin_schema_element (std::type_info const& type) override;
+    void end_schema_element () override;
+
+  private:
+    std::shared_ptr<Writer> mWriter;
+    ProfileRecorder mRecorder;
+  };
+
+  /// Forwards all calls to another reader and records statistics about the read entries in a `Profile`.
+  class ProfilingReader : public Reader
+  {
+  public:
+    MOOSE_EXPORT ProfilingReader (std::shared_ptr<Reader> reader, std::shared_ptr<Profile> profile,
+                                  ProfilingOptions options = {});
+
+    auto format () const -> Format override;
+
+    bool begin_entry (const char* name, ContentType type) override;
+    void end_entry (const char* name, ContentType type) override;
+
+    bool array_has_next (const char* name) const override;
+    auto array_size (const char* name) const -> std::optional<std::size_t> override;
+
+    auto type_name () const -> std::string override;
+    auto type_version () const -> Version override;
+
+    void read (const char* name, bool& value) const override;
+    void read (const char* name, double& value) const override;
+    void read (const char* name, std::string& value) const override;
+    void read (const char* name, PackedBits& value) const override;
+    void read (const char* name, char& value) const override;
+    void read (const char* name, unsigned char& value) const override;
+    void read (const char* name, int& value) const override;
+    void read (const char* name, long int& value) const override;
+    void read (const char* name, long long int& value) const override;
+    void read (const char* name, unsigned int& value) const override;
+    void read (const char* name, unsigned long int& value) const override;
+    void read (const char* name, unsigned long long int& value) const override;
+    void read (const char* name, float& value) const override;
+
+    void read_array (const char* name, std::span<char> values) override;
+    void read_array (const char* name, std::span<unsigned char> values) override;
+    void read_array (const char* name, std::span<int> values) override;
+    void read_array (const char* name, std::span<long int> values) override;
+    void read_array (const char* name, std::span<long long int> values) override;
+    void read_array (const char* name, std::span<unsigned int> values) override;
+    void read_array (const char* name, std::span<unsigned long int> values) override;
+    void read_array (const char* name, std::span<unsigned long long int> values) override;
+    void read_array (const char* name, std::span<float> values) override;
+    void read_array (const char* name, std::span<double> values) override;
+
+    bool read_raw (const char* name, RawLayout const& layout, void* data, std::size_t count) override;
+
+  private:
+    std::shared_ptr<Reader> mReader;
+    /// Mutable since the type name of an entry is only known once `type_name` was called.
+    mutable ProfileRecorder mRecorder;
+  };
+}// end of namespace moose
@@ -27,13 +27,27 @@
 
 #include <moose/content_type.h>
 #include <moose/export.h>
+#include <moose/format.h>
 #include <moose/hint.h>
+#include <moose/raw_layout.h>
 #include <moose/version.h>
 
+#include <cstddef>
+#include <optional>
+#include <span>
 #include <string>
 
 namespace moose
 {
+  struct PackedBits;
+
+  namespace detail
+  {
+    /** Sizes of streamed data can not be checked against the data before storage is allocated for them.
+      Such storage grows by at most this many bytes at a time, so that corrupt sizes fail at the end of the data.*/
+    constexpr std::size_t readChunkBytes = std::size_t {1} << 20;
+  }
+
   /** \brief Abstract base class for the implementation of readers for specific formats.
     An instance of a concrete derived class is passed to an `Archive` to perform deserialization.
   */
@@ -42,6 +56,9 @@ namespace moose
   public:
     MOOSE_EXPORT virtual ~Reader ();
 
+    /// Returns the format which is read. The default implementation returns `Format::Other`.
+    MOOSE_EXPORT virtual auto format () const -> Format;
+
     /** \brief Returns false if the specified entry was not found.
       If false was returned, no matching `end_entry` may be called.*/
     MOOSE_EXPORT virtual bool begin_entry (const char* name, ContentType type) = 0;
@@ -52,6 +69,12 @@ namespace moose
       If the current entry is not an array, the method should return false.*/
     MOOSE_EXPORT virtual bool array_has_next (const char* name) const = 0;
 
+    /** Called between `begin_entry` and `end_entry` of an array.
+      Returns the number of remaining elements, if it is known upfront, and `std::nullopt` otherwise.
+      The size may stem from corrupt data, so callers allocate storage for it in chunks of `detail::readChunkBytes`.
+      The default implementation returns `std::nullopt`.*/
+    MOOSE_EXPORT virtual auto array_size (const char* name) const -> std::optional<std::size_t>;
+
     /** Called between `begin_entry` and `end_entry`.*/
     MOOSE_EXPORT virtual std::string type_name () const = 0;
 
@@ -62,6 +85,9 @@ namespace moose
     MOOSE_EXPORT virtual void read (const char* name, double& val) const = 0;
     MOOSE_EXPORT virtual void read (const char* name, std::string& val) const = 0;
 
+    /// Reads a sequence of bools. The default implementation reads a string of '0's and '1's.
+    MOOSE_EXPORT virtual void read (const char* name, PackedBits& val) const;
+
   /** \brief reads a number value (int, float, ...).
     Default implementation redirects to 'read (const char*, double&)'
     \{ */
@@ -76,8 +102,35 @@ namespace moose
     MOOSE_EXPORT virtual void read (const char* name, float& val) const;
   /** \} */
 
+  /** \brief reads `values.size ()` number values from the elements of the current array.
+    Called between `begin_entry` and `end_entry` of an array, instead of reading separate element entries.
+    Default implementation reads each value from an unnamed element entry.
+    Throws an `ArchiveError` if the array contains fewer elements.
+    \{ */
+    MOOSE_EXPORT virtual void read_array (const char* name, std::span<char> values);
+    MOOSE_EXPORT virtual void read_array (const char* name, std::span<unsigned char> values);
+    MOOSE_EXPORT virtual void read_array (const char* name, std::span<int> values);
+    MOOSE_EXPORT virtual void read_array (const char* name, std::span<long int> values);
+    MOOSE_EXPORT virtual void read_array (const char* name, std::span<long long int> values);
+    MOOSE_EXPORT virtual void read_array (const char* name, std::span<unsigned int> values);
+    MOOSE_EXPORT virtual void read_array (const char* name, std::span<unsigned long int> values);
+    MOOSE_EXPORT virtual void read_array (const char* name, std::span<unsigned long long int> values);
+    MOOSE_EXPORT virtual void read_array (const char* name, std::span<float> values);
+    MOOSE_EXPORT virtual void read_array (const char* name, std::span<double> values);
+  /** \} */
+
+    /** \brief Reads `count` instances of a trivially copyable type from raw bytes.
+      Called directly after `begin_entry`, either of a struct (with `count == 1`) or of an array.
+      Returns `false` if the current entry does not contain raw data. The archive then calls `Serialize`
+      for each instance instead. Throws an `ArchiveError` if the stored layout differs from `layout`.
+      The default implementation returns `false`.*/
+    MOOSE_EXPORT virtual bool read_raw (const char* name, RawLayout const& layout, void* data, std::size_t count);
+
   private:
     template <class T>
     void read_double (const char* name, T& val) const;
+
+    template <class T>
+    void read_elements (const char* name, std::span<T> values);
   };
 }// end of namespace moose
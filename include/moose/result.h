@@ -0,0 +1,83 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <moose/exceptions.h>
+
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace moose
+{
+  /** \brief Either a value or the description of the error which prevented its creation.
+    Returned by the functions which report errors without throwing, e.g. `tryFromJson`.*/
+  template <class T>
+  class Result
+  {
+  public:
+    Result (T value) : mValue {std::move (value)} {}
+
+    static auto failure (std::string error) -> Result
+    {
+      Result result;
+      result.mError = std::move (error);
+      return result;
+    }
+
+    bool has_value () const {return mValue.has_value ();}
+    explicit operator bool () const {return has_value ();}
+
+    /// Returns the value. Throws an `ArchiveError` with the description of the error if there is no value.
+    auto value () -> T&
+    {
+      if (!mValue)
+        throw ArchiveError () << mError;
+      return *mValue;
+    }
+
+    auto value () const -> T const&
+    {
+      if (!mValue)
+        throw ArchiveError () << mError;
+      return *mValue;
+    }
+
+    auto operator * () -> T& {return *mValue;}
+    auto operator * () const -> T const& {return *mValue;}
+    auto operator -> () -> T* {return &*mValue;}
+    auto operator -> () const -> T const* {return &*mValue;}
+
+    /// Returns the description of the error, or an empty string if a value is present.
+    auto error () const -> std::string const& {return mError;}
+
+  private:
+    Result () = default;
+
+  private:
+    std::optional<T> mValue;
+    std::string mError;
+  };
+}// end of namespace moose
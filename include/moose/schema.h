@@ -0,0 +1,137 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <moose/archive.h>
+#include <moose/binary_options.h>
+#include <moose/export.h>
+#include <moose/writer.h>
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+
+namespace moose
+{
+  /** Computes a fingerprint of the entries which `Serialize` writes, see `schemaFingerprint`.
+    The fingerprint covers what the binary format depends on: the order and content types of all entries
+    and the kinds of all values, i.e., whether they are bools, strings, floating point numbers or signed or
+    unsigned integers of a certain width in the binary format, or packed bits. Names, hints, type names and versions are ignored.*/
+  class SchemaWriter : public Writer
+  {
+  public:
+    auto fingerprint () const -> uint64_t {return mHash;}
+
+    auto format () const -> Format override;
+    bool describes_schema () const override;
+    bool begin_schema_element (std::type_info const& type) override;
+    void end_schema_element () override;
+
+    bool begin_entry (const char* name, ContentType type, Hint hint) override;
+    void end_entry (const char* name, ContentType type) override;
+
+    void write_type_name (std::string const& typeName) override;
+    void write_type_version (Version const& version) override;
+
+    void write (const char* name, bool value) override;
+    void write (const char* name, double value) override;
+    void write (const char* name, std::string const& value) override;
+    void write (const char* name, PackedBits const& value) override;
+    void write (const char* name, char value) override;
+    void write (const char* name, unsigned char value) override;
+    void write (const char* name, int value) override;
+    void write (const char* name, long int value) override;
+    void write (const char* name, long long int value) override;
+    void write (const char* name, unsigned int value) override;
+    void write (const char* name, unsigned long int value) override;
+    void write (const char* name, unsigned long long int value) override;
+    void write (const char* name, float value) override;
+
+    void write_array (const char* name, std::span<char const> values) override;
+    void write_array (const char* name, std::span<unsigned char const> values) override;
+    void write_array (const char* name, std::span<int const> values) override;
+    void write_array (const char* name, std::span<long int const> values) override;
+    void write_array (const char* name, std::span<long long int const> values) override;
+    void write_array (const char* name, std::span<unsigned int const> values) override;
+    void write_array (const char* name, std::span<unsigned long int const> values) override;
+    void write_array (const char* name, std::span<unsigned long long int const> values) override;
+    void write_array (const char* name, std::span<float const> values) override;
+    void write_array (const char* name, std::span<double const> values) override;
+
+  private:
+    void add (uint8_t byte);
+
+    template <class T>
+    void add_number ();
+
+    /** Arrays of numbers are described like a single element, so that they match ranges
+      whose elements are written one by one.*/
+    template <class T>
+    void add_array ();
+
+  private:
+    uint64_t mHash {14695981039346656037ull};
+    /// Types whose default instances are currently being described, to stop at recursive types.
+    std::vector<std::type_index> mDescribed;
+  };
+
+  /** Returns the fingerprint of the schema of `T`, which is computed once from a default constructed instance.
+    The pointees of null pointers and the elements of empty ranges are described through default constructed
+    instances of their static types, where pointees have to be registered in `types ()` before the first call.
+    Recursive types are described up to their first repetition.*/
+  template <class T>
+  auto schemaFingerprint () -> uint64_t
+  {
+    static uint64_t const fingerprint = []
+    {
+      auto writer = std::make_shared<SchemaWriter> ();
+      Archive archive {writer};
+      T instance {};
+      archive ("", instance);
+      return writer->fingerprint ();
+    } ();
+    return fingerprint;
+  }
+
+  namespace detail
+  {
+    /** Sets the schema fingerprint of `T` if a header is written and no fingerprint was given.
+      Tagged data tolerates added and removed members and thus gets no fingerprint.*/
+    template <class T>
+    auto withSchemaOf (BinaryOptions options) -> BinaryOptions
+    {
+      if constexpr (std::is_default_constructible_v<T>)
+      {
+        if (options.header && !options.tagged && options.schema == 0)
+          options.schema = schemaFingerprint<T> ();
+      }
+      return options;
+    }
+  }// end of namespace detail
+}// end of namespace moose
@@ -0,0 +1,63 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <moose/exceptions.h>
+#include <moose/packed_bits.h>
+#include <moose/type_traits.h>
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace moose
+{
+  template <std::size_t n>
+  struct TypeTraits <std::bitset <n>>
+  {
+    static constexpr EntryType entryType = EntryType::ForwardValue;
+    using ForwardedType = PackedBits;
+
+    static auto getForwardedValue (std::bitset <n> const& from) -> ForwardedType
+    {
+      // Bitsets which fit into a single word are converted as a whole.
+      if constexpr (n <= PackedBits::wordBits)
+        return PackedBits {n, std::vector<uint64_t> (PackedBits::wordCount (n), from.to_ullong ())};
+      else
+        return PackedBits::pack (from, n);
+    }
+
+    static void setForwardedValue (std::bitset <n>& to, ForwardedType&& value)
+    {
+      if (value.size != n)
+        throw ArchiveError () << "Expected " << n << " bits but found " << value.size << ".";
+
+      if constexpr (n <= PackedBits::wordBits)
+        to = std::bitset <n> (value.words.empty () ? 0 : value.words.front ());
+      else
+        value.unpack (to);
+    }
+  };
+}// end of namespace moose
@@ -26,8 +26,10 @@
 #pragma once
 
 #include <moose/archive.h>
+#include <moose/packed_bits.h>
 
 #include <moose/stl/array.h>
+#include <moose/stl/bitset.h>
 #include <moose/stl/filesystem.h>
 #include <moose/stl/optional.h>
 #include <moose/stl/variant.h>
@@ -69,6 +71,23 @@ namespace moose
     { vector.clear (); }
   };
 
+  /// `std::vector<bool>` is stored as `PackedBits`, since its elements can not be referenced.
+  template <class Allocator>
+  struct TypeTraits <std::vector <bool, Allocator>>
+  {
+    static constexpr EntryType entryType = EntryType::ForwardValue;
+    using ForwardedType = PackedBits;
+
+    static auto getForwardedValue (std::vector <bool, Allocator> const& from) -> ForwardedType
+    { return PackedBits::pack (from, from.size ()); }
+
+    static void setForwardedValue (std::vector <bool, Allocator>& to, ForwardedType&& value)
+    {
+      to.resize (value.size);
+      value.unpack (to);
+    }
+  };
+
   template <class Key, class Value, class Compare, class Allocator>
   struct TypeTraits <std::map <Key, Value, Compare, Allocator>>
   {
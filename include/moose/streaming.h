@@ -0,0 +1,251 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <moose/archive.h>
+#include <moose/exceptions.h>
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace moose
+{
+  /// Passed to `generate` for sequences whose length is only known once the producer is exhausted.
+  struct Unbounded {};
+  inline constexpr Unbounded unbounded {};
+
+  namespace detail
+  {
+    template <class T>
+    struct Produced
+    {
+      using ValueType = T;
+      static constexpr bool optional = false;
+    };
+
+    template <class T>
+    struct Produced<std::optional<T>>
+    {
+      using ValueType = T;
+      static constexpr bool optional = true;
+    };
+  }// end of namespace detail
+
+  /** \brief A sequence whose elements are created on demand while it is written.
+    Created through `generate`. Only one element is alive at a time, so arbitrarily long
+    sequences can be written without materializing them in a container.*/
+  template <class COUNT, class PRODUCER>
+  class Generator
+  {
+    using Produced = detail::Produced<std::remove_cvref_t<std::invoke_result_t<PRODUCER&>>>;
+    static constexpr bool bounded = std::is_same_v<COUNT, std::size_t>;
+
+  public:
+    using ValueType = typename Produced::ValueType;
+
+    static_assert (bounded || Produced::optional,
+                   "Unbounded generators have to signal their end by returning `std::nullopt`.");
+
+    class Iterator
+    {
+    public:
+      using value_type = ValueType;
+      using difference_type = std::ptrdiff_t;
+
+      Iterator () = default;
+      Iterator (Generator* generator, std::size_t index) : mGenerator {generator}, mIndex {index} {}
+
+      auto operator * () const -> ValueType& {return *mGenerator->mCurrent;}
+
+      auto operator ++ () -> Iterator&
+      {
+        ++mIndex;
+        mGenerator->produce (mIndex);
+        return *this;
+      }
+
+      void operator ++ (int) {++*this;}
+
+      bool operator == (Iterator const& other) const
+      {
+        if constexpr (bounded)
+          return mIndex == other.mIndex;
+        else
+          return done () == other.done ();
+      }
+
+      auto operator - (Iterator const& other) const -> difference_type
+        requires bounded
+      {
+        return static_cast<difference_type> (mIndex) - static_cast<difference_type> (other.mIndex);
+      }
+
+    private:
+      bool done () const {return mGenerator == nullptr || !mGenerator->mCurrent;}
+
+      Generator* mGenerator {nullptr};
+      std::size_t mIndex {0};
+    };
+
+    Generator (COUNT count, PRODUCER producer)
+      : mCount {count}
+      , mProducer {std::move (producer)}
+    {}
+
+    /// Produces the first element. A generator can thus only be iterated once.
+    auto begin () -> Iterator
+    {
+      produce (0);
+      return {this, 0};
+    }
+
+    auto end () -> Iterator
+    {
+      if constexpr (bounded)
+        return {this, mCount};
+      else
+        return {};
+    }
+
+  private:
+    void produce (std::size_t index)
+    {
+      if constexpr (bounded)
+      {
+        if (index >= mCount)
+          return mCurrent.reset ();
+      }
+
+      if constexpr (Produced::optional)
+      {
+        mCurrent = mProducer ();
+        if constexpr (bounded)
+        {
+          if (!mCurrent)
+            throw ArchiveError () << "Generator ended after " << index << " of " << mCount << " elements.";
+        }
+      }
+      else
+        mCurrent.emplace (mProducer ());
+    }
+
+    COUNT mCount;
+    PRODUCER mProducer;
+    std::optional<ValueType> mCurrent;
+  };
+
+  /** \brief Writes `count` elements, which are returned one by one by `producer`.
+    The elements are written as a regular array and can be read into any sequence, e.g. a `std::vector`.
+    \code
+      ar ("samples", moose::generate (count, [&, i = 0] () mutable {return sample (i++);}));
+    \endcode
+    Pass `moose::unbounded` instead of a count if the number of elements is not known upfront.
+    The producer then returns a `std::optional` and ends the sequence with `std::nullopt`.
+    A bounded producer may also return a `std::optional`, but it must not end early.*/
+  template <class PRODUCER>
+  auto generate (std::size_t count, PRODUCER producer) -> Generator<std::size_t, PRODUCER>
+  {
+    return {count, std::move (producer)};
+  }
+
+  template <class PRODUCER>
+  auto generate (Unbounded, PRODUCER producer) -> Generator<Unbounded, PRODUCER>
+  {
+    return {unbounded, std::move (producer)};
+  }
+
+  /** \brief A sequence whose elements are handed to a callback while it is read.
+    Created through `consume`.*/
+  template <class T, class CALLBACK>
+  class Consumer
+  {
+  public:
+    using ValueType = T;
+
+    explicit Consumer (CALLBACK callback) : mCallback {std::move (callback)} {}
+
+    void push (T&& value) {std::invoke (mCallback, std::move (value));}
+
+  private:
+    CALLBACK mCallback;
+  };
+
+  /** \brief Reads an array element by element and passes each element to `callback`.
+    Only one element is alive at a time, so the elements do not have to fit into memory together.
+    Since the archive needs an lvalue to read into, the consumer has to be stored in a variable:
+    \code
+      auto sink = moose::consume<Sample> ([&] (Sample&& s) {total += s.value;});
+      ar ("samples", sink);
+    \endcode
+    Note that the `JSONReader` holds the whole document in memory, whereas the `BinaryReader`
+    reads from its stream on demand.*/
+  template <class T, class CALLBACK>
+  auto consume (CALLBACK callback) -> Consumer<T, CALLBACK>
+  {
+    return Consumer<T, CALLBACK> {std::move (callback)};
+  }
+
+  template <class COUNT, class PRODUCER>
+  struct TypeTraits <Generator<COUNT, PRODUCER>>
+  {
+    using Type = Generator<COUNT, PRODUCER>;
+    using ValueType = typename Type::ValueType;
+
+    static constexpr EntryType entryType = EntryType::Vector;
+
+    static auto toRange (Type& generator)
+    {
+      return makeRange (generator.begin (), generator.end ());
+    }
+
+    static void pushBack (Type&, ValueType const&)
+    { throw ArchiveError () << "Generators can only be written. Use `consume` to read a sequence element by element."; }
+
+    static void clear (Type&)
+    { throw ArchiveError () << "Generators can only be written. Use `consume` to read a sequence element by element."; }
+  };
+
+  template <class T, class CALLBACK>
+  struct TypeTraits <Consumer<T, CALLBACK>>
+  {
+    using Type = Consumer<T, CALLBACK>;
+    using ValueType = T;
+
+    static constexpr EntryType entryType = EntryType::Vector;
+
+    static auto toRange (Type&) -> Range<ValueType*>
+    { throw ArchiveError () << "Consumers can only be read. Use `generate` to write a sequence element by element."; }
+
+    static void pushBack (Type& consumer, ValueType value)
+    { consumer.push (std::move (value)); }
+
+    static void clear (Type&)
+    {}
+  };
+}// end of namespace moose
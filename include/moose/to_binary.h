@@ -25,18 +25,51 @@
 #pragma once
 
 #include <moose/binary_writer.h>
+#include <moose/byte_buffer.h>
 #include <moose/archive.h>
+#include <moose/schema.h>
 
+#include <cstddef>
 #include <sstream>
+#include <vector>
 
 namespace moose
 {
   template <class T>
-  auto toBinary (T const& t) -> std::shared_ptr<std::stringstream>
+  auto toBinary (T const& t, BinaryOptions options = {}) -> std::shared_ptr<std::stringstream>
   {
     auto out = std::make_shared<std::stringstream> ();
-    moose::Archive archive {std::make_shared<moose::BinaryWriter<std::stringstream>> (out)};
+    moose::Archive archive {std::make_shared<moose::BinaryWriter<std::stringstream>> (out, detail::withSchemaOf<T> (options))};
     archive ("", t);
     return out;
   }
+
+  /** Appends the binary representation of `t` to `out`. The bytes are written directly into `out`, whose
+    capacity is reused. Clear it to reuse it for the next object. If an error is thrown, `out` holds
+    the bytes which were written until then.*/
+  template <class T>
+  void toBinary (T const& t, std::vector<std::byte>& out, BinaryOptions options = {})
+  {
+    ByteBuffer buffer {std::move (out)};
+    try
+    {
+      moose::Archive archive {std::make_shared<moose::BinaryWriter<ByteBuffer>> (buffer, detail::withSchemaOf<T> (options))};
+      archive ("", t);
+    }
+    catch (...)
+    {
+      out = buffer.take ();
+      throw;
+    }
+    out = buffer.take ();
+  }
+
+  /// Returns the binary representation of `t` as contiguous bytes.
+  template <class T>
+  auto toBinaryBytes (T const& t, BinaryOptions options = {}) -> std::vector<std::byte>
+  {
+    std::vector<std::byte> out;
+    toBinary (t, out, options);
+    return out;
+  }
 }
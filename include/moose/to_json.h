@@ -33,12 +33,12 @@
 namespace moose
 {
   template <class T>
-  auto toJson (const char* name, T const& t) -> std::string
+  auto toJson (const char* name, T const& t, JSONOptions options = {}) -> std::string
   {
     auto out = std::make_shared<std::stringstream> ();
     // Archiving happens in a scope to make sure it is finished whent we access the output.
     {
-      moose::Archive archive {std::make_shared<moose::JSONWriter> (out)};
+      moose::Archive archive {std::make_shared<moose::JSONWriter> (out, options)};
       archive (name, t);
     }
     return std::move (out)->str ();
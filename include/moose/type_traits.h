@@ -26,17 +26,50 @@
 #pragma once
 
 #include <moose/exceptions.h>
+#include <moose/format.h>
 #include <moose/hint.h>
 #include <moose/range.h>
 
 #include <magic_enum.hpp>
 
+#include <cstdint>
 #include <string>
+#include <type_traits>
 
 namespace moose
 {
   enum class EntryType
   {
+    /** Types with a `serialize` member method or a global `Serialize` method.
+      If a struct is trivially copyable, its traits may additionally specify
+      \code
+        template <>
+        struct TypeTraits<YourTriviallyCopyableType>
+        {
+          static constexpr EntryType entryType = EntryType::Struct;
+          static constexpr bool rawBinary = true;
+        };
+      \endcode
+      Binary writers then store instances and contiguous sequences of instances as raw bytes,
+      together with a layout fingerprint (size, alignment, number of fields), instead of calling
+      `Serialize` for each instance. Other formats still use `Serialize`.
+
+      Immutable or rarely changing structs may opt in to the encoding cache of writers
+      (e.g. `BinaryOptions::encodingCache`). They have to provide a generation counter, which
+      changes whenever the content of an instance changes. Instances which never change may return a constant:
+      \code
+        template <>
+        struct TypeTraits<YourLookupTable>
+        {
+          static constexpr EntryType entryType = EntryType::Struct;
+          static constexpr bool cacheEncoding = true;
+          static auto generation (YourLookupTable const& table) -> uint64_t {return table.revision ();}
+        };
+      \endcode
+      Cached encodings are identified by the address of an instance (or of the object a pointer
+      points to), its type and its generation. Writers then splice the stored encoding into their
+      output instead of calling `Serialize`.
+    */
     Struct,
 
     Value, ///< Plain values. Those are directly supported by the archive.
@@ -104,6 +137,22 @@ namespace moose
 
     /** Just like `ForwardValue`, but `getForwardedValue` returns a reference.*/
     ForwardReference,
+
+    /** Types which are stored differently depending on the format of the archive, see `Archive::format`.
+      The traits of such a type provide the traits to use for each format. Those may have any entry type
+      except `Value` and `PerFormat`:
+      \code
+        template <>
+        struct TypeTraits <YourEnum>
+        {
+          static constexpr EntryType entryType = EntryType::PerFormat;
+          template <Format format>
+          using Traits = std::conditional_t<format == Format::Binary, EnumToIntTraits<YourEnum>,
+                                            EnumToStringTraits<YourEnum>>;
+        };
+      \endcode
+      Format specific traits of type `Struct` call `Serialize`, which may query `Archive::format` itself.*/
+    PerFormat,
   };
 
   template <class T>
@@ -151,6 +200,11 @@ namespace moose
   constexpr bool isForwardReference ()
   { return TypeTraits<T>::entryType == EntryType::ForwardReference; }
 
+  /// Number values may be read and written in bulk through `Reader::read_array` and `Writer::write_array`.
+  template <class T>
+  constexpr bool isNumber ()
+  { return isValue<T> () && std::is_arithmetic_v<T> && !std::is_same_v<T, bool>; }
+
   template <class T>
   concept TraitsHas_canBeUnpacked = requires ()
   { {TypeTraits<T>::canBeUnpacked} -> std::convertible_to<bool>; };
@@ -183,6 +237,52 @@ namespace moose
     return false;
   }
 
+  template <class T>
+  concept TraitsHas_rawBinary = requires ()
+  { {TypeTraits<T>::rawBinary} -> std::convertible_to<bool>; };
+
+  template <TraitsHas_rawBinary T>
+  constexpr bool isRawBinary ()
+  {
+    static_assert (!TypeTraits<T>::rawBinary || std::is_trivially_copyable_v<T>,
+                   "Only trivially copyable types may be serialized as raw bytes.");
+    return isStruct<T> () && TypeTraits<T>::rawBinary;
+  }
+
+  template <class T>
+  constexpr bool isRawBinary ()
+  {
+    return false;
+  }
+
+  template <class T>
+  concept TraitsHas_cacheEncoding = requires ()
+  { {TypeTraits<T>::cacheEncoding} -> std::convertible_to<bool>; };
+
+  template <class T>
+  concept TraitsHas_generation = requires (T const& t)
+  { {TypeTraits<T>::generation (t)} -> std::convertible_to<uint64_t>; };
+
+  template <TraitsHas_cacheEncoding T>
+  constexpr bool isEncodingCached ()
+  {
+    // Without a generation, changed instances at the same address would reuse stale encodings.
+    static_assert (!TypeTraits<T>::cacheEncoding || TraitsHas_generation<T>,
+                   "Types whose encoding is cached have to provide `TypeTraits::generation`.");
+    return isStruct<T> () && TypeTraits<T>::cacheEncoding;
+  }
+
+  template <class T>
+  constexpr bool isEncodingCached ()
+  {
+    return false;
+  }
+
+  /// The generation of an instance whose encoding is cached.
+  template <TraitsHas_generation T>
+  auto encodingGeneration (T const& t) -> uint64_t
+  { return TypeTraits<T>::generation (t); }
+
   template <class T>
   concept TraitsHas_hint = requires ()
   { {TypeTraits<T>::hint} -> std::convertible_to<Hint>; };
@@ -253,7 +353,7 @@ namespace moose
   struct EnumToIntTraits
   {
     static constexpr EntryType entryType = EntryType::ForwardValue;
-    using ForwardedType = std::underlying_type<T>;
+    using ForwardedType = std::underlying_type_t<T>;
 
     static ForwardedType getForwardedValue (T const& from)
     {
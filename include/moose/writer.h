@@ -26,14 +26,22 @@
 #pragma once
 
 #include <moose/content_type.h>
+#include <moose/encoding_cache.h>
 #include <moose/export.h>
+#include <moose/format.h>
 #include <moose/hint.h>
+#include <moose/raw_layout.h>
 #include <moose/version.h>
 
+#include <cstddef>
+#include <span>
 #include <string>
+#include <typeinfo>
 
 namespace moose
 {
+  struct PackedBits;
+
   /** \brief Abstract base class for the implementation of writers for specific format.
     An instance of a concrete derived class is passed to an `Archive` to perform serialization.
   */
@@ -42,11 +50,18 @@ namespace moose
   public:
     MOOSE_EXPORT virtual ~Writer ();
 
+    /// Returns the format which is written. The default implementation returns `Format::Other`.
+    MOOSE_EXPORT virtual auto format () const -> Format;
+
     /** \brief Returns false if the specified entry was not found.
       If false was returned, no matching `end_entry` may be called.*/
     MOOSE_EXPORT virtual bool begin_entry (const char* name, ContentType type, Hint hint) = 0;
     MOOSE_EXPORT virtual void end_entry (const char* name, ContentType type) = 0;
 
+    /** \brief Called directly after `begin_entry` of an array, if the number of elements is known upfront.
+      Writers may store the size instead of marking each element. The default implementation does nothing.*/
+    MOOSE_EXPORT virtual void write_array_size (std::size_t size);
+
     MOOSE_EXPORT virtual void write_type_name (std::string const& typeName) = 0;
     MOOSE_EXPORT virtual void write_type_version (Version const& version) = 0;
 
@@ -54,6 +69,9 @@ namespace moose
     MOOSE_EXPORT virtual void write (const char* name, double val) = 0;
     MOOSE_EXPORT virtual void write (const char* name, std::string const& val) = 0;
 
+    /// Writes a sequence of bools. The default implementation writes a string of '0's and '1's.
+    MOOSE_EXPORT virtual void write (const char* name, PackedBits const& val);
+
   /** \brief writes a number value (int, float, ...).
     Default implementation redirects to 'write (const char*, double&)'
     \{ */
@@ -68,8 +86,53 @@ namespace moose
     MOOSE_EXPORT virtual void write (const char* name, float val);
   /** \} */
 
+  /** \brief writes a contiguous sequence of number values as the elements of the current array.
+    Called directly after `begin_entry` of an array, instead of `write_array_size` and separate element entries.
+    Default implementation writes an unnamed value entry for each element.
+    \{ */
+    MOOSE_EXPORT virtual void write_array (const char* name, std::span<char const> values);
+    MOOSE_EXPORT virtual void write_array (const char* name, std::span<unsigned char const> values);
+    MOOSE_EXPORT virtual void write_array (const char* name, std::span<int const> values);
+    MOOSE_EXPORT virtual void write_array (const char* name, std::span<long int const> values);
+    MOOSE_EXPORT virtual void write_array (const char* name, std::span<long long int const> values);
+    MOOSE_EXPORT virtual void write_array (const char* name, std::span<unsigned int const> values);
+    MOOSE_EXPORT virtual void write_array (const char* name, std::span<unsigned long int const> values);
+    MOOSE_EXPORT virtual void write_array (const char* name, std::span<unsigned long long int const> values);
+    MOOSE_EXPORT virtual void write_array (const char* name, std::span<float const> values);
+    MOOSE_EXPORT virtual void write_array (const char* name, std::span<double const> values);
+  /** \} */
+
+    /** \brief Writes `count` instances of a trivially copyable type as raw bytes.
+      Called directly after `begin_entry`, either of a struct (with `count == 1`) or of an array.
+      Returns `false` if the writer does not support raw data. The archive then calls `Serialize`
+      for each instance instead. The default implementation returns `false`.*/
+    MOOSE_EXPORT virtual bool write_raw (const char* name, RawLayout const& layout, void const* data, std::size_t count);
+
+    /** \brief Writes a complete entry from the encoding cache of the writer.
+      Called instead of `begin_entry` for objects which opted in to encoding caching.
+      Returns `false` if no encoding is stored for `key`. The archive then writes the entry regularly,
+      starting with `begin_entry`, and the writer may store the encoding of that entry for `key`.
+      The default implementation returns `false`.*/
+    MOOSE_EXPORT virtual bool write_cached (const char* name, ContentType type, Hint hint, CacheKey const& key);
+
+    /** \brief Returns `true` if the writer describes the schema of the written types instead of their values.
+      The archive then also describes data which is not present in the written instance, i.e., the pointees of
+      null pointers and the elements of empty ranges, through default constructed instances.
+      The default implementation returns `false`.*/
+    MOOSE_EXPORT virtual bool describes_schema () const;
+
+    /** \brief Called before a default constructed instance of `type` is described, see `describes_schema`.
+      Returns `false` if the instance shall not be described, e.g. because `type` is already being described
+      by an enclosing entry. Otherwise, `end_schema_element` is called once the instance was described.
+      The default implementation returns `false`.*/
+    MOOSE_EXPORT virtual bool begin_schema_element (std::type_info const& type);
+    MOOSE_EXPORT virtual void end_schema_element ();
+
   private:
     template <class T>
     void write_double (const char* name, T val);
+
+    template <class T>
+    void write_elements (const char* name, std::span<T const> values);
   };
 }// end of namespace moose
@@ -53,6 +53,21 @@ namespace moose
     return mOutput != nullptr;
   }
 
+  auto Archive::format () const -> Format
+  {
+    return is_reading () ? mInput->format () : mOutput->format ();
+  }
+
+  void Archive::record_errors ()
+  {
+    mRecordErrors = true;
+  }
+
+  auto Archive::error () const -> std::string const&
+  {
+    return mError;
+  }
+
   auto Archive::type_version (Version const& latestVersion) -> Version
   {
     if (is_reading ())
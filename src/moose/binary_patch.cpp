@@ -0,0 +1,517 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <moose/binary_patch.h>
+#include <moose/exceptions.h>
+#include <moose/detail/byte_order.h>
+#include <moose/detail/varint.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace moose
+{
+  namespace
+  {
+    using Events = std::vector<EventTape::Event>;
+
+    /// Operations of a patch, each of which describes how an entry of the baseline is transformed.
+    enum class Operation : uint8_t
+    {
+      Keep = 0,    ///< The entry is unchanged.
+      Replace = 1, ///< The entry is replaced by the entry which follows.
+      Descend = 2  ///< The entry is a struct or an array whose children are patched, see `writeChildren`.
+    };
+
+    enum class ValueTag : uint8_t
+    {
+      Bool,
+      Int,
+      UInt,
+      Double,
+      String
+    };
+
+    void writeVarint (std::string& out, uint64_t value)
+    {
+      uint8_t buffer [detail::maxVarintSize];
+      out.append (reinterpret_cast<char const*> (buffer), detail::encodeVarint (value, buffer));
+    }
+
+    void writeByte (std::string& out, uint8_t value)
+    {
+      out.push_back (static_cast<char> (value));
+    }
+
+    void writeValue (std::string& out, EventTape::Value const& value)
+    {
+      writeByte (out, static_cast<uint8_t> (value.index ()));
+      switch (static_cast<ValueTag> (value.index ()))
+      {
+        case ValueTag::Bool: writeByte (out, std::get<bool> (value) ? 1 : 0); break;
+        case ValueTag::Int: writeVarint (out, detail::zigZagEncode (std::get<int64_t> (value))); break;
+        case ValueTag::UInt: writeVarint (out, std::get<uint64_t> (value)); break;
+        case ValueTag::Double:
+        {
+          auto const bits = detail::littleEndian (std::bit_cast<uint64_t> (std::get<double> (value)));
+          out.append (reinterpret_cast<char const*> (&bits), sizeof (bits));
+          break;
+        }
+        case ValueTag::String:
+        {
+          auto const& str = std::get<std::string> (value);
+          writeVarint (out, str.size ());
+          out.append (str);
+          break;
+        }
+      }
+    }
+
+    void writeLeaf (std::string& out, EventTape::Value const& value)
+    {
+      writeByte (out, static_cast<uint8_t> (EventTape::Kind::Leaf));
+      writeValue (out, value);
+    }
+
+    /// Writes the events of the entry or value starting at `events [first]`.
+    void writeEntry (std::string& out, Events const& events, std::size_t first)
+    {
+      for (auto i = first; i < events [first].mEnd; ++i)
+      {
+        auto const& event = events [i];
+        writeByte (out, static_cast<uint8_t> (event.mKind));
+        if (event.mKind == EventTape::Kind::Begin)
+          writeByte (out, static_cast<uint8_t> (event.mType));
+        else if (event.mKind == EventTape::Kind::Leaf)
+          writeValue (out, event.mValue);
+      }
+    }
+
+    /// Returns the indices of the entries and values in `[first, last)` which are direct children.
+    auto children (Events const& events, std::size_t first, std::size_t last) -> std::vector<std::size_t>
+    {
+      std::vector<std::size_t> indices;
+      for (auto i = first; i < last; i = events [i].mEnd)
+        indices.push_back (i);
+      return indices;
+    }
+
+    bool equalValues (EventTape::Value const& a, EventTape::Value const& b)
+    {
+      if (a.index () != b.index ())
+        return false;
+      // doubles are compared bitwise, so that e.g. NaNs and signed zeros are patched correctly
+      if (auto const* const aDouble = std::get_if<double> (&a))
+        return std::bit_cast<uint64_t> (*aDouble) == std::bit_cast<uint64_t> (std::get<double> (b));
+      return a == b;
+    }
+
+    bool writeChildren (std::string& out, Events const& baseline, std::size_t baseFirst, std::size_t baseLast,
+                        Events const& current, std::size_t curFirst, std::size_t curLast);
+
+    /// Writes the operation which transforms the entry `baseline [base]` into `current [cur]`.
+    void writeOperation (std::string& out, Events const& baseline, std::size_t base,
+                         Events const& current, std::size_t cur)
+    {
+      auto const& baseEvent = baseline [base];
+      auto const& curEvent = current [cur];
+      if (baseEvent.mKind == EventTape::Kind::Leaf && curEvent.mKind == EventTape::Kind::Leaf
+          && equalValues (baseEvent.mValue, curEvent.mValue))
+      {
+        writeByte (out, static_cast<uint8_t> (Operation::Keep));
+      }
+      else if (baseEvent.mKind == EventTape::Kind::Begin && curEvent.mKind == EventTape::Kind::Begin
+               && baseEvent.mType == curEvent.mType)
+      {
+        std::string childOperations;
+        if (writeChildren (childOperations, baseline, base + 1, baseEvent.mEnd - 1, current, cur + 1, curEvent.mEnd - 1))
+        {
+          writeByte (out, static_cast<uint8_t> (Operation::Descend));
+          out.append (childOperations);
+        }
+        else
+          writeByte (out, static_cast<uint8_t> (Operation::Keep));
+      }
+      else
+      {
+        writeByte (out, static_cast<uint8_t> (Operation::Replace));
+        writeEntry (out, current, cur);
+      }
+    }
+
+    /** Writes the new number of children, the number of changed children, the changed children
+      (each as distance to the previous change followed by its operation) and finally all appended children.
+      Returns `false` if no child was changed.*/
+    bool writeChildren (std::string& out, Events const& baseline, std::size_t baseFirst, std::size_t baseLast,
+                        Events const& current, std::size_t curFirst, std::size_t curLast)
+    {
+      auto const baseChildren = children (baseline, baseFirst, baseLast);
+      auto const curChildren = children (current, curFirst, curLast);
+      auto const common = std::min (baseChildren.size (), curChildren.size ());
+
+      std::string changes;
+      std::string operation;
+      std::size_t changeCount = 0;
+      std::size_t expected = 0;
+      for (std::size_t i = 0; i < common; ++i)
+      {
+        operation.clear ();
+        writeOperation (operation, baseline, baseChildren [i], current, curChildren [i]);
+        if (static_cast<Operation> (operation.front ()) == Operation::Keep)
+          continue;
+
+        writeVarint (changes, i - expected);
+        changes.append (operation);
+        expected = i + 1;
+        ++changeCount;
+      }
+
+      writeVarint (out, curChildren.size ());
+      writeVarint (out, changeCount);
+      out.append (changes);
+      for (auto i = common; i < curChildren.size (); ++i)
+        writeEntry (out, current, curChildren [i]);
+
+      return changeCount > 0 || baseChildren.size () != curChildren.size ();
+    }
+
+    class PatchReader
+    {
+    public:
+      explicit PatchReader (std::string_view patch) : mIn {patch} {}
+
+      auto byte () -> uint8_t
+      {
+        if (mPosition >= mIn.size ())
+          throw ArchiveError {} << "Unexpected end of patch.";
+        return static_cast<uint8_t> (mIn [mPosition++]);
+      }
+
+      auto varint () -> uint64_t
+      {
+        auto const* const begin = reinterpret_cast<uint8_t const*> (mIn.data ());
+        uint64_t value;
+        auto const* const next = detail::decodeVarint (begin + mPosition, begin + mIn.size (), value);
+        if (next == nullptr)
+          throw ArchiveError {} << "Invalid varint in patch.";
+        mPosition = static_cast<std::size_t> (next - begin);
+        return value;
+      }
+
+      auto value () -> EventTape::Value
+      {
+        switch (static_cast<ValueTag> (byte ()))
+        {
+          case ValueTag::Bool: return byte () != 0;
+          case ValueTag::Int: return detail::zigZagDecode (varint ());
+          case ValueTag::UInt: return varint ();
+          case ValueTag::Double:
+          {
+            uint64_t bits;
+            std::memcpy (&bits, bytes (sizeof (bits)), sizeof (bits));
+            return std::bit_cast<double> (detail::littleEndian (bits));
+          }
+          case ValueTag::String:
+          {
+            auto const size = static_cast<std::size_t> (varint ());
+            return std::string (bytes (size), size);
+          }
+        }
+        throw ArchiveError {} << "Invalid value in patch.";
+      }
+
+      /// Reads an entry or value which was written by `writeEntry`.
+      void entry (EventTape& out)
+      {
+        std::size_t depth = 0;
+        do
+        {
+          switch (static_cast<EventTape::Kind> (byte ()))
+          {
+            case EventTape::Kind::Begin:
+              out.begin (static_cast<ContentType> (byte ()));
+              ++depth;
+              break;
+            case EventTape::Kind::End:
+              if (depth == 0)
+                throw ArchiveError {} << "Invalid entry in patch.";
+              out.end ();
+              --depth;
+              break;
+            case EventTape::Kind::Leaf:
+              out.leaf (value ());
+              break;
+            default:
+              throw ArchiveError {} << "Invalid entry in patch.";
+          }
+        } while (depth > 0);
+      }
+
+      bool done () const
+      {
+        return mPosition == mIn.size ();
+      }
+
+    private:
+      auto bytes (std::size_t count) -> char const*
+      {
+        if (mIn.size () - mPosition < count)
+          throw ArchiveError {} << "Unexpected end of patch.";
+        auto const* const data = mIn.data () + mPosition;
+        mPosition += count;
+        return data;
+      }
+
+    private:
+      std::string_view mIn;
+      std::size_t mPosition {0};
+    };
+
+    void applyChildren (EventTape& out, EventTape const& baseline, std::size_t first, std::size_t last,
+                        PatchReader& patch);
+
+    void applyOperation (EventTape& out, EventTape const& baseline, std::size_t base, PatchReader& patch)
+    {
+      auto const& event = baseline.events () [base];
+      switch (static_cast<Operation> (patch.byte ()))
+      {
+        case Operation::Keep:
+          out.append (baseline, base, event.mEnd);
+          break;
+
+        case Operation::Replace:
+          patch.entry (out);
+          break;
+
+        case Operation::Descend:
+          if (event.mKind != EventTape::Kind::Begin)
+            throw ArchiveError {} << "Patch does not match its baseline.";
+          out.begin (event.mType);
+          applyChildren (out, baseline, base + 1, event.mEnd - 1, patch);
+          out.end ();
+          break;
+
+        default:
+          throw ArchiveError {} << "Invalid operation in patch.";
+      }
+    }
+
+    void applyChildren (EventTape& out, EventTape const& baseline, std::size_t first, std::size_t last,
+                        PatchReader& patch)
+    {
+      auto const& events = baseline.events ();
+      auto const baseChildren = children (events, first, last);
+      auto const count = static_cast<std::size_t> (patch.varint ());
+      auto changeCount = patch.varint ();
+      auto nextChange = changeCount > 0 ? patch.varint () : 0;
+
+      auto const common = std::min (baseChildren.size (), count);
+      for (std::size_t i = 0; i < common; ++i)
+      {
+        if (changeCount > 0 && i == nextChange)
+        {
+          applyOperation (out, baseline, baseChildren [i], patch);
+          if (--changeCount > 0)
+            nextChange = i + 1 + patch.varint ();
+        }
+        else
+          out.append (baseline, baseChildren [i], events [baseChildren [i]].mEnd);
+      }
+
+      if (changeCount > 0)
+        throw ArchiveError {} << "Patch does not match its baseline.";
+
+      for (auto i = common; i < count; ++i)
+        patch.entry (out);
+    }
+  }
+
+  auto createPatch (EventTape const& baseline, EventTape const& current) -> std::string
+  {
+    auto const& baseEvents = baseline.events ();
+    auto const& curEvents = current.events ();
+
+    std::string patch;
+    writeChildren (patch, baseEvents, 0, baseEvents.size (), curEvents, 0, curEvents.size ());
+    return patch;
+  }
+
+  auto applyPatch (EventTape const& baseline, std::string_view patch) -> EventTape
+  {
+    EventTape out;
+    PatchReader reader {patch};
+    applyChildren (out, baseline, 0, baseline.events ().size (), reader);
+    if (!reader.done ())
+      throw ArchiveError {} << "Unexpected data at the end of patch.";
+    return out;
+  }
+
+
+  PatchWriter::PatchWriter (EventTape const& baseline)
+    : mBaseline {&baseline}
+  {
+    mLevels.push_back ({0, baseline.events ().size ()});
+  }
+
+  auto PatchWriter::patch () const -> std::string
+  {
+    if (mLevels.size () != 1 || mRawDepth > 0)
+      throw ArchiveError {} << "The patch is only done once all entries are done.";
+
+    // The same layout as `writeChildren`.
+    auto const& level = mLevels.front ();
+    std::string out;
+    writeVarint (out, level.mCount);
+    writeVarint (out, level.mChangeCount);
+    return out.append (level.mChanges).append (level.mAppended);
+  }
+
+  bool PatchWriter::begin_entry (const char*, ContentType type, Hint)
+  {
+    if (mRawDepth == 0)
+    {
+      auto& level = mLevels.back ();
+      auto const* const base = next_child (level);
+      if (base == nullptr)
+        mRaw = &level.mAppended;
+      else if (base->mKind == EventTape::Kind::Begin && base->mType == type)
+      {
+        auto const first = static_cast<std::size_t> (base - mBaseline->events ().data ()) + 1;
+        mLevels.push_back ({first, base->mEnd - 1});
+        return true;
+      }
+      else
+      {
+        mRaw = &begin_change (level);
+        writeByte (*mRaw, static_cast<uint8_t> (Operation::Replace));
+      }
+    }
+
+    ++mRawDepth;
+    writeByte (*mRaw, static_cast<uint8_t> (EventTape::Kind::Begin));
+    writeByte (*mRaw, static_cast<uint8_t> (type));
+    return true;
+  }
+
+  void PatchWriter::end_entry (const char*, ContentType)
+  {
+    if (mRawDepth > 0)
+    {
+      --mRawDepth;
+      writeByte (*mRaw, static_cast<uint8_t> (EventTape::Kind::End));
+      return;
+    }
+    if (mLevels.size () == 1)
+      throw ArchiveError {} << "`end_entry` called without corresponding `begin_entry`.";
+
+    // Unchanged entries are kept, see `writeOperation`.
+    auto const level = std::move (mLevels.back ());
+    mLevels.pop_back ();
+    if (level.mChangeCount == 0 && level.mBaseNext == level.mBaseLast && level.mAppended.empty ())
+      return;
+
+    auto& out = begin_change (mLevels.back ());
+    writeByte (out, static_cast<uint8_t> (Operation::Descend));
+    writeVarint (out, level.mCount);
+    writeVarint (out, level.mChangeCount);
+    out.append (level.mChanges).append (level.mAppended);
+  }
+
+  void PatchWriter::leaf (EventTape::Value const& value)
+  {
+    if (mRawDepth > 0)
+      return writeLeaf (*mRaw, value);
+
+    auto& level = mLevels.back ();
+    auto const* const base = next_child (level);
+    if (base == nullptr)
+      writeLeaf (level.mAppended, value);
+    else if (base->mKind != EventTape::Kind::Leaf || !equalValues (base->mValue, value))
+    {
+      auto& out = begin_change (level);
+      writeByte (out, static_cast<uint8_t> (Operation::Replace));
+      writeLeaf (out, value);
+    }
+  }
+
+  auto PatchWriter::next_child (Level& level) const -> EventTape::Event const*
+  {
+    ++level.mCount;
+    if (level.mBaseNext == level.mBaseLast)
+      return nullptr;
+
+    auto const* const base = &mBaseline->events () [level.mBaseNext];
+    level.mBaseNext = base->mEnd;
+    return base;
+  }
+
+  auto PatchWriter::begin_change (Level& level) const -> std::string&
+  {
+    auto const index = level.mCount - 1;
+    writeVarint (level.mChanges, index - level.mExpected);
+    level.mExpected = index + 1;
+    ++level.mChangeCount;
+    return level.mChanges;
+  }
+
+  void PatchWriter::write_type_name (std::string const& typeName)
+  {leaf (typeName);}
+
+  void PatchWriter::write_type_version (Version const& version)
+  {leaf (version.toString ());}
+
+  void PatchWriter::write (const char*, bool value)
+  {leaf (value);}
+
+  void PatchWriter::write (const char*, double value)
+  {leaf (value);}
+
+  void PatchWriter::write (const char*, std::string const& value)
+  {leaf (value);}
+
+  void PatchWriter::write (const char*, char value)
+  {leaf (static_cast<int64_t> (value));}
+
+  void PatchWriter::write (const char*, unsigned char value)
+  {leaf (static_cast<uint64_t> (value));}
+
+  void PatchWriter::write (const char*, int value)
+  {leaf (static_cast<int64_t> (value));}
+
+  void PatchWriter::write (const char*, long int value)
+  {leaf (static_cast<int64_t> (value));}
+
+  void PatchWriter::write (const char*, long long int value)
+  {leaf (static_cast<int64_t> (value));}
+
+  void PatchWriter::write (const char*, unsigned int value)
+  {leaf (static_cast<uint64_t> (value));}
+
+  void PatchWriter::write (const char*, unsigned long int value)
+  {leaf (static_cast<uint64_t> (value));}
+
+  void PatchWriter::write (const char*, unsigned long long int value)
+  {leaf (static_cast<uint64_t> (value));}
+}// end of namespace moose
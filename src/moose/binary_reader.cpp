@@ -23,42 +23,187 @@
 // THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <moose/binary_reader.h>
 #include <moose/exceptions.h>
+#include <moose/packed_bits.h>
+#include <moose/detail/binary_encoding.h>
+#include <moose/detail/byte_order.h>
+#include <moose/detail/codecs.h>
 #include <moose/detail/forward_if_not_nullptr.h>
+#include <moose/detail/varint.h>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <fstream>
+#include <utility>
 
 namespace moose
 {
-  auto BinaryReader::fromFile (const char* filename) -> std::shared_ptr<BinaryReader>
+  struct BinaryReader::EncodedValues
+  {
+    detail::ArrayMarker mMarker;
+    std::size_t mSize;
+    /// The encoded block, which refers to `mStorage` unless the data is read from memory.
+    uint8_t const* mBegin {nullptr};
+    uint8_t const* mEnd {nullptr};
+    std::vector<uint8_t> mStorage {};
+    /// All values, once they were needed one by one.
+    std::vector<detail::CodecBits> mBits {};
+    bool mFloatingPoint {false};
+
+    template <class T>
+    void decode (std::span<T> out)
+    {
+      if (!detail::decodeWithCodec (mMarker, mBegin, mEnd, out, mFloatingPoint))
+        throw ArchiveError {} << "Invalid encoded array encountered.";
+    }
+
+    auto bits () -> std::vector<detail::CodecBits> const&
+    {
+      if (mBits.size () != mSize)
+      {
+        mBits.resize (mSize);
+        decode (std::span {mBits});
+      }
+      return mBits;
+    }
+  };
+
+  auto BinaryReader::fromFile (const char* filename, BinaryOptions options) -> std::shared_ptr<BinaryReader>
   {
     auto in = std::make_shared<std::ifstream> (filename, std::ios::binary);
     if (!(*in))
       throw ArchiveError () << "File not found: " << filename;
-    return std::make_shared<BinaryReader> (std::move (in));
+    return std::make_shared<BinaryReader> (std::move (in), options);
   }
 
-  BinaryReader::BinaryReader (std::istream& in)
+  BinaryReader::BinaryReader (std::istream& in, BinaryOptions options)
     : mIn {&in}
+    , mOptions {options}
   {
-    mEntries.emplace (ContentType::Struct, false);
+    initialize ();
   }
 
-  BinaryReader::BinaryReader (std::shared_ptr<std::istream> in)
+  BinaryReader::BinaryReader (std::shared_ptr<std::istream> in, BinaryOptions options)
     : mStreamStorage {detail::forwardIfNotNullptr<ArchiveError> (std::move (in), "Invalid stream provided")}
     , mIn {mStreamStorage.get ()}
+    , mOptions {options}
+  {
+    initialize ();
+  }
+
+  BinaryReader::BinaryReader (std::span<std::byte const> data, BinaryOptions options)
+    : mIn {nullptr}
+    , mOptions {options}
+    , mData {data}
+  {
+    initialize ();
+  }
+
+  BinaryReader::BinaryReader (std::shared_ptr<std::vector<std::byte> const> data, BinaryOptions options)
+    : mIn {nullptr}
+    , mOptions {options}
+    , mDataStorage {detail::forwardIfNotNullptr<ArchiveError> (std::move (data), "Invalid data provided")}
+    , mData {*mDataStorage}
+  {
+    initialize ();
+  }
+
+  auto BinaryReader::format () const -> Format
   {
-    mEntries.emplace (ContentType::Struct, false);
+    return Format::Binary;
   }
 
-  bool BinaryReader::begin_entry (const char*, ContentType type)
+  auto BinaryReader::schema_fingerprint () const -> uint64_t
   {
+    return mOptions.schema;
+  }
+
+  auto BinaryReader::index () const -> BinaryIndex const&
+  {
+    if (!mOptions.index)
+      throw ArchiveError {} << "Binary data without index can not be accessed randomly.";
+    return mIndex;
+  }
+
+  bool BinaryReader::seek_entry (const char* name)
+  {
+    auto const* const entry = index ().find (name);
+    if (!entry)
+      return false;
+
+    reset (entry->offset);
+    if (mOptions.tagged)
+      current ().mCursor = tell ();
+    return true;
+  }
+
+  auto BinaryReader::seek_element (const char* name, std::size_t element) -> std::size_t
+  {
+    auto const* const entry = index ().find (name);
+    if (!entry || entry->type != ContentType::Array)
+      throw ArchiveError {} << "Array '" << name << "' not found in index.";
+    if (entry->elementOffsets.empty ())
+      throw ArchiveError {} << "Positions of the elements of array '" << name << "' were not stored.";
+    if (element >= entry->elementCount)
+      throw ArchiveError {} << "Array '" << name << "' has no element " << element << ".";
+
+    auto const block = std::min (element / mIndex.stride, entry->elementOffsets.size () - 1);
+    auto const first = block * mIndex.stride;
+    reset (entry->elementOffsets [block]);
+    mEntries.push ({ContentType::Array, !entry->sized, entry->sized, entry->elementCount - first});
+    return element - first;
+  }
+
+  bool BinaryReader::begin_entry (const char* name, ContentType type)
+  {
+    if (current ().mRawLayout)
+      throw ArchiveError {} << "Arrays of trivially copyable types have to be read as a whole.";
+
+    std::optional<std::streampos> end;
+    if (mOptions.tagged)
+    {
+      if (current ().mType == ContentType::Struct)
+      {
+        end = findMember (name);
+        if (!end)
+          return false;
+      }
+      else if (type == ContentType::Struct)
+      {
+        auto const length = static_cast<std::streamoff> (read_varint ());
+        end = tell () + length;
+      }
+    }
+
+    if (mColumnar && mEntries.size () == mColumnar->mDepth)
+    {
+      // a new element of a columnar array starts
+      mColumnar->mNextColumn = 0;
+      mColumnar->mCurrent = nullptr;
+    }
+
     if (type == ContentType::Array)
     {
-      mEntries.emplace (type, readArrayHasNext ());
+      begin_value (mEntries.size () + 1);
+      mEntries.push (readArrayHeader ());
+      mEntries.top ().mEnd = end;
       return true;
     }
 
-    mEntries.emplace (type, false);
+    Entry entry {type};
+    if (type == ContentType::Struct && mOptions.dedupThreshold > 0)
+      entry.mReturnPosition = readStructTag ();
+
+    entry.mEnd = end;
+    if (type == ContentType::Struct && mOptions.tagged)
+      entry.mMembersBegin = entry.mCursor = tell ();
+
+    if (auto const& parent = current (); parent.mEncoded)
+    {
+      entry.mEncoded = parent.mEncoded;
+      entry.mEncodedIndex = parent.mEncoded->mSize - parent.mRemaining;
+    }
+    mEntries.push (std::move (entry));
     return true;
   }
 
@@ -67,52 +212,258 @@ namespace moose
     if (mEntries.empty ())
       throw ArchiveError {} << "`end_entry` called without corresponding `begin_entry`.";
 
+    if (auto const returnPosition = mEntries.top ().mReturnPosition)
+      seek (*returnPosition);
+    else if (auto const end = mEntries.top ().mEnd; end && tell () != *end)
+      seek (*end); // skip the members which were not read
+
     mEntries.pop ();
     if (mEntries.empty ())
       throw ArchiveError {} << "`end_entry` called without corresponding `begin_entry`.";
 
+    if (mColumnar)
+    {
+      if (mEntries.size () < mColumnar->mDepth)
+        mColumnar.reset (); // the columnar array is done
+      else if (mEntries.size () == mColumnar->mDepth)
+      {
+        if (mColumnar->mNextColumn != mColumnar->mColumns.size ())
+          throw ArchiveError {} << "Element of columnar array does not match the stored columns.";
+        mColumnar->mCurrent = nullptr;
+      }
+    }
+
     auto& top = mEntries.top ();
     if (top.mType == ContentType::Array)
-      top.mArrayHasNext = readArrayHasNext ();
+    {
+      if (top.mSized)
+      {
+        if (top.mRemaining == 0)
+          throw ArchiveError {} << "Too many entries read from array.";
+        --top.mRemaining;
+        top.mPackedBytes = 0;
+      }
+      else
+        top.mArrayHasNext = readArrayHasNext ();
+    }
   }
 
   bool BinaryReader::array_has_next (const char*) const
   {
-    return current ().mArrayHasNext;
+    auto const& entry = current ();
+    if (entry.mSized)
+      return entry.mRemaining > 0;
+    return entry.mArrayHasNext;
+  }
+
+  auto BinaryReader::array_size (const char*) const -> std::optional<std::size_t>
+  {
+    auto const& entry = current ();
+    if (!entry.mSized)
+      return std::nullopt;
+
+    // Unless they are stored in a codec block, whose size was checked already, numbers and raw values take
+    // at least one byte each, so larger sizes stem from corrupt data. Streams are not checked, see `Reader::array_size`.
+    if (auto const remaining = remaining_bytes (); remaining && !entry.mEncoded && entry.mRemaining > *remaining)
+      throw ArchiveError {} << "Invalid array size in binary data.";
+    return entry.mRemaining;
   }
 
   auto BinaryReader::type_name () const -> std::string
   {
     std::string name;
-    read ("", name);
+    if (!mOptions.tagged)
+      read ("", name);
+    else
+    {
+      auto& self = const_cast<BinaryReader&> (*this);
+      if (!self.begin_entry ("@type", ContentType::Value))
+        return name;
+      read ("", name);
+      self.end_entry ("@type", ContentType::Value);
+    }
     return name;
   }
 
   auto BinaryReader::type_version () const -> Version
   {
     std::string version;
-    read ("", version);
+    if (!mOptions.tagged)
+      read ("", version);
+    else
+    {
+      auto& self = const_cast<BinaryReader&> (*this);
+      if (!self.begin_entry ("@version", ContentType::Value))
+        return {};
+      read ("", version);
+      self.end_entry ("@version", ContentType::Value);
+    }
     return Version::fromString (version);
   }
 
   void BinaryReader::read (const char*, bool& value) const
   {
+    begin_value (mEntries.size ());
     char charValue;
-    in ().read (&charValue, 1);
+    read_bytes (&charValue, 1);
     value = charValue != 0;
   }
 
   void BinaryReader::read (const char*, double& value) const
   {
-    in ().read (reinterpret_cast<char*> (&value), sizeof (double));
+    begin_value (mEntries.size ());
+    read_number (value);
   }
 
   void BinaryReader::read (const char*, std::string& value) const
   {
-    uint32_t size;
-    in ().read (reinterpret_cast<char*> (&size), sizeof (uint32_t));
+    begin_value (mEntries.size ());
+    auto const size = read_size<uint32_t> ();
     value.resize (size);
-    in ().read (value.data (), size);
+    read_bytes (value.data (), size);
+  }
+
+  void BinaryReader::read (const char*, PackedBits& value) const
+  {
+    begin_value (mEntries.size ());
+    value.size = read_size<uint64_t> ();
+    auto const bytes = (value.size + 7) / 8;
+    if (auto const remaining = remaining_bytes (); remaining && bytes > *remaining)
+      throw ArchiveError {} << "Invalid size of packed bits in binary data.";
+
+    // Streamed words are read in chunks, so that a corrupt size fails at the end of the data.
+    constexpr std::size_t chunk = detail::readChunkBytes / sizeof (uint64_t);
+    value.words.clear ();
+    for (std::size_t begin = 0; begin * sizeof (uint64_t) < bytes; begin += chunk)
+    {
+      auto const count = std::min (chunk, PackedBits::wordCount (value.size) - begin);
+      value.words.resize (begin + count, 0);
+      read_bytes (value.words.data () + begin, std::min (count * sizeof (uint64_t), bytes - begin * sizeof (uint64_t)));
+    }
+    for (auto& word : value.words)
+      word = detail::littleEndian (word);
+
+    if (auto const unused = value.words.size () * PackedBits::wordBits - value.size; unused > 0)
+      value.words.back () &= ~uint64_t {0} >> unused;
+  }
+
+  void BinaryReader::read (const char*, char& value) const
+  {
+    begin_value (mEntries.size ());
+    read_number (value);
+  }
+
+  void BinaryReader::read (const char*, unsigned char& value) const
+  {
+    begin_value (mEntries.size ());
+    read_number (value);
+  }
+
+  void BinaryReader::read (const char*, int& value) const
+  {
+    begin_value (mEntries.size ());
+    read_number (value);
+  }
+
+  void BinaryReader::read (const char*, long int& value) const
+  {
+    begin_value (mEntries.size ());
+    read_number (value);
+  }
+
+  void BinaryReader::read (const char*, long long int& value) const
+  {
+    begin_value (mEntries.size ());
+    read_number (value);
+  }
+
+  void BinaryReader::read (const char*, unsigned int& value) const
+  {
+    begin_value (mEntries.size ());
+    read_number (value);
+  }
+
+  void BinaryReader::read (const char*, unsigned long int& value) const
+  {
+    begin_value (mEntries.size ());
+    read_number (value);
+  }
+
+  void BinaryReader::read (const char*, unsigned long long int& value) const
+  {
+    begin_value (mEntries.size ());
+    read_number (value);
+  }
+
+  void BinaryReader::read_array (const char* name, std::span<char> values)
+  {read_numbers (name, values);}
+
+  void BinaryReader::read_array (const char* name, std::span<unsigned char> values)
+  {read_numbers (name, values);}
+
+  void BinaryReader::read_array (const char* name, std::span<int> values)
+  {read_numbers (name, values);}
+
+  void BinaryReader::read_array (const char* name, std::span<long int> values)
+  {read_numbers (name, values);}
+
+  void BinaryReader::read_array (const char* name, std::span<long long int> values)
+  {read_numbers (name, values);}
+
+  void BinaryReader::read_array (const char* name, std::span<unsigned int> values)
+  {read_numbers (name, values);}
+
+  void BinaryReader::read_array (const char* name, std::span<unsigned long int> values)
+  {read_numbers (name, values);}
+
+  void BinaryReader::read_array (const char* name, std::span<unsigned long long int> values)
+  {read_numbers (name, values);}
+
+  void BinaryReader::read_array (const char* name, std::span<float> values)
+  {read_numbers (name, values);}
+
+  void BinaryReader::read_array (const char* name, std::span<double> values)
+  {read_numbers (name, values);}
+
+  bool BinaryReader::read_raw (const char* name, RawLayout const& layout, void* data, std::size_t count)
+  {
+    auto& entry = current ();
+    auto const throwOnMismatch = [name, &layout] (RawLayout const& stored)
+    {
+      if (stored != layout)
+      {
+        throw ArchiveError {} << "Incompatible layout of trivially copyable type in entry '" << name
+          << "'. Stored: size " << stored.size << ", alignment " << stored.alignment << ", " << stored.fieldCount
+          << " fields. Expected: size " << layout.size << ", alignment " << layout.alignment << ", "
+          << layout.fieldCount << " fields.";
+      }
+    };
+
+    if (entry.mType == ContentType::Array)
+    {
+      if (!entry.mRawLayout)
+        return false;
+
+      throwOnMismatch (*entry.mRawLayout);
+      if (count > entry.mRemaining)
+        throw ArchiveError () << "Too few entries while reading range '" << name << "'";
+
+      read_bytes (data, static_cast<std::size_t> (layout.size) * count);
+      entry.mRemaining -= count;
+      return true;
+    }
+
+    if (mOptions.tagged)
+      return false; // structs are stored member by member
+    if (mSwapBytes)
+      return false; // the bytes of each value are swapped
+    if (mOptions.integerEncoding == IntegerEncoding::Legacy)
+      return false; // the values are widened to double
+
+    begin_value (mEntries.size ());
+    throwOnMismatch (readLayout ());
+    read_bytes (data, static_cast<std::size_t> (layout.size) * count);
+    return true;
   }
 
   auto BinaryReader::current () -> Entry&
@@ -127,10 +478,320 @@ namespace moose
     return mEntries.top ();
   }
 
+  auto BinaryReader::readArrayHeader () -> Entry
+  {
+    char marker;
+    read_bytes (&marker, 1);
+
+    switch (static_cast<detail::ArrayMarker> (marker))
+    {
+      case detail::ArrayMarker::End:
+        return {ContentType::Array, false};
+
+      case detail::ArrayMarker::Element:
+        return {ContentType::Array, true};
+
+      case detail::ArrayMarker::Sized:
+      {
+        auto const size = read_size<uint64_t> ();
+        return {ContentType::Array, false, true, size};
+      }
+
+      case detail::ArrayMarker::PackedVarints:
+      {
+        auto const size = read_size<uint64_t> ();
+        auto const packedBytes = read_size<uint64_t> ();
+        return {ContentType::Array, false, true, size, packedBytes};
+      }
+
+      case detail::ArrayMarker::Raw:
+      {
+        auto const layout = readLayout ();
+        auto const size = read_size<uint64_t> ();
+        return {ContentType::Array, false, true, size, 0, layout};
+      }
+
+      case detail::ArrayMarker::Columnar:
+      {
+        auto const size = read_size<uint64_t> ();
+        readColumns ();
+        return {ContentType::Array, false, true, size};
+      }
+
+      case detail::ArrayMarker::Delta:
+      case detail::ArrayMarker::XorFloat:
+      case detail::ArrayMarker::RunLength:
+      case detail::ArrayMarker::Float32:
+      case detail::ArrayMarker::Float16:
+      case detail::ArrayMarker::Quantized16:
+      {
+        auto const size = read_size<uint64_t> ();
+        auto const blockSize = read_size<uint64_t> ();
+        auto const* const block = read_block (blockSize);
+        auto const codec = static_cast<detail::ArrayMarker> (marker);
+        if (!detail::codecBlockFits (codec, block, block + blockSize, size))
+          throw ArchiveError {} << "Invalid encoded array encountered.";
+
+        auto encoded = std::make_shared<EncodedValues> (EncodedValues {codec, size});
+        if (from_memory ())
+          encoded->mBegin = block;
+        else
+        {
+          encoded->mStorage.assign (block, block + blockSize);
+          encoded->mBegin = encoded->mStorage.data ();
+        }
+        encoded->mEnd = encoded->mBegin + blockSize;
+
+        Entry entry {ContentType::Array, false, true, size};
+        entry.mEncoded = std::move (encoded);
+        return entry;
+      }
+
+      case detail::ArrayMarker::Reference:
+      {
+        if (mOptions.dedupThreshold == 0)
+          break;
+
+        auto const returnPosition = followReference ();
+        auto entry = readArrayHeader ();
+        entry.mReturnPosition = returnPosition;
+        return entry;
+      }
+    }
+
+    throw ArchiveError {} << "Invalid array marker '" << static_cast<int> (marker) << "' encountered.";
+  }
+
+  void BinaryReader::initialize ()
+  {
+    mOrigin = tell ();
+    auto const expectedSchema = std::exchange (mOptions.schema, 0);
+    if (mOptions.header)
+    {
+      std::array<uint8_t, detail::headerSize> header;
+      read_bytes (header.data (), header.size ());
+      if (detail::decodeHeader (header, mOptions))
+      {
+        std::array<uint8_t, detail::schemaSize> schema;
+        read_bytes (schema.data (), schema.size ());
+        mOptions.schema = detail::decodeSchema (schema);
+        if (expectedSchema != 0 && !mOptions.tagged && mOptions.schema != expectedSchema)
+          throw ArchiveError {} << "Binary data was written with a different schema.";
+      }
+    }
+    detail::checkBinaryOptions (mOptions);
+    mSwapBytes = detail::swapsBytes (mOptions);
+
+    mBegin = tell ();
+    mEntries.push ({ContentType::Struct});
+    if (mOptions.tagged)
+      mEntries.top ().mMembersBegin = mEntries.top ().mCursor = mBegin;
+    if (mOptions.index)
+      readIndex ();
+  }
+
+  void BinaryReader::readIndex ()
+  {
+    auto const fail = [] {return ArchiveError {} << "Binary data has no valid index. Indexed data requires a seekable stream.";};
+
+    auto const end = data_end ();
+    if (end == std::streampos (-1) || mOrigin == std::streampos (-1)
+        || end - mOrigin < static_cast<std::streamoff> (detail::indexTrailerSize))
+    {
+      throw fail ();
+    }
+
+    uint8_t trailer [detail::indexTrailerSize];
+    seek (end - static_cast<std::streamoff> (detail::indexTrailerSize));
+    read_bytes (trailer, detail::indexTrailerSize);
+    if (!std::equal (trailer + 8, trailer + detail::indexTrailerSize, detail::indexMagic))
+      throw fail ();
+
+    uint64_t position = 0;
+    for (int i = 0; i < 8; ++i)
+      position |= static_cast<uint64_t> (trailer [i]) << (8 * i);
+
+    auto const indexEnd = end - static_cast<std::streamoff> (detail::indexTrailerSize);
+    if (position > static_cast<uint64_t> (indexEnd - mOrigin))
+      throw fail ();
+
+    mDataEnd = mOrigin + static_cast<std::streamoff> (position);
+    auto const indexSize = static_cast<std::size_t> (indexEnd - *mDataEnd);
+    seek (*mDataEnd);
+    auto const* const index = read_block (indexSize);
+    mIndex = detail::decodeIndex (index, index + indexSize);
+
+    mEntries.top ().mEnd = mDataEnd;
+    seek (mBegin);
+  }
+
+  void BinaryReader::reset (std::size_t offset)
+  {
+    mEntries = {};
+    mColumnar.reset ();
+
+    Entry root {ContentType::Struct};
+    root.mEnd = mDataEnd;
+    root.mMembersBegin = root.mCursor = mBegin;
+    mEntries.push (std::move (root));
+
+    seek (mOrigin + static_cast<std::streamoff> (offset));
+  }
+
+  auto BinaryReader::readStructTag () -> std::optional<std::streampos>
+  {
+    char tag;
+    read_bytes (&tag, 1);
+    if (tag == static_cast<char> (detail::SubtreeTag::Inline))
+      return std::nullopt;
+    if (tag != static_cast<char> (detail::SubtreeTag::Reference))
+      throw ArchiveError {} << "Invalid struct tag '" << static_cast<int> (tag) << "' encountered.";
+
+    auto const returnPosition = followReference ();
+    read_bytes (&tag, 1);
+    if (tag != static_cast<char> (detail::SubtreeTag::Inline))
+      throw ArchiveError {} << "Invalid struct reference encountered.";
+    return returnPosition;
+  }
+
+  auto BinaryReader::findMember (const char* name) -> std::optional<std::streampos>
+  {
+    auto& parent = current ();
+    auto const id = detail::fieldId (name);
+
+    // Members are usually read in the order in which they were written. The search thus starts
+    // behind the previously read member and wraps around at the end of the struct.
+    auto position = parent.mCursor;
+    bool wrapped = false;
+    while (true)
+    {
+      if (atMembersEnd (parent, position))
+      {
+        if (wrapped || parent.mCursor == parent.mMembersBegin)
+          break;
+        wrapped = true;
+        position = parent.mMembersBegin;
+      }
+      if (wrapped && position == parent.mCursor)
+        break;
+
+      if (tell () != position)
+        seek (position);
+
+      uint8_t bytes [4];
+      read_bytes (bytes, 4);
+      auto const length = static_cast<std::streamoff> (read_varint ());
+      auto const end = tell () + length;
+
+      uint32_t const storedId = bytes [0] | (bytes [1] << 8) | (bytes [2] << 16) | (static_cast<uint32_t> (bytes [3]) << 24);
+      if (storedId == id)
+      {
+        parent.mCursor = end;
+        return end;
+      }
+      position = end;
+    }
+
+    seek (parent.mCursor);
+    return std::nullopt;
+  }
+
+  bool BinaryReader::atMembersEnd (Entry const& entry, std::streampos position) const
+  {
+    if (entry.mEnd)
+      return position >= *entry.mEnd;
+
+    // The outermost struct ends with the data.
+    if (mIn == nullptr)
+      return position >= data_end ();
+    if (tell () != position)
+      seek (position);
+    if (in ().peek () != std::char_traits<char>::eof ())
+      return false;
+    in ().clear ();
+    return true;
+  }
+
+  auto BinaryReader::followReference () -> std::streampos
+  {
+    auto const offset = static_cast<std::streamoff> (read_varint ());
+    auto const returnPosition = tell ();
+    if (returnPosition == std::streampos (-1) || offset >= returnPosition - mOrigin)
+      throw ArchiveError {} << "Invalid reference in binary data. Deduplicated data requires a seekable stream.";
+
+    seek (mOrigin + offset);
+    return returnPosition;
+  }
+
+  auto BinaryReader::readLayout () const -> RawLayout
+  {
+    auto const readVarint = [this]
+    {
+      auto const value = read_varint ();
+      if (value > UINT32_MAX)
+        throw ArchiveError {} << "Invalid layout of trivially copyable type encountered.";
+      return static_cast<uint32_t> (value);
+    };
+
+    RawLayout layout;
+    layout.size = readVarint ();
+    layout.alignment = readVarint ();
+    layout.fieldCount = readVarint ();
+    return layout;
+  }
+
+  void BinaryReader::readColumns ()
+  {
+    if (mColumnar)
+      throw ArchiveError {} << "Nested columnar arrays are not supported.";
+
+    // the columnar array is pushed onto the entry stack directly after its header was read.
+    Columns columns {mEntries.size () + 1, {}, {}};
+
+    // Sizes are checked against the data before storage is allocated for them. Streamed bytes are read
+    // in chunks, so that a corrupt size fails at the end of the data.
+    auto const readSize = [this]
+    {
+      auto const size = read_size<uint64_t> ();
+      if (auto const remaining = remaining_bytes (); remaining && size > *remaining)
+        throw ArchiveError {} << "Invalid columnar array in binary data.";
+      return static_cast<std::size_t> (size);
+    };
+    auto const readBytes = [this, &readSize] (auto& bytes)
+    {
+      auto const size = readSize ();
+      for (std::size_t begin = 0; begin < size; begin += detail::readChunkBytes)
+      {
+        auto const count = std::min (detail::readChunkBytes, size - begin);
+        bytes.resize (begin + count);
+        read_bytes (bytes.data () + begin, count);
+      }
+    };
+
+    readBytes (columns.mShape);
+
+    // Each column takes at least the byte of its size.
+    for (auto count = readSize (); count > 0; --count)
+      readBytes (columns.mColumns.emplace_back ().mBytes);
+
+    mColumnar = std::move (columns);
+  }
+
+  void BinaryReader::begin_value (std::size_t depth) const
+  {
+    if (!mColumnar || depth <= mColumnar->mDepth)
+      return;
+
+    auto& columns = *mColumnar;
+    if (columns.mNextColumn >= columns.mColumns.size ())
+      throw ArchiveError {} << "Element of columnar array does not match the stored columns.";
+    columns.mCurrent = &columns.mColumns [columns.mNextColumn++];
+  }
+
   bool BinaryReader::readArrayHasNext ()
   {
     char hasNext;
-    in ().read (&hasNext, 1);
+    read_bytes (&hasNext, 1);
     return hasNext != 0;
   }
 
@@ -138,4 +799,232 @@ namespace moose
   {
     return *mIn;
   }
+
+  bool BinaryReader::from_memory () const
+  {
+    return mIn == nullptr && !(mColumnar && mColumnar->mCurrent);
+  }
+
+  auto BinaryReader::tell () const -> std::streampos
+  {
+    if (mIn == nullptr)
+      return static_cast<std::streamoff> (mPosition);
+    return in ().tellg ();
+  }
+
+  void BinaryReader::seek (std::streampos position) const
+  {
+    if (mIn == nullptr)
+    {
+      auto const offset = static_cast<std::streamoff> (position);
+      if (offset < 0 || static_cast<std::size_t> (offset) > mData.size ())
+        throw ArchiveError {} << "Invalid position in binary data.";
+      mPosition = static_cast<std::size_t> (offset);
+      return;
+    }
+
+    in ().clear ();
+    in ().seekg (position);
+  }
+
+  auto BinaryReader::data_end () const -> std::streampos
+  {
+    if (mIn == nullptr)
+      return static_cast<std::streamoff> (mData.size ());
+
+    in ().seekg (0, std::ios::end);
+    return in ().tellg ();
+  }
+
+  auto BinaryReader::remaining_bytes () const -> std::optional<std::size_t>
+  {
+    if (mColumnar && mColumnar->mCurrent)
+      return mColumnar->mCurrent->mBytes.size () - mColumnar->mCurrent->mPosition;
+    if (mIn == nullptr)
+      return mData.size () - mPosition;
+    return std::nullopt;
+  }
+
+  void BinaryReader::read_bytes (void* data, std::size_t size) const
+  {
+    if (mColumnar && mColumnar->mCurrent)
+    {
+      auto& column = *mColumnar->mCurrent;
+      if (column.mBytes.size () - column.mPosition < size)
+        throw ArchiveError {} << "Unexpected end of column in columnar array.";
+      std::memcpy (data, column.mBytes.data () + column.mPosition, size);
+      column.mPosition += size;
+      return;
+    }
+
+    if (mIn == nullptr)
+    {
+      if (mData.size () - mPosition < size)
+        throw ArchiveError {} << "Unexpected end of binary data.";
+      std::memcpy (data, mData.data () + mPosition, size);
+      mPosition += size;
+      return;
+    }
+
+    in ().read (static_cast<char*> (data), static_cast<std::streamsize> (size));
+    if (static_cast<std::size_t> (in ().gcount ()) != size)
+      throw ArchiveError {} << "Unexpected end of binary data.";
+  }
+
+  auto BinaryReader::read_block (std::size_t size) -> uint8_t const*
+  {
+    if (from_memory ())
+    {
+      if (mData.size () - mPosition < size)
+        throw ArchiveError {} << "Unexpected end of binary data.";
+      auto const* const block = reinterpret_cast<uint8_t const*> (mData.data ()) + mPosition;
+      mPosition += size;
+      return block;
+    }
+
+    mScratch.resize (size);
+    read_bytes (mScratch.data (), size);
+    return mScratch.data ();
+  }
+
+  auto BinaryReader::read_varint () const -> uint64_t
+  {
+    if (from_memory ())
+    {
+      auto const* const begin = reinterpret_cast<uint8_t const*> (mData.data ());
+      uint64_t value;
+      auto const* const next = detail::decodeVarint (begin + mPosition, begin + mData.size (), value);
+      if (next == nullptr)
+        throw ArchiveError {} << "Invalid varint encountered.";
+      mPosition = static_cast<std::size_t> (next - begin);
+      return value;
+    }
+
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+      uint8_t byte;
+      read_bytes (&byte, 1);
+      value |= static_cast<uint64_t> (byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+        return value;
+    }
+    throw ArchiveError {} << "Invalid varint encountered.";
+  }
+
+  template <class FIXED>
+  auto BinaryReader::read_size () const -> std::size_t
+  {
+    if (mOptions.integerEncoding == IntegerEncoding::Varint)
+      return static_cast<std::size_t> (read_varint ());
+
+    FIXED size;
+    read_bytes (&size, sizeof (FIXED));
+    if (mSwapBytes)
+      size = detail::byteSwap (size);
+    return static_cast<std::size_t> (size);
+  }
+
+  template <class T>
+  void BinaryReader::read_number (T& value) const
+  {
+    if (auto const& entry = current (); entry.mEncoded)
+    {
+      if (entry.mEncodedIndex >= entry.mEncoded->mSize)
+        throw ArchiveError () << "Too many entries read from array.";
+      auto const& bits = entry.mEncoded->bits ();
+      value = detail::fromCodecBits<T> (bits [entry.mEncodedIndex].mBits, entry.mEncoded->mFloatingPoint);
+      return;
+    }
+
+    if constexpr (!std::is_same_v<T, double>)
+    {
+      if (mOptions.integerEncoding == IntegerEncoding::Legacy)
+      {
+        double stored;
+        read_number (stored);
+        value = static_cast<T> (stored);
+        return;
+      }
+    }
+
+    if constexpr (detail::isVarintEncoded<T> ())
+    {
+      if (mOptions.integerEncoding == IntegerEncoding::Varint)
+      {
+        value = detail::fromVarint<T> (read_varint ());
+        return;
+      }
+    }
+
+    detail::BinaryStorageType<T> stored;
+    read_bytes (&stored, sizeof (stored));
+    if (mSwapBytes)
+      stored = detail::byteSwap (stored);
+    value = static_cast<T> (stored);
+  }
+
+  template <class T>
+  void BinaryReader::read_numbers (const char* name, std::span<T> values)
+  {
+    auto& entry = current ();
+    if (!entry.mSized)
+    {
+      Reader::read_array (name, values);
+      return;
+    }
+
+    if (values.size () > entry.mRemaining)
+      throw ArchiveError () << "Too few entries while reading range '" << name << "'";
+
+    if (entry.mEncoded)
+    {
+      // Whole arrays are decoded directly into their destination, without intermediate values.
+      auto& encoded = *entry.mEncoded;
+      auto const first = encoded.mSize - entry.mRemaining;
+      if (first == 0 && values.size () == encoded.mSize && encoded.mBits.empty ())
+        encoded.decode (values);
+      else
+      {
+        auto const& bits = encoded.bits ();
+        for (std::size_t i = 0; i < values.size (); ++i)
+          values [i] = detail::fromCodecBits<T> (bits [first + i].mBits, encoded.mFloatingPoint);
+      }
+      entry.mRemaining -= values.size ();
+      return;
+    }
+
+    if constexpr (detail::isVarintEncoded<T> ())
+    {
+      if (entry.mPackedBytes > 0 && values.size () == entry.mRemaining)
+      {
+        auto const* const block = read_block (entry.mPackedBytes);
+        auto const* const end = block + entry.mPackedBytes;
+        if (detail::decodeVarints (block, end, values.data (), values.size ()) != end)
+          throw ArchiveError () << "Invalid varints encountered while reading range '" << name << "'";
+
+        entry.mRemaining = 0;
+        entry.mPackedBytes = 0;
+        return;
+      }
+    }
+
+    bool const fixedWidth = mOptions.integerEncoding == IntegerEncoding::Legacy
+                          ? std::is_same_v<T, double>
+                          : !detail::isVarintEncoded<T> () || mOptions.integerEncoding == IntegerEncoding::Fixed;
+    if (detail::hasBinaryLayout<T> () && fixedWidth)
+    {
+      read_bytes (values.data (), values.size_bytes ());
+      if (mSwapBytes)
+        detail::byteSwapArray<sizeof (T)> (values.data (), values.size ());
+    }
+    else
+    {
+      for (auto& value : values)
+        read_number (value);
+    }
+
+    entry.mRemaining -= values.size ();
+    entry.mPackedBytes = 0;
+  }
 }// end of namespace moose
@@ -0,0 +1,120 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <moose/encoding_cache.h>
+
+#include <functional>
+
+namespace moose
+{
+  EncodingCache::EncodingCache (std::size_t maxBytes)
+    : mMaxBytes {maxBytes}
+  {}
+
+  auto EncodingCache::find (CacheKey const& key) -> std::vector<uint8_t> const*
+  {
+    auto const iter = mIndex.find (key);
+    if (iter == mIndex.end ())
+    {
+      ++mStatistics.misses;
+      return nullptr;
+    }
+
+    ++mStatistics.hits;
+    mItems.splice (mItems.begin (), mItems, iter->second);
+    return &iter->second->mBytes;
+  }
+
+  void EncodingCache::insert (CacheKey const& key, std::span<uint8_t const> bytes)
+  {
+    if (bytes.size () > mMaxBytes)
+      return;
+
+    if (auto const iter = mIndex.find (key); iter != mIndex.end ())
+    {
+      mBytes -= iter->second->mBytes.size ();
+      mItems.erase (iter->second);
+      mIndex.erase (iter);
+    }
+
+    evict_until (mMaxBytes - bytes.size ());
+    mItems.push_front ({key, {bytes.begin (), bytes.end ()}});
+    mIndex.emplace (key, mItems.begin ());
+    mBytes += bytes.size ();
+  }
+
+  void EncodingCache::clear ()
+  {
+    mItems.clear ();
+    mIndex.clear ();
+    mBytes = 0;
+  }
+
+  auto EncodingCache::statistics () const -> Statistics const&
+  {
+    return mStatistics;
+  }
+
+  auto EncodingCache::size () const -> std::size_t
+  {
+    return mItems.size ();
+  }
+
+  auto EncodingCache::size_in_bytes () const -> std::size_t
+  {
+    return mBytes;
+  }
+
+  auto EncodingCache::max_size_in_bytes () const -> std::size_t
+  {
+    return mMaxBytes;
+  }
+
+  void EncodingCache::evict_until (std::size_t maxBytes)
+  {
+    while (mBytes > maxBytes && !mItems.empty ())
+    {
+      auto const& item = mItems.back ();
+      mBytes -= item.mBytes.size ();
+      mIndex.erase (item.mKey);
+      mItems.pop_back ();
+      ++mStatistics.evictions;
+    }
+  }
+
+  auto EncodingCache::KeyHash::operator () (CacheKey const& key) const -> std::size_t
+  {
+    auto hash = std::hash<void const*> {} (key.mAddress);
+    auto const combine = [&hash] (std::size_t value)
+    {
+      hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    };
+    combine (key.mType.hash_code ());
+    combine (std::hash<uint64_t> {} (key.mGeneration));
+    combine (static_cast<std::size_t> (key.mHint));
+    combine (key.mFormat);
+    combine (key.mColumnarLimit);
+    return hash;
+  }
+}// end of namespace moose
@@ -0,0 +1,249 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <moose/event_tape.h>
+#include <moose/exceptions.h>
+
+#include <type_traits>
+
+namespace moose
+{
+  void EventTape::begin (ContentType type)
+  {
+    mOpen.push_back (mEvents.size ());
+    mEvents.push_back ({Kind::Begin, type});
+  }
+
+  void EventTape::end ()
+  {
+    if (mOpen.empty ())
+      throw ArchiveError {} << "`end` called without corresponding `begin` on event tape.";
+
+    mEvents.push_back ({Kind::End});
+    mEvents.back ().mEnd = mEvents.size ();
+    mEvents [mOpen.back ()].mEnd = mEvents.size ();
+    mOpen.pop_back ();
+  }
+
+  void EventTape::leaf (Value value)
+  {
+    mEvents.push_back ({Kind::Leaf, ContentType::Value, std::move (value), mEvents.size () + 1});
+  }
+
+  void EventTape::append (EventTape const& other, std::size_t first, std::size_t last)
+  {
+    for (auto i = first; i < last; ++i)
+    {
+      auto const& event = other.mEvents [i];
+      switch (event.mKind)
+      {
+        case Kind::Begin: begin (event.mType); break;
+        case Kind::End: end (); break;
+        case Kind::Leaf: leaf (event.mValue); break;
+      }
+    }
+  }
+
+  auto EventTape::events () const -> std::vector<Event> const&
+  {
+    return mEvents;
+  }
+
+
+  TapeWriter::TapeWriter (EventTape& tape)
+    : mTape {&tape}
+  {}
+
+  bool TapeWriter::begin_entry (const char*, ContentType type, Hint)
+  {
+    mTape->begin (type);
+    return true;
+  }
+
+  void TapeWriter::end_entry (const char*, ContentType)
+  {
+    mTape->end ();
+  }
+
+  void TapeWriter::write_type_name (std::string const& typeName)
+  {mTape->leaf (typeName);}
+
+  void TapeWriter::write_type_version (Version const& version)
+  {mTape->leaf (version.toString ());}
+
+  void TapeWriter::write (const char*, bool value)
+  {mTape->leaf (value);}
+
+  void TapeWriter::write (const char*, double value)
+  {mTape->leaf (value);}
+
+  void TapeWriter::write (const char*, std::string const& value)
+  {mTape->leaf (value);}
+
+  void TapeWriter::write (const char*, char value)
+  {mTape->leaf (static_cast<int64_t> (value));}
+
+  void TapeWriter::write (const char*, unsigned char value)
+  {mTape->leaf (static_cast<uint64_t> (value));}
+
+  void TapeWriter::write (const char*, int value)
+  {mTape->leaf (static_cast<int64_t> (value));}
+
+  void TapeWriter::write (const char*, long int value)
+  {mTape->leaf (static_cast<int64_t> (value));}
+
+  void TapeWriter::write (const char*, long long int value)
+  {mTape->leaf (static_cast<int64_t> (value));}
+
+  void TapeWriter::write (const char*, unsigned int value)
+  {mTape->leaf (static_cast<uint64_t> (value));}
+
+  void TapeWriter::write (const char*, unsigned long int value)
+  {mTape->leaf (static_cast<uint64_t> (value));}
+
+  void TapeWriter::write (const char*, unsigned long long int value)
+  {mTape->leaf (static_cast<uint64_t> (value));}
+
+
+  TapeReader::TapeReader (EventTape const& tape)
+    : mTape {&tape}
+  {}
+
+  bool TapeReader::begin_entry (const char*, ContentType type)
+  {
+    auto const& events = mTape->events ();
+    if (mCursor >= events.size () || events [mCursor].mKind != EventTape::Kind::Begin
+        || events [mCursor].mType != type)
+    {
+      return false;
+    }
+
+    mOpen.push_back (mCursor++);
+    return true;
+  }
+
+  void TapeReader::end_entry (const char*, ContentType)
+  {
+    if (mOpen.empty ())
+      throw ArchiveError {} << "`end_entry` called without corresponding `begin_entry`.";
+
+    // skips all children which have not been read
+    mCursor = mTape->events () [mOpen.back ()].mEnd;
+    mOpen.pop_back ();
+  }
+
+  bool TapeReader::array_has_next (const char*) const
+  {
+    auto const& events = mTape->events ();
+    return mCursor < events.size () && events [mCursor].mKind != EventTape::Kind::End;
+  }
+
+  auto TapeReader::array_size (const char*) const -> std::optional<std::size_t>
+  {
+    auto const& events = mTape->events ();
+    std::size_t size = 0;
+    for (auto i = mCursor; i < events.size () && events [i].mKind != EventTape::Kind::End; i = events [i].mEnd)
+      ++size;
+    return size;
+  }
+
+  auto TapeReader::type_name () const -> std::string
+  {
+    std::string name;
+    read ("", name);
+    return name;
+  }
+
+  auto TapeReader::type_version () const -> Version
+  {
+    std::string version;
+    read ("", version);
+    return Version::fromString (version);
+  }
+
+  void TapeReader::read (const char* name, bool& value) const
+  {
+    auto const* const stored = std::get_if<bool> (&next_leaf (name));
+    if (stored == nullptr)
+      throw ArchiveError {} << "Entry '" << name << "' does not hold a boolean.";
+    value = *stored;
+  }
+
+  void TapeReader::read (const char* name, double& value) const
+  {read_number (name, value);}
+
+  void TapeReader::read (const char* name, std::string& value) const
+  {
+    auto const* const stored = std::get_if<std::string> (&next_leaf (name));
+    if (stored == nullptr)
+      throw ArchiveError {} << "Entry '" << name << "' does not hold a string.";
+    value = *stored;
+  }
+
+  void TapeReader::read (const char* name, char& value) const
+  {read_number (name, value);}
+
+  void TapeReader::read (const char* name, unsigned char& value) const
+  {read_number (name, value);}
+
+  void TapeReader::read (const char* name, int& value) const
+  {read_number (name, value);}
+
+  void TapeReader::read (const char* name, long int& value) const
+  {read_number (name, value);}
+
+  void TapeReader::read (const char* name, long long int& value) const
+  {read_number (name, value);}
+
+  void TapeReader::read (const char* name, unsigned int& value) const
+  {read_number (name, value);}
+
+  void TapeReader::read (const char* name, unsigned long int& value) const
+  {read_number (name, value);}
+
+  void TapeReader::read (const char* name, unsigned long long int& value) const
+  {read_number (name, value);}
+
+  auto TapeReader::next_leaf (const char* name) const -> EventTape::Value const&
+  {
+    auto const& events = mTape->events ();
+    if (mCursor >= events.size () || events [mCursor].mKind != EventTape::Kind::Leaf)
+      throw ArchiveError {} << "No value found for entry '" << name << "'.";
+    return events [mCursor++].mValue;
+  }
+
+  template <class T>
+  void TapeReader::read_number (const char* name, T& value) const
+  {
+    std::visit ([name, &value] (auto const& stored)
+      {
+        using Stored = std::decay_t<decltype (stored)>;
+        if constexpr (std::is_arithmetic_v<Stored> && !std::is_same_v<Stored, bool>)
+          value = static_cast<T> (stored);
+        else
+          throw ArchiveError {} << "Entry '" << name << "' does not hold a number.";
+      },
+      next_leaf (name));
+  }
+}// end of namespace moose
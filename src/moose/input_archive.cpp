@@ -23,12 +23,19 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
 // THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <moose/exceptions.h>
+#include <moose/packed_bits.h>
 #include <moose/reader.h>
 
 namespace moose
 {
   Reader::~Reader () = default;
 
+  auto Reader::format () const -> Format
+  {
+    return Format::Other;
+  }
+
   template <class T>
   void Reader::read_double (const char* name, T& val) const
   {
@@ -63,4 +70,63 @@ namespace moose
 
   void Reader::read (const char* name, float& val) const
   {read_double (name, val);}
+
+  void Reader::read (const char* name, PackedBits& val) const
+  {
+    std::string text;
+    read (name, text);
+    val = PackedBits::from_string (text);
+  }
+
+  auto Reader::array_size (const char*) const -> std::optional<std::size_t>
+  {
+    return std::nullopt;
+  }
+
+  bool Reader::read_raw (const char*, RawLayout const&, void*, std::size_t)
+  {
+    return false;
+  }
+
+  template <class T>
+  void Reader::read_elements (const char* name, std::span<T> values)
+  {
+    for (auto& value : values)
+    {
+      if (!array_has_next (name) || !begin_entry ("", ContentType::Value))
+        throw ArchiveError () << "Too few entries while reading range '" << name << "'";
+      read ("", value);
+      end_entry ("", ContentType::Value);
+    }
+  }
+
+  void Reader::read_array (const char* name, std::span<char> values)
+  {read_elements (name, values);}
+
+  void Reader::read_array (const char* name, std::span<unsigned char> values)
+  {read_elements (name, values);}
+
+  void Reader::read_array (const char* name, std::span<int> values)
+  {read_elements (name, values);}
+
+  void Reader::read_array (const char* name, std::span<long int> values)
+  {read_elements (name, values);}
+
+  void Reader::read_array (const char* name, std::span<long long int> values)
+  {read_elements (name, values);}
+
+  void Reader::read_array (const char* name, std::span<unsigned int> values)
+  {read_elements (name, values);}
+
+  void Reader::read_array (const char* name, std::span<unsigned long int> values)
+  {read_elements (name, values);}
+
+  void Reader::read_array (const char* name, std::span<unsigned long long int> values)
+  {read_elements (name, values);}
+
+  void Reader::read_array (const char* name, std::span<float> values)
+  {read_elements (name, values);}
+
+  void Reader::read_array (const char* name, std::span<double> values)
+  {read_elements (name, values);}
 }// end of namespace moose
@@ -30,9 +30,11 @@
 #include <rapidjson/error/error.h>
 #include <rapidjson/error/en.h>
 #include <rapidjson/istreamwrapper.h>
+#include <cstring>
 #include <fstream>
 #include <stdexcept>
 #include <stack>
+#include <vector>
 
 namespace
 {
@@ -42,7 +44,11 @@ namespace
 
     JSONEntry (val_t* _val, const char* _name);
 
-    void init_iter (const char* name);
+    /** Moves the member iterator to the member with the given name and returns `false` if there is none.
+      Members are usually read in the order in which they were written. The search thus starts at the
+      current member, i.e. behind the last consumed one, and only wraps around on a miss. If no member
+      was found, the iterator remains where it was.*/
+    bool seek_member (const char* name);
 
     bool iter_valid () const;
 
@@ -57,7 +63,7 @@ namespace
     bool is_array ()  {return m_type == Array;}
     bool is_value ()  {return m_type == Value;}
 
-    auto getNextDummyName () -> std::string {return mDummyNameGenerator.getNext ();}
+    auto getNextDummyName () -> const char* {return mDummyNameGenerator.getNext ();}
 
   private:
     enum Type {Object, Array, Value};
@@ -70,11 +76,30 @@ namespace
     moose::detail::DummyNameGenerator mDummyNameGenerator;
   };
 
-  auto currentValue (std::stack <JSONEntry>& entries) -> rapidjson::Value&
+  auto currentValue (std::stack <JSONEntry, std::vector <JSONEntry>>& entries) -> rapidjson::Value&
   {
     if (entries.empty()) throw moose::ArchiveError () << "JSONArchiveIn::archive: entry stack empty!";
     return entries.top().value();
   }
+
+  /** Returns the annotation member with the given name, e.g. `@type`, or `nullptr`.
+    The `JSONWriter` stores annotations in front of all other members, so these are tested first.*/
+  auto annotation (rapidjson::Value const& value, const char* name) -> rapidjson::Value const*
+  {
+    if (!value.IsObject())
+      return nullptr;
+
+    auto const end = value.MemberEnd();
+    auto iter = value.MemberBegin();
+    for (int i = 0; i < 2 && iter != end; ++i, ++iter)
+    {
+      if (strcmp (iter->name.GetString(), name) == 0)
+        return &iter->value;
+    }
+
+    auto const found = value.FindMember (name);
+    return found == end ? nullptr : &found->value;
+  }
 }// end of namespace
 
 namespace moose
@@ -85,7 +110,7 @@ namespace moose
 
     doc_t& new_document ();
 
-    std::stack <JSONEntry> m_entries;
+    std::stack <JSONEntry, std::vector <JSONEntry>> m_entries;
     std::unique_ptr <doc_t> m_doc;
   };
 
@@ -181,6 +206,11 @@ namespace moose
     m_parseData->m_entries.push (JSONEntry (&d, "_root_"));
   }
 
+  auto JSONReader::format () const -> Format
+  {
+    return Format::Json;
+  }
+
   bool JSONReader::begin_entry (const char* name, ContentType)
   {
     auto& entries = m_parseData->m_entries;
@@ -189,25 +219,23 @@ namespace moose
 
     auto& e = entries.top();
 
-    std::string dummyName;
     if ((name == nullptr || *name == 0) && !entries.top().is_array())
+      name = entries.top().getNextDummyName ();
+
+    if (e.is_object ())
     {
-      dummyName = entries.top().getNextDummyName ();
-      name = dummyName.c_str ();
+      if (!e.seek_member (name))
+        return false;
+    }
+    else
+    {
+      // Arrays are read by position. Once all elements were consumed, further entries are missing.
+      if (!e.iter_valid())
+        return false;
     }
-
-  //  if we're currently iterating over elements with the given name, we don't
-  //  have to initialize the iterators
-    if(!e.iter_valid() || (strcmp(name, e.iter_name()) != 0))
-      e.init_iter(name);
-
-    if (!e.iter_valid())
-      return false;
 
     // cout << "<dbg> pushing entry '" << e.iter_name() << "'\n";
     entries.push (JSONEntry (&e.iter_value(), e.iter_name()));
-    if(entries.top().is_array())
-      entries.top().init_iter("");
 
     return true;
   }
@@ -227,22 +255,21 @@ namespace moose
 
   bool JSONReader::array_has_next (const char*) const
   {
-    return m_parseData->m_entries.top().iter_valid();
+    auto& top = m_parseData->m_entries.top();
+    return top.is_array() && top.iter_valid();
   }
 
   auto JSONReader::type_name () const -> std::string
   {
-    auto& value = currentValue (m_parseData->m_entries);
-    if(value.HasMember("@type"))
-      return value["@type"].GetString();
+    if (auto const* typeName = annotation (currentValue (m_parseData->m_entries), "@type"))
+      return typeName->GetString();
     return {};
   }
 
   auto JSONReader::type_version () const -> Version
   {
-    auto& value = currentValue (m_parseData->m_entries);
-    if(value.HasMember("@type_version"))
-      return Version::fromString (value["@type_version"].GetString());
+    if (auto const* version = annotation (currentValue (m_parseData->m_entries), "@type_version"))
+      return Version::fromString (version->GetString());
     return {};
   }
 
@@ -277,23 +304,43 @@ namespace
   {
     if(_val->IsObject()){
       m_type = Object;
-      m_icurMem = _val->MemberEnd();
+      m_icurMem = _val->MemberBegin();
     }
     else if(_val->IsArray()){
       m_type = Array;
-      m_icurVal = _val->End();
+      m_icurVal = _val->Begin();
     }
     else
       m_type = Value;
   }
 
-  void JSONEntry::init_iter (const char* name)
+  bool JSONEntry::seek_member (const char* name)
   {
-    switch(m_type) {
-      case Object: m_icurMem = m_val->FindMember (name); break;
-      case Array: m_icurVal = m_val->Begin(); break;
-      case Value: break;
+    auto const matches = [name] (rapidjson::Value::MemberIterator iter)
+    {
+      auto const* memberName = iter->name.GetString();
+      return memberName == name || strcmp (memberName, name) == 0;
+    };
+
+    auto const end = m_val->MemberEnd();
+    for (auto iter = m_icurMem; iter != end; ++iter)
+    {
+      if (matches (iter))
+      {
+        m_icurMem = iter;
+        return true;
+      }
+    }
+
+    for (auto iter = m_val->MemberBegin(); iter != m_icurMem; ++iter)
+    {
+      if (matches (iter))
+      {
+        m_icurMem = iter;
+        return true;
+      }
     }
+    return false;
   }
 
   bool JSONEntry::iter_valid () const
@@ -27,7 +27,10 @@
 #include <moose/json_writer.h>
 
 #include <cassert>
+#include <charconv>
+#include <cmath>
 #include <iomanip>
+#include <limits>
 #include <fstream>
 
 namespace
@@ -41,18 +44,19 @@ namespace
 
 namespace moose
 {
-  auto JSONWriter::toFile (const char* filename) -> std::shared_ptr<JSONWriter>
+  auto JSONWriter::toFile (const char* filename, JSONOptions options) -> std::shared_ptr<JSONWriter>
   {
-    return std::make_shared <JSONWriter> (filename);
+    return std::make_shared <JSONWriter> (filename, options);
   }
 
-  JSONWriter::JSONWriter (const char* filename)
-    : JSONWriter (std::make_shared <std::ofstream> (filename))
+  JSONWriter::JSONWriter (const char* filename, JSONOptions options)
+    : JSONWriter (std::make_shared <std::ofstream> (filename), options)
   {
   }
 
-  JSONWriter::JSONWriter (std::shared_ptr <std::ostream> out)
+  JSONWriter::JSONWriter (std::shared_ptr <std::ostream> out, JSONOptions options)
     : m_out (std::move (out))
+    , mOptions {options}
   {
     if (!m_out ||
         m_out->fail ())
@@ -67,6 +71,7 @@ namespace moose
 
   JSONWriter::JSONWriter (JSONWriter&& other)
     : m_out {std::move (other.m_out)}
+    , mOptions {other.mOptions}
     , m_currentDepth {other.m_currentDepth}
     , m_lastWrittenDepth {other.m_lastWrittenDepth}
   {}
@@ -83,24 +88,65 @@ namespace moose
   JSONWriter& JSONWriter::operator = (JSONWriter&& other)
   {
     m_out = std::move (other.m_out);
+    mOptions = other.mOptions;
     m_currentDepth = other.m_currentDepth;
     m_lastWrittenDepth = other.m_lastWrittenDepth;
     return *this;
   }
 
+  auto JSONWriter::format () const -> Format
+  {
+    return Format::Json;
+  }
+
   bool JSONWriter::begin_entry (const char* name, ContentType type, Hint hint)
   {
+    bool const unnamed = name == nullptr || *name == 0;
+    open_struct (unnamed);
     prepare_content ();
 
+    switch (hint)
+    {
+      case Hint::Float32:
+      case Hint::Float16:
+      case Hint::Quantized16:
+        mPrecisions.push (hint);
+        hint = Hint::None;
+        break;
+      default:
+        mPrecisions.push (precision ());
+        break;
+    }
+
+    switch (hint)
+    {
+      case Hint::Columnar:
+      case Hint::Delta:
+      case Hint::XorFloat:
+      case Hint::RunLength:
+        hint = Hint::None; // Does not affect the layout of JSON files.
+        break;
+      default:
+        break;
+    }
+
     if (this->hint () == Hint::ChildrenOneLine)
       hint = Hint::OneLine;
 
     m_hints.push (hint == Hint::None ? this->hint () : hint);
 
-    if (name != nullptr && *name != 0)
-      out () << "\"" << name << "\": ";
-    else if (mEntryStack.empty () || mEntryStack.top ().mContentType != ContentType::Array)
-      out () << "\"" << mEntryStack.top ().mDummyNameGenerator.getNext () << "\": ";
+    bool const positional = !mEntryStack.empty () &&
+                            (mEntryStack.top ().mContentType == ContentType::Array || mEntryStack.top ().mPositional);
+    if (!positional)
+    {
+      if (!unnamed)
+        out () << "\"" << name << "\": ";
+      else
+      {
+        auto& names = mEntryStack.empty () ? mRootDummyNameGenerator : mEntryStack.top ().mDummyNameGenerator;
+        out () << "\"" << names.getNext () << "\": ";
+      }
+    }
 
     mEntryStack.emplace (type);
     ++m_currentDepth;
@@ -113,8 +159,14 @@ namespace moose
         break;
 
       case ContentType::Struct:
-        out () << "{";
-        optional_endl ();
+        // The representation of a struct is decided by its first member, see `open_struct`.
+        if (mOptions.unnamedEntries == UnnamedEntries::Positional)
+          mEntryStack.top ().mPending = true;
+        else
+        {
+          out () << "{";
+          optional_endl ();
+        }
         break;
 
       case ContentType::Value:
@@ -126,6 +178,7 @@ namespace moose
 
   void JSONWriter::end_entry (const char*, ContentType type)
   {
+    open_struct (false);
     --m_currentDepth;
     m_lastWrittenDepth = m_currentDepth;
 
@@ -138,7 +191,7 @@ namespace moose
 
       case ContentType::Struct:
         optional_endl ();
-        out () << "}";
+        out () << (mEntryStack.top ().mPositional ? "]" : "}");
         break;
 
       case ContentType::Value:
@@ -148,6 +201,8 @@ namespace moose
     assert (!m_hints.empty ());
     if (!m_hints.empty ())
       m_hints.pop ();
+    if (!mPrecisions.empty ())
+      mPrecisions.pop ();
 
     assert (!mEntryStack.empty ());
     if (!mEntryStack.empty ())
@@ -156,6 +211,7 @@ namespace moose
 
   void JSONWriter::write_type_name (std::string const& typeName)
   {
+    open_struct (false);
     prepare_content ();
     out () << "\"@type\": \"" << typeName << "\"";
     m_lastWrittenDepth = m_currentDepth;
@@ -163,6 +219,7 @@ namespace moose
 
   void JSONWriter::write_type_version (Version const& version)
   {
+    open_struct (false);
     prepare_content ();
     out () << "\"@type_version\": \"" << version.toString () << "\"";
     m_lastWrittenDepth = m_currentDepth;
@@ -175,7 +232,19 @@ namespace moose
 
   void JSONWriter::write (const char*, double val)
   {
-    out () << std::setprecision (15) << val;
+    auto const hint = precision ();
+    // Values beyond the single precision range are written with full precision instead of as infinity.
+    auto const fitsFloat = !std::isfinite (val) || std::abs (val) <= std::numeric_limits<float>::max ();
+    if (hint == Hint::None || (std::trunc (val) == val && std::abs (val) < 0x1p53) || (hint == Hint::Float32 && !fitsFloat))
+      out () << std::setprecision (mOptions.significantDigits) << val;
+    else if (hint == Hint::Float32)
+    {
+      char buffer [32];
+      auto const result = std::to_chars (buffer, buffer + sizeof (buffer), static_cast<float> (val));
+      out ().write (buffer, result.ptr - buffer);
+    }
+    else
+      out () << std::setprecision (5) << val;
   }
 
   void JSONWriter::write (const char*, std::string const& val)
@@ -192,6 +261,18 @@ namespace moose
     out << "\"";
   }
 
+  void JSONWriter::open_struct (bool positional)
+  {
+    if (mEntryStack.empty () || !mEntryStack.top ().mPending)
+      return;
+
+    auto& entry = mEntryStack.top ();
+    entry.mPending = false;
+    entry.mPositional = positional;
+    out () << (positional ? "[" : "{");
+    optional_endl ();
+  }
+
   void JSONWriter::prepare_content ()
   {
     if (m_lastWrittenDepth == m_currentDepth)
@@ -205,7 +286,7 @@ namespace moose
   {
     if (hint () == Hint::OneLine)
       return;
-    out () << std::endl;
+    out () << '\n'; // no flush per line
     WriteWhitespace (out (), m_currentDepth * 2);
   }
 
@@ -216,6 +297,13 @@ namespace moose
     return m_hints.top ();
   }
 
+  auto JSONWriter::precision () const -> Hint
+  {
+    if (mPrecisions.empty ())
+      return Hint::None;
+    return mPrecisions.top ();
+  }
+
   auto JSONWriter::out () -> std::ostream &
   {
     return *m_out;
@@ -23,12 +23,18 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
 // THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <moose/packed_bits.h>
 #include <moose/writer.h>
 
 namespace moose
 {
   Writer::~Writer () = default;
 
+  auto Writer::format () const -> Format
+  {
+    return Format::Other;
+  }
+
   template <class T>
   void Writer::write_double (const char* name, T val)
   {
@@ -61,4 +67,74 @@ namespace moose
 
   void Writer::write (const char* name, float val)
   {write_double (name, val);}
+
+  void Writer::write (const char* name, PackedBits const& val)
+  {write (name, val.to_string ());}
+
+  void Writer::write_array_size (std::size_t)
+  {}
+
+  bool Writer::write_raw (const char*, RawLayout const&, void const*, std::size_t)
+  {
+    return false;
+  }
+
+  bool Writer::write_cached (const char*, ContentType, Hint, CacheKey const&)
+  {
+    return false;
+  }
+
+  bool Writer::describes_schema () const
+  {
+    return false;
+  }
+
+  bool Writer::begin_schema_element (std::type_info const&)
+  {
+    return false;
+  }
+
+  void Writer::end_schema_element ()
+  {}
+
+  template <class T>
+  void Writer::write_elements (const char*, std::span<T const> values)
+  {
+    for (auto const value : values)
+    {
+      begin_entry ("", ContentType::Value, Hint::None);
+      write ("", value);
+      end_entry ("", ContentType::Value);
+    }
+  }
+
+  void Writer::write_array (const char* name, std::span<char const> values)
+  {write_elements (name, values);}
+
+  void Writer::write_array (const char* name, std::span<unsigned char const> values)
+  {write_elements (name, values);}
+
+  void Writer::write_array (const char* name, std::span<int const> values)
+  {write_elements (name, values);}
+
+  void Writer::write_array (const char* name, std::span<long int const> values)
+  {write_elements (name, values);}
+
+  void Writer::write_array (const char* name, std::span<long long int const> values)
+  {write_elements (name, values);}
+
+  void Writer::write_array (const char* name, std::span<unsigned int const> values)
+  {write_elements (name, values);}
+
+  void Writer::write_array (const char* name, std::span<unsigned long int const> values)
+  {write_elements (name, values);}
+
+  void Writer::write_array (const char* name, std::span<unsigned long long int const> values)
+  {write_elements (name, values);}
+
+  void Writer::write_array (const char* name, std::span<float const> values)
+  {write_elements (name, values);}
+
+  void Writer::write_array (const char* name, std::span<double const> values)
+  {write_elements (name, values);}
 }// end of namespace moose
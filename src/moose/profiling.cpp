@@ -0,0 +1,474 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <moose/exceptions.h>
+#include <moose/profiling.h>
+#include <moose/stl_serialization.h>
+#include <moose/to_json.h>
+
+#include <istream>
+#include <ostream>
+
+namespace
+{
+  struct StatisticsRecord
+  {
+    std::string name;
+    moose::ProfileStatistics statistics;
+
+    void serialize (moose::Archive& ar)
+    {
+      ar ("name", name);
+      ar ("count", statistics.count);
+      ar ("measured", statistics.measured);
+      ar ("bytes", statistics.bytes);
+      ar ("seconds", statistics.seconds);
+      ar ("estimatedBytes", statistics.estimated_bytes ());
+      ar ("estimatedSeconds", statistics.estimated_seconds ());
+    }
+  };
+
+  struct ProfileReport
+  {
+    std::vector<StatisticsRecord> fields;
+    std::vector<StatisticsRecord> types;
+
+    void serialize (moose::Archive& ar)
+    {
+      ar ("fields", fields);
+      ar ("types", types);
+    }
+  };
+
+  /// A complete event ("ph": "X") of the Chrome trace event format. Times are in microseconds.
+  struct ChromeTraceEvent
+  {
+    std::string name;
+    std::string path;
+    double ts {0};
+    double dur {0};
+
+    void serialize (moose::Archive& ar)
+    {
+      ar ("name", name);
+      ar ("cat", std::string {"moose"});
+      ar ("ph", std::string {"X"});
+      ar ("ts", ts);
+      ar ("dur", dur);
+      ar ("pid", 1);
+      ar ("tid", 1);
+      ar ("args", path);
+    }
+  };
+
+  auto microseconds (std::chrono::steady_clock::duration duration) -> double
+  {
+    return std::chrono::duration<double, std::micro> (duration).count ();
+  }
+
+  auto extrapolate (double measured, moose::ProfileStatistics const& statistics) -> double
+  {
+    if (statistics.measured == 0)
+      return 0;
+    return measured * static_cast<double> (statistics.count) / static_cast<double> (statistics.measured);
+  }
+}// end of namespace
+
+namespace moose
+{
+  auto ProfileStatistics::estimated_bytes () const -> double
+  {
+    return extrapolate (static_cast<double> (bytes), *this);
+  }
+
+  auto ProfileStatistics::estimated_seconds () const -> double
+  {
+    return extrapolate (seconds, *this);
+  }
+
+  auto writePosition (std::ostream& out) -> std::function<std::size_t ()>
+  {
+    return [&out] {auto const p = out.tellp (); return p < 0 ? std::size_t {0} : static_cast<std::size_t> (p);};
+  }
+
+  auto readPosition (std::istream& in) -> std::function<std::size_t ()>
+  {
+    return [&in] {auto const p = in.tellg (); return p < 0 ? std::size_t {0} : static_cast<std::size_t> (p);};
+  }
+
+  Profile::Profile ()
+  {
+    clear ();
+  }
+
+  auto Profile::fields () const -> std::vector<Field>
+  {
+    std::vector<Field> fields;
+    fields.reserve (mNodes.size () - 1);
+    for (std::size_t i = 1; i < mNodes.size (); ++i)
+      fields.push_back ({path (i), mNodes [i].mStatistics});
+    return fields;
+  }
+
+  auto Profile::types () const -> std::map<std::string, ProfileStatistics, std::less<>> const&
+  {
+    return mTypes;
+  }
+
+  void Profile::write_json (std::ostream& out) const
+  {
+    ProfileReport report;
+    for (auto& field : fields ())
+      report.fields.push_back ({std::move (field.path), field.statistics});
+    for (auto const& [name, statistics] : mTypes)
+      report.types.push_back ({name, statistics});
+
+    out << toJson ("profile", report);
+  }
+
+  void Profile::write_chrome_trace (std::ostream& out) const
+  {
+    std::vector<ChromeTraceEvent> events;
+    events.reserve (mTraceEvents.size ());
+    for (auto const& event : mTraceEvents)
+    {
+      auto const& name = mNodes [event.mNode].mName;
+      events.push_back ({name.empty () ? "@noname" : name, path (event.mNode),
+                         microseconds (event.mStart), microseconds (event.mDuration)});
+    }
+
+    out << toJson ("traceEvents", events);
+  }
+
+  void Profile::clear ()
+  {
+    mEpoch = std::chrono::steady_clock::now ();
+    mNodes.clear ();
+    mNodes.push_back ({"", 0});
+    mTypes.clear ();
+    mTraceEvents.clear ();
+  }
+
+  auto Profile::child (std::size_t parent, const char* name) -> std::size_t
+  {
+    for (auto const child : mNodes [parent].mChildren)
+    {
+      if (mNodes [child].mName == name)
+        return child;
+    }
+
+    auto const child = mNodes.size ();
+    mNodes.push_back ({name, parent});
+    mNodes [parent].mChildren.push_back (child);
+    return child;
+  }
+
+  auto Profile::path (std::size_t node) const -> std::string
+  {
+    std::string path;
+    for (; node != 0; node = mNodes [node].mParent)
+    {
+      auto const& name = mNodes [node].mName;
+      if (name.empty ())
+        continue;
+      path.insert (0, path.empty () ? name : name + "/");
+    }
+    return path;
+  }
+
+  ProfileRecorder::ProfileRecorder (std::shared_ptr<Profile> profile, ProfilingOptions options)
+    : mProfile {std::move (profile)}
+    , mOptions {std::move (options)}
+  {
+    if (!mProfile)
+      throw ArchiveError () << "Invalid profile provided";
+    if (mOptions.samplingInterval == 0)
+      mOptions.samplingInterval = 1;
+  }
+
+  void ProfileRecorder::begin (const char* name, ContentType type)
+  {
+    std::size_t parent = 0;
+    if (!mFrames.empty ())
+    {
+      parent = mFrames.back ().mNode;
+      if (mFrames.back ().mType == ContentType::Array && (name == nullptr || *name == 0))
+        name = "[]";
+    }
+
+    auto const node = mProfile->child (parent, name == nullptr ? "" : name);
+    auto& statistics = mProfile->mNodes [node].mStatistics;
+    bool const measured = statistics.count++ % mOptions.samplingInterval == 0;
+
+    Frame frame {node, type, measured};
+    if (measured)
+    {
+      if (mOptions.position)
+        frame.mPosition = mOptions.position ();
+      frame.mStart = std::chrono::steady_clock::now ();
+    }
+    mFrames.push_back (frame);
+  }
+
+  void ProfileRecorder::end ()
+  {
+    if (mFrames.empty ())
+      throw ArchiveError () << "`end_entry` called without corresponding `begin_entry`.";
+
+    auto const frame = mFrames.back ();
+    mFrames.pop_back ();
+    if (!frame.mMeasured)
+      return;
+
+    auto const duration = std::chrono::steady_clock::now () - frame.mStart;
+    auto const seconds = std::chrono::duration<double> (duration).count ();
+    std::size_t bytes = 0;
+    if (mOptions.position)
+    {
+      auto const position = mOptions.position ();
+      bytes = position > frame.mPosition ? position - frame.mPosition : 0;
+    }
+
+    for (auto* statistics : {&mProfile->mNodes [frame.mNode].mStatistics, frame.mTypeStatistics})
+    {
+      if (statistics == nullptr)
+        continue;
+      ++statistics->measured;
+      statistics->bytes += bytes;
+      statistics->seconds += seconds;
+    }
+
+    if (mOptions.trace && mProfile->mTraceEvents.size () < mOptions.maxTraceEvents)
+      mProfile->mTraceEvents.push_back ({frame.mNode, frame.mStart - mProfile->mEpoch, duration});
+  }
+
+  void ProfileRecorder::cancel ()
+  {
+    if (mFrames.empty ())
+      return;
+
+    --mProfile->mNodes [mFrames.back ().mNode].mStatistics.count;
+    mFrames.pop_back ();
+  }
+
+  void ProfileRecorder::type (std::string const& name)
+  {
+    if (mFrames.empty () || name.empty () || mFrames.back ().mTypeStatistics != nullptr)
+      return;
+
+    auto iter = mProfile->mTypes.find (name);
+    if (iter == mProfile->mTypes.end ())
+      iter = mProfile->mTypes.emplace (name, ProfileStatistics {}).first;
+
+    ++iter->second.count;
+    mFrames.back ().mTypeStatistics = &iter->second;
+  }
+
+  ProfilingWriter::ProfilingWriter (std::shared_ptr<Writer> writer, std::shared_ptr<Profile> profile,
+                                    ProfilingOptions options)
+    : mWriter {std::move (writer)}
+    , mRecorder {std::move (profile), std::move (options)}
+  {
+    if (!mWriter)
+      throw ArchiveError () << "Invalid writer provided";
+  }
+
+  auto ProfilingWriter::format () const -> Format
+  {
+    return mWriter->format ();
+  }
+
+  bool ProfilingWriter::begin_entry (const char* name, ContentType type, Hint hint)
+  {
+    mRecorder.begin (name, type);
+    if (mWriter->begin_entry (name, type, hint))
+      return true;
+
+    mRecorder.cancel ();
+    return false;
+  }
+
+  bool ProfilingWriter::describes_schema () const
+  {
+    return mWriter->describes_schema ();
+  }
+
+  bool ProfilingWriter::begin_schema_element (std::type_info const& type)
+  {
+    return mWriter->begin_schema_element (type);
+  }
+
+  void ProfilingWriter::end_schema_element ()
+  {
+    mWriter->end_schema_element ();
+  }
+
+  void ProfilingWriter::end_entry (const char* name, ContentType type)
+  {
+    mWriter->end_entry (name, type);
+    mRecorder.end ();
+  }
+
+  void ProfilingWriter::write_array_size (std::size_t size)
+  {
+    mWriter->write_array_size (size);
+  }
+
+  void ProfilingWriter::write_type_name (std::string const& typeName)
+  {
+    mRecorder.type (typeName);
+    mWriter->write_type_name (typeName);
+  }
+
+  void ProfilingWriter::write_type_version (Version const& version)
+  {
+    mWriter->write_type_version (version);
+  }
+
+  void ProfilingWriter::write (const char* name, bool value) {mWriter->write (name, value);}
+  void ProfilingWriter::write (const char* name, double value) {mWriter->write (name, value);}
+  void ProfilingWriter::write (const char* name, std::string const& value) {mWriter->write (name, value);}
+  void ProfilingWriter::write (const char* name, PackedBits const& value) {mWriter->write (name, value);}
+  void ProfilingWriter::write (const char* name, char value) {mWriter->write (name, value);}
+  void ProfilingWriter::write (const char* name, unsigned char value) {mWriter->write (name, value);}
+  void ProfilingWriter::write (const char* name, int value) {mWriter->write (name, value);}
+  void ProfilingWriter::write (const char* name, long int value) {mWriter->write (name, value);}
+  void ProfilingWriter::write (const char* name, long long int value) {mWriter->write (name, value);}
+  void ProfilingWriter::write (const char* name, unsigned int value) {mWriter->write (name, value);}
+  void ProfilingWriter::write (const char* name, unsigned long int value) {mWriter->write (name, value);}
+  void ProfilingWriter::write (const char* name, unsigned long long int value) {mWriter->write (name, value);}
+  void ProfilingWriter::write (const char* name, float value) {mWriter->write (name, value);}
+
+  void ProfilingWriter::write_array (const char* name, std::span<char const> values) {mWriter->write_array (name, values);}
+  void ProfilingWriter::write_array (const char* name, std::span<unsigned char const> values) {mWriter->write_array (name, values);}
+  void ProfilingWriter::write_array (const char* name, std::span<int const> values) {mWriter->write_array (name, values);}
+  void ProfilingWriter::write_array (const char* name, std::span<long int const> values) {mWriter->write_array (name, values);}
+  void ProfilingWriter::write_array (const char* name, std::span<long long int const> values) {mWriter->write_array (name, values);}
+  void ProfilingWriter::write_array (const char* name, std::span<unsigned int const> values) {mWriter->write_array (name, values);}
+  void ProfilingWriter::write_array (const char* name, std::span<unsigned long int const> values) {mWriter->write_array (name, values);}
+  void ProfilingWriter::write_array (const char* name, std::span<unsigned long long int const> values) {mWriter->write_array (name, values);}
+  void ProfilingWriter::write_array (const char* name, std::span<float const> values) {mWriter->write_array (name, values);}
+  void ProfilingWriter::write_array (const char* name, std::span<double const> values) {mWriter->write_array (name, values);}
+
+  bool ProfilingWriter::write_raw (const char* name, RawLayout const& layout, void const* data, std::size_t count)
+  {
+    return mWriter->write_raw (name, layout, data, count);
+  }
+
+  bool ProfilingWriter::write_cached (const char* name, ContentType type, Hint hint, CacheKey const& key)
+  {
+    // A cached entry is written completely by this call, without `begin_entry` and `end_entry`.
+    mRecorder.begin (name, type);
+    if (mWriter->write_cached (name, type, hint, key))
+    {
+      mRecorder.end ();
+      return true;
+    }
+
+    mRecorder.cancel ();
+    return false;
+  }
+
+  ProfilingReader::ProfilingReader (std::shared_ptr<Reader> reader, std::shared_ptr<Profile> profile,
+                                    ProfilingOptions options)
+    : mReader {std::move (reader)}
+    , mRecorder {std::move (profile), std::move (options)}
+  {
+    if (!mReader)
+      throw ArchiveError () << "Invalid reader provided";
+  }
+
+  auto ProfilingReader::format () const -> Format
+  {
+    return mReader->format ();
+  }
+
+  bool ProfilingReader::begin_entry (const char* name, ContentType type)
+  {
+    mRecorder.begin (name, type);
+    if (mReader->begin_entry (name, type))
+      return true;
+
+    mRecorder.cancel ();
+    return false;
+  }
+
+  void ProfilingReader::end_entry (const char* name, ContentType type)
+  {
+    mReader->end_entry (name, type);
+    mRecorder.end ();
+  }
+
+  bool ProfilingReader::array_has_next (const char* name) const
+  {
+    return mReader->array_has_next (name);
+  }
+
+  auto ProfilingReader::array_size (const char* name) const -> std::optional<std::size_t>
+  {
+    return mReader->array_size (name);
+  }
+
+  auto ProfilingReader::type_name () const -> std::string
+  {
+    auto name = mReader->type_name ();
+    mRecorder.type (name);
+    return name;
+  }
+
+  auto ProfilingReader::type_version () const -> Version
+  {
+    return mReader->type_version ();
+  }
+
+  void ProfilingReader::read (const char* name, bool& value) const {mReader->read (name, value);}
+  void ProfilingReader::read (const char* name, double& value) const {mReader->read (name, value);}
+  void ProfilingReader::read (const char* name, std::string& value) const {mReader->read (name, value);}
+  void ProfilingReader::read (const char* name, PackedBits& value) const {mReader->read (name, value);}
+  void ProfilingReader::read (const char* name, char& value) const {mReader->read (name, value);}
+  void ProfilingReader::read (const char* name, unsigned char& value) const {mReader->read (name, value);}
+  void ProfilingReader::read (const char* name, int& value) const {mReader->read (name, value);}
+  void ProfilingReader::read (const char* name, long int& value) const {mReader->read (name, value);}
+  void ProfilingReader::read (const char* name, long long int& value) const {mReader->read (name, value);}
+  void ProfilingReader::read (const char* name, unsigned int& value) const {mReader->read (name, value);}
+  void ProfilingReader::read (const char* name, unsigned long int& value) const {mReader->read (name, value);}
+  void ProfilingReader::read (const char* name, unsigned long long int& value) const {mReader->read (name, value);}
+  void ProfilingReader::read (const char* name, float& value) const {mReader->read (name, value);}
+
+  void ProfilingReader::read_array (const char* name, std::span<char> values) {mReader->read_array (name, values);}
+  void ProfilingReader::read_array (const char* name, std::span<unsigned char> values) {mReader->read_array (name, values);}
+  void ProfilingReader::read_array (const char* name, std::span<int> values) {mReader->read_array (name, values);}
+  void ProfilingReader::read_array (const char* name, std::span<long int> values) {mReader->read_array (name, values);}
+  void ProfilingReader::read_array (const char* name, std::span<long long int> values) {mReader->read_array (name, values);}
+  void ProfilingReader::read_array (const char* name, std::span<unsigned int> values) {mReader->read_array (name, values);}
+  void ProfilingReader::read_array (const char* name, std::span<unsigned long int> values) {mReader->read_array (name, values);}
+  void ProfilingReader::read_array (const char* name, std::span<unsigned long long int> values) {mReader->read_array (name, values);}
+  void ProfilingReader::read_array (const char* name, std::span<float> values) {mReader->read_array (name, values);}
+  void ProfilingReader::read_array (const char* name, std::span<double> values) {mReader->read_array (name, values);}
+
+  bool ProfilingReader::read_raw (const char* name, RawLayout const& layout, void* data, std::size_t count)
+  {
+    return mReader->read_raw (name, layout, data, count);
+  }
+}// end of namespace moose
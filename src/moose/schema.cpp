@@ -0,0 +1,151 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <moose/schema.h>
+#include <moose/detail/binary_encoding.h>
+
+#include <algorithm>
+
+namespace moose
+{
+  namespace
+  {
+    enum class Token : uint8_t
+    {
+      Begin = 1,
+      End = 2,
+      Bool = 3,
+      String = 4,
+      Integer = 5,
+      SignedInteger = 6,
+      FloatingPoint = 7,
+      Bits = 8
+    };
+  }
+
+  auto SchemaWriter::format () const -> Format
+  {
+    return Format::Binary;
+  }
+
+  bool SchemaWriter::describes_schema () const
+  {
+    return true;
+  }
+
+  bool SchemaWriter::begin_schema_element (std::type_info const& type)
+  {
+    if (std::find (mDescribed.begin (), mDescribed.end (), std::type_index (type)) != mDescribed.end ())
+      return false;
+    mDescribed.emplace_back (type);
+    return true;
+  }
+
+  void SchemaWriter::end_schema_element ()
+  {
+    mDescribed.pop_back ();
+  }
+
+  bool SchemaWriter::begin_entry (const char*, ContentType type, Hint)
+  {
+    add (static_cast<uint8_t> (Token::Begin));
+    add (static_cast<uint8_t> (type));
+    return true;
+  }
+
+  void SchemaWriter::end_entry (const char*, ContentType)
+  {
+    add (static_cast<uint8_t> (Token::End));
+  }
+
+  void SchemaWriter::write_type_name (std::string const&)
+  {}
+
+  void SchemaWriter::write_type_version (Version const&)
+  {}
+
+  void SchemaWriter::write (const char*, bool)
+  {
+    add (static_cast<uint8_t> (Token::Bool));
+  }
+
+  void SchemaWriter::write (const char*, std::string const&)
+  {
+    add (static_cast<uint8_t> (Token::String));
+  }
+
+  void SchemaWriter::write (const char*, PackedBits const&)
+  {
+    add (static_cast<uint8_t> (Token::Bits));
+  }
+
+  void SchemaWriter::write (const char*, double)                 {add_number<double> ();}
+  void SchemaWriter::write (const char*, char)                   {add_number<char> ();}
+  void SchemaWriter::write (const char*, unsigned char)          {add_number<unsigned char> ();}
+  void SchemaWriter::write (const char*, int)                    {add_number<int> ();}
+  void SchemaWriter::write (const char*, long int)               {add_number<long int> ();}
+  void SchemaWriter::write (const char*, long long int)          {add_number<long long int> ();}
+  void SchemaWriter::write (const char*, unsigned int)           {add_number<unsigned int> ();}
+  void SchemaWriter::write (const char*, unsigned long int)      {add_number<unsigned long int> ();}
+  void SchemaWriter::write (const char*, unsigned long long int) {add_number<unsigned long long int> ();}
+  void SchemaWriter::write (const char*, float)                  {add_number<float> ();}
+
+  void SchemaWriter::write_array (const char*, std::span<char const>)                   {add_array<char> ();}
+  void SchemaWriter::write_array (const char*, std::span<unsigned char const>)          {add_array<unsigned char> ();}
+  void SchemaWriter::write_array (const char*, std::span<int const>)                    {add_array<int> ();}
+  void SchemaWriter::write_array (const char*, std::span<long int const>)               {add_array<long int> ();}
+  void SchemaWriter::write_array (const char*, std::span<long long int const>)          {add_array<long long int> ();}
+  void SchemaWriter::write_array (const char*, std::span<unsigned int const>)           {add_array<unsigned int> ();}
+  void SchemaWriter::write_array (const char*, std::span<unsigned long int const>)      {add_array<unsigned long int> ();}
+  void SchemaWriter::write_array (const char*, std::span<unsigned long long int const>) {add_array<unsigned long long int> ();}
+  void SchemaWriter::write_array (const char*, std::span<float const>)                  {add_array<float> ();}
+  void SchemaWriter::write_array (const char*, std::span<double const>)                 {add_array<double> ();}
+
+  void SchemaWriter::add (uint8_t byte)
+  {
+    // FNV-1a
+    mHash = (mHash ^ byte) * 1099511628211ull;
+  }
+
+  template <class T>
+  void SchemaWriter::add_number ()
+  {
+    using Storage = detail::BinaryStorageType<T>;
+    if constexpr (std::is_floating_point_v<Storage>)
+      add (static_cast<uint8_t> (Token::FloatingPoint));
+    else if constexpr (std::is_signed_v<Storage> && sizeof (Storage) > 1)
+      add (static_cast<uint8_t> (Token::SignedInteger));
+    else
+      add (static_cast<uint8_t> (Token::Integer));
+    add (static_cast<uint8_t> (sizeof (Storage)));
+  }
+
+  template <class T>
+  void SchemaWriter::add_array ()
+  {
+    begin_entry ("", ContentType::Value, Hint::None);
+    add_number<T> ();
+    end_entry ("", ContentType::Value);
+  }
+}// end of namespace moose
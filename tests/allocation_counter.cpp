@@ -0,0 +1,52 @@
+#include "allocation_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+  std::atomic<uint64_t> g_allocationCount {0};
+  std::atomic<uint64_t> g_allocatedBytes {0};
+
+  auto allocate (std::size_t size) -> void*
+  {
+    g_allocationCount.fetch_add (1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add (size, std::memory_order_relaxed);
+    if (auto* p = std::malloc (size == 0 ? 1 : size))
+      return p;
+    throw std::bad_alloc ();
+  }
+}
+
+namespace moose::test
+{
+  auto allocationCount () -> uint64_t
+  {
+    return g_allocationCount.load (std::memory_order_relaxed);
+  }
+
+  auto allocatedBytes () -> uint64_t
+  {
+    return g_allocatedBytes.load (std::memory_order_relaxed);
+  }
+}
+
+void* operator new (std::size_t size) {return allocate (size);}
+void* operator new [] (std::size_t size) {return allocate (size);}
+void* operator new (std::size_t size, std::nothrow_t const&) noexcept
+{
+  try {return allocate (size);}
+  catch (std::bad_alloc const&) {return nullptr;}
+}
+void* operator new [] (std::size_t size, std::nothrow_t const&) noexcept
+{
+  try {return allocate (size);}
+  catch (std::bad_alloc const&) {return nullptr;}
+}
+void operator delete (void* p) noexcept {std::free (p);}
+void operator delete [] (void* p) noexcept {std::free (p);}
+void operator delete (void* p, std::size_t) noexcept {std::free (p);}
+void operator delete [] (void* p, std::size_t) noexcept {std::free (p);}
+void operator delete (void* p, std::nothrow_t const&) noexcept {std::free (p);}
+void operator delete [] (void* p, std::nothrow_t const&) noexcept {std::free (p);}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+/** Counts the calls to the global allocation functions.
+  Linking `allocation_counter.cpp` into an executable replaces the global `operator new` and
+  `operator delete` of that executable and of the libraries it loads. Both the tests and the
+  benchmarks use it to observe the allocations of the archives.*/
+namespace moose::test
+{
+  /// Total number of allocations since the start of the program.
+  auto allocationCount () -> uint64_t;
+
+  /// Total number of bytes allocated since the start of the program.
+  auto allocatedBytes () -> uint64_t;
+
+  /// Measures the allocations which happen during its lifetime.
+  class AllocationCounter
+  {
+  public:
+    AllocationCounter () : mCount {allocationCount ()}, mBytes {allocatedBytes ()} {}
+
+    /// Number of allocations since construction.
+    auto allocations () const -> uint64_t {return allocationCount () - mCount;}
+
+    /// Number of bytes allocated since construction.
+    auto bytes () const -> uint64_t {return allocatedBytes () - mBytes;}
+
+  private:
+    uint64_t mCount;
+    uint64_t mBytes;
+  };
+}
@@ -0,0 +1,176 @@
+#include <moose/stl_serialization.h>
+
+#include "allocation_counter.h"
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+using namespace moose;
+
+namespace
+{
+  /// Names are longer than the small string buffers of the standard libraries.
+  struct Record
+  {
+    int mId {0};
+    double mValue {0};
+    bool mFlag {false};
+    std::string mTag;
+    std::array<int, 3> mCoordinates {};
+
+    auto operator <=> (Record const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("identifierOfTheRecord", mId);
+      ar ("valueOfTheRecord", mValue);
+      ar ("flagOfTheRecord", mFlag);
+      ar ("tagOfTheRecord", mTag);
+      ar ("coordinatesOfTheRecord", mCoordinates);
+    }
+  };
+
+  /// Members without names are stored with generated names in json.
+  struct Unnamed
+  {
+    int mA {0};
+    int mB {0};
+
+    auto operator <=> (Unnamed const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("", mA);
+      ar ("", mB);
+    }
+  };
+
+  template <class T>
+  struct Records
+  {
+    std::vector<T> mRecords;
+
+    void serialize (Archive& ar)
+    {
+      ar ("records", mRecords);
+    }
+  };
+
+  template <class T>
+  auto makeRecords (size_t n) -> Records<T>
+  {
+    Records<T> records;
+    records.mRecords.resize (n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      if constexpr (std::is_same_v<T, Record>)
+        records.mRecords [i] = {static_cast<int> (i), 0.5 * static_cast<double> (i), i % 2 == 0, "short", {1, 2, 3}};
+      else
+        records.mRecords [i] = {static_cast<int> (i), -static_cast<int> (i)};
+    }
+    return records;
+  }
+
+  /** Returns the number of additional allocations which `count` needs for `2n` instead of `n`
+    records. Containers which grow geometrically contribute a constant, while any allocation per
+    entry makes the difference grow with `n`.*/
+  template <class T, class COUNT>
+  auto marginalAllocations (size_t n, COUNT count) -> uint64_t
+  {
+    auto const small = count (makeRecords<T> (n));
+    auto const large = count (makeRecords<T> (2 * n));
+    return large > small ? large - small : 0;
+  }
+
+  template <class T>
+  auto countBinaryWrite (Records<T> const& records, BinaryOptions options) -> uint64_t
+  {
+    test::AllocationCounter const counter;
+    toBinary (records, options);
+    return counter.allocations ();
+  }
+
+  template <class T>
+  auto countBinaryRead (Records<T> const& records, BinaryOptions options) -> uint64_t
+  {
+    auto const binary = toBinary (records, options);
+    Records<T> restored;
+    test::AllocationCounter const counter;
+    fromBinary (restored, binary, options);
+    auto const allocations = counter.allocations ();
+    EXPECT_EQ (records.mRecords, restored.mRecords);
+    return allocations;
+  }
+
+  template <class T>
+  auto countJsonWrite (Records<T> const& records) -> uint64_t
+  {
+    test::AllocationCounter const counter;
+    toJson ("records", records);
+    return counter.allocations ();
+  }
+
+  template <class T>
+  auto countJsonRead (Records<T> const& records) -> uint64_t
+  {
+    auto const json = toJson ("records", records);
+    Records<T> restored;
+    test::AllocationCounter const counter;
+    fromJson (restored, "records", json.c_str ());
+    auto const allocations = counter.allocations ();
+    EXPECT_EQ (records.mRecords, restored.mRecords);
+    return allocations;
+  }
+
+  constexpr size_t numRecords = 1000;
+  constexpr uint64_t maxMarginalAllocations = 8;
+}
+
+TEST (allocations, counterObservesAllocations)
+{
+  test::AllocationCounter const counter;
+  auto const p = std::make_unique<std::array<char, 100>> ();
+  EXPECT_EQ (counter.allocations (), 1u);
+  EXPECT_GE (counter.bytes (), 100u);
+}
+
+TEST (allocations, binaryWriter)
+{
+  for (auto const encoding : {IntegerEncoding::Fixed, IntegerEncoding::Varint})
+  {
+    BinaryOptions const options {encoding};
+    EXPECT_LE (marginalAllocations<Record> (numRecords, [&] (auto const& r) {return countBinaryWrite (r, options);}),
+               maxMarginalAllocations);
+    EXPECT_LE (marginalAllocations<Unnamed> (numRecords, [&] (auto const& r) {return countBinaryWrite (r, options);}),
+               maxMarginalAllocations);
+  }
+}
+
+TEST (allocations, binaryReader)
+{
+  for (auto const encoding : {IntegerEncoding::Fixed, IntegerEncoding::Varint})
+  {
+    BinaryOptions const options {encoding};
+    EXPECT_LE (marginalAllocations<Record> (numRecords, [&] (auto const& r) {return countBinaryRead (r, options);}),
+               maxMarginalAllocations);
+    EXPECT_LE (marginalAllocations<Unnamed> (numRecords, [&] (auto const& r) {return countBinaryRead (r, options);}),
+               maxMarginalAllocations);
+  }
+}
+
+TEST (allocations, jsonWriter)
+{
+  EXPECT_LE (marginalAllocations<Record> (numRecords, [] (auto const& r) {return countJsonWrite (r);}),
+             maxMarginalAllocations);
+  EXPECT_LE (marginalAllocations<Unnamed> (numRecords, [] (auto const& r) {return countJsonWrite (r);}),
+             maxMarginalAllocations);
+}
+
+TEST (allocations, jsonReader)
+{
+  // The parsed document allocates in large chunks, the reader itself must not allocate per entry.
+  EXPECT_LE (marginalAllocations<Record> (numRecords, [] (auto const& r) {return countJsonRead (r);}),
+             maxMarginalAllocations);
+  EXPECT_LE (marginalAllocations<Unnamed> (numRecords, [] (auto const& r) {return countJsonRead (r);}),
+             maxMarginalAllocations);
+}
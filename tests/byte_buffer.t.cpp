@@ -0,0 +1,85 @@
+#include <moose/stl_serialization.h>
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+using namespace moose;
+
+namespace
+{
+  struct Message
+  {
+    int mId {0};
+    std::string mTopic;
+    std::vector<double> mPayload;
+
+    auto operator <=> (Message const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("id", mId);
+      ar ("topic", mTopic);
+      ar ("payload", mPayload);
+    }
+  };
+
+  auto makeMessage (int id) -> Message
+  {
+    return {id, "topic" + std::to_string (id), std::vector<double> (100, 0.5 * id)};
+  }
+
+  auto asString (std::vector<std::byte> const& bytes) -> std::string
+  {
+    return {reinterpret_cast<char const*> (bytes.data ()), bytes.size ()};
+  }
+}
+
+TEST (byteBuffer, writeRead)
+{
+  auto const message = makeMessage (1);
+  for (auto const& options : {BinaryOptions {}, BinaryOptions {.integerEncoding = IntegerEncoding::Varint},
+                              BinaryOptions {.tagged = true}, BinaryOptions {.index = true}})
+  {
+    auto const bytes = toBinaryBytes (message, options);
+    EXPECT_EQ (asString (bytes), toBinary (message, options)->str ());
+    EXPECT_EQ (message, fromBinary<Message> (bytes, options));
+  }
+}
+
+TEST (byteBuffer, appendsAndReusesCapacity)
+{
+  std::vector<std::byte> bytes;
+  bytes.reserve (4096);
+  auto const* const data = bytes.data ();
+
+  bytes.push_back (std::byte {7});
+  toBinary (makeMessage (1), bytes);
+  EXPECT_EQ (bytes.front (), std::byte {7});
+  EXPECT_EQ (makeMessage (1), fromBinary<Message> (std::span {bytes}.subspan (1)));
+
+  bytes.clear ();
+  toBinary (makeMessage (2), bytes);
+  EXPECT_EQ (bytes.data (), data);
+  EXPECT_EQ (makeMessage (2), fromBinary<Message> (bytes));
+}
+
+TEST (byteBuffer, writer)
+{
+  ByteBuffer buffer {256};
+  {
+    Archive archive {std::make_shared<BinaryWriter<ByteBuffer>> (buffer)};
+    archive ("first", makeMessage (1));
+    archive ("second", makeMessage (2));
+  }
+
+  auto const bytes = buffer.take ();
+  EXPECT_TRUE (buffer.bytes ().empty ());
+
+  Archive archive {std::make_shared<BinaryReader> (std::span {bytes})};
+  Message first, second;
+  archive ("first", first);
+  archive ("second", second);
+  EXPECT_EQ (makeMessage (1), first);
+  EXPECT_EQ (makeMessage (2), second);
+}
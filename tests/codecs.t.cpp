@@ -0,0 +1,283 @@
+#include <moose/stl_serialization.h>
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+using namespace moose;
+
+namespace
+{
+  template <class C>
+  struct Series
+  {
+    C mValues;
+    Hint mHint {Hint::None};
+
+    void serialize (Archive& ar)
+    {
+      ar ("values", mValues, mHint);
+    }
+  };
+
+  template <class C>
+  auto encodeAndBack (C const& values, Hint hint, BinaryOptions options = {IntegerEncoding::Fixed}) -> C
+  {
+    auto const binary = toBinary (Series<C> {values, hint}, options);
+    return fromBinary<Series<C>> (binary, options).mValues;
+  }
+
+  template <class C>
+  auto encodedSize (C const& values, Hint hint) -> size_t
+  {
+    return toBinary (Series<C> {values, hint}, {IntegerEncoding::Fixed})->str ().size ();
+  }
+
+  auto makeTimestamps (size_t n) -> std::vector<int64_t>
+  {
+    std::vector<int64_t> timestamps;
+    int64_t t = 1700000000000;
+    for (size_t i = 0; i < n; ++i)
+    {
+      t += 10 + static_cast<int64_t> (i % 7);
+      timestamps.push_back (t);
+    }
+    return timestamps;
+  }
+
+  auto makeSignal (size_t n) -> std::vector<double>
+  {
+    std::vector<double> signal;
+    for (size_t i = 0; i < n; ++i)
+      signal.push_back (20.0 + 0.25 * static_cast<double> ((i / 8) % 16));
+    return signal;
+  }
+}
+
+TEST (codecs, delta)
+{
+  auto const timestamps = makeTimestamps (1000);
+  EXPECT_EQ (timestamps, encodeAndBack (timestamps, Hint::Delta));
+  EXPECT_EQ (timestamps, encodeAndBack (timestamps, Hint::Delta, {IntegerEncoding::Varint}));
+  EXPECT_LT (encodedSize (timestamps, Hint::Delta), timestamps.size () + 32);
+
+  std::vector<int> const mixed {5, -3, std::numeric_limits<int>::max (), std::numeric_limits<int>::min (), 0};
+  EXPECT_EQ (mixed, encodeAndBack (mixed, Hint::Delta));
+
+  std::vector<uint64_t> const large {0, std::numeric_limits<uint64_t>::max (), 1, 1ull << 63};
+  EXPECT_EQ (large, encodeAndBack (large, Hint::Delta));
+
+  std::vector<char> const chars {'a', 'b', 'c'};
+  EXPECT_EQ (chars, encodeAndBack (chars, Hint::Delta));
+
+  EXPECT_EQ (std::vector<int> {}, encodeAndBack (std::vector<int> {}, Hint::Delta));
+}
+
+TEST (codecs, xorFloat)
+{
+  auto const signal = makeSignal (1000);
+  EXPECT_EQ (signal, encodeAndBack (signal, Hint::XorFloat));
+  EXPECT_LT (encodedSize (signal, Hint::XorFloat), signal.size () * sizeof (double) / 4);
+
+  std::vector<float> const floats {1.5f, 1.5f, -2.25f, 0.f, 1e-30f, 3e30f};
+  EXPECT_EQ (floats, encodeAndBack (floats, Hint::XorFloat));
+
+  std::vector<double> const special {std::numeric_limits<double>::infinity (), -0.0, std::nan (""), 1.0,
+                                     std::numeric_limits<double>::denorm_min ()};
+  auto const decoded = encodeAndBack (special, Hint::XorFloat);
+  ASSERT_EQ (special.size (), decoded.size ());
+  for (size_t i = 0; i < special.size (); ++i)
+    EXPECT_EQ (std::bit_cast<uint64_t> (special [i]), std::bit_cast<uint64_t> (decoded [i]));
+
+  EXPECT_EQ (std::vector<double> {}, encodeAndBack (std::vector<double> {}, Hint::XorFloat));
+  EXPECT_EQ (std::vector<double> {42.0}, encodeAndBack (std::vector<double> {42.0}, Hint::XorFloat));
+}
+
+TEST (codecs, runLength)
+{
+  std::vector<int> labels (1000, 3);
+  std::fill (labels.begin () + 500, labels.end (), -7);
+  EXPECT_EQ (labels, encodeAndBack (labels, Hint::RunLength));
+  EXPECT_EQ (labels, encodeAndBack (labels, Hint::RunLength, {IntegerEncoding::Varint}));
+  EXPECT_LT (encodedSize (labels, Hint::RunLength), size_t {32});
+
+  auto const signal = makeSignal (1000);
+  EXPECT_EQ (signal, encodeAndBack (signal, Hint::RunLength));
+  EXPECT_LT (encodedSize (signal, Hint::RunLength), signal.size () * sizeof (double) / 4);
+
+  std::vector<float> const floats {1.f, 1.f, 2.f};
+  EXPECT_EQ (floats, encodeAndBack (floats, Hint::RunLength));
+}
+
+TEST (codecs, float32)
+{
+  std::vector<double> const values {0.1, -1e20, 3.25, 1e-40, std::numeric_limits<double>::infinity ()};
+  auto const decoded = encodeAndBack (values, Hint::Float32);
+  ASSERT_EQ (values.size (), decoded.size ());
+  for (size_t i = 0; i < values.size (); ++i)
+    EXPECT_EQ (static_cast<double> (static_cast<float> (values [i])), decoded [i]);
+
+  auto const signal = makeSignal (1000);
+  EXPECT_LT (encodedSize (signal, Hint::Float32), signal.size () * sizeof (float) + 32);
+  EXPECT_EQ (std::vector<double> {}, encodeAndBack (std::vector<double> {}, Hint::Float32));
+
+  // arrays with finite values beyond the single precision range are stored with full precision
+  std::vector<double> const large {0.1, 1e300};
+  EXPECT_EQ (large, encodeAndBack (large, Hint::Float32));
+}
+
+TEST (codecs, float16)
+{
+  std::vector<float> const exact {0.f, -0.f, 1.f, -2.5f, 65504.f, 0.000061035156f, 5.9604645e-8f, 1023.5f};
+  EXPECT_EQ (exact, encodeAndBack (exact, Hint::Float16));
+
+  // ties are rounded to even, infinite values are kept
+  std::vector<float> const rounded {2049.f, 2051.f, 1e-9f, -std::numeric_limits<float>::infinity ()};
+  std::vector<float> const expected {2048.f, 2052.f, 0.f, -std::numeric_limits<float>::infinity ()};
+  EXPECT_EQ (expected, encodeAndBack (rounded, Hint::Float16));
+
+  // arrays with finite values beyond the half precision range are stored with full precision
+  std::vector<float> const large {0.1f, 1e5f, -65520.f};
+  EXPECT_EQ (large, encodeAndBack (large, Hint::Float16));
+  EXPECT_TRUE (std::isnan (encodeAndBack (std::vector<double> {std::nan ("")}, Hint::Float16) [0]));
+
+  for (uint16_t half = 0; half < 0x7C00; ++half)
+    EXPECT_EQ (half, detail::toHalf (detail::fromHalf (half)));
+
+  auto const signal = makeSignal (1000);
+  EXPECT_EQ (signal, encodeAndBack (signal, Hint::Float16));
+  EXPECT_LT (encodedSize (signal, Hint::Float16), signal.size () * sizeof (uint16_t) + 32);
+}
+
+TEST (codecs, quantized16)
+{
+  std::vector<double> values;
+  for (int i = 0; i < 1000; ++i)
+    values.push_back (std::sin (0.01 * i) * 100.0);
+
+  auto const decoded = encodeAndBack (values, Hint::Quantized16);
+  ASSERT_EQ (values.size (), decoded.size ());
+  for (size_t i = 0; i < values.size (); ++i)
+    EXPECT_NEAR (values [i], decoded [i], 200.0 / 65535.0);
+  EXPECT_LT (encodedSize (values, Hint::Quantized16), values.size () * sizeof (uint16_t) + 48);
+
+  std::vector<float> const constant (10, 7.5f);
+  EXPECT_EQ (constant, encodeAndBack (constant, Hint::Quantized16));
+
+  // arrays with values which are not finite are stored without quantization
+  std::vector<double> const special {1.0, std::numeric_limits<double>::infinity ()};
+  EXPECT_EQ (special, encodeAndBack (special, Hint::Quantized16));
+}
+
+TEST (codecs, precisionInJson)
+{
+  Series<std::vector<double>> const series {{0.1, 1.0 / 3.0, 42.0}, Hint::Float32};
+  auto const json = toJson ("series", series);
+  EXPECT_NE (json.find ("0.1,"), std::string::npos);
+  EXPECT_NE (json.find ("0.33333334"), std::string::npos);
+  EXPECT_NE (json.find ("42"), std::string::npos);
+
+  auto const half = toJson ("series", Series<std::vector<double>> {{1.0 / 3.0, 123456.0}, Hint::Float16});
+  EXPECT_NE (half.find ("0.33333,"), std::string::npos);
+  EXPECT_NE (half.find ("123456"), std::string::npos);
+
+  auto const large = toJson ("series", Series<std::vector<double>> {{1e300}, Hint::Float32});
+  EXPECT_NE (large.find ("1e+300"), std::string::npos);
+
+  auto const read = fromJson<Series<std::vector<double>>> ("series", json.c_str ()).mValues;
+  EXPECT_FLOAT_EQ (read [1], 1.0f / 3.0f);
+}
+
+TEST (codecs, elementWiseReading)
+{
+  BinaryOptions const fixed {IntegerEncoding::Fixed};
+  auto const binary = toBinary (Series<std::vector<int>> {{1, 2, 3, 5, 8}, Hint::Delta}, fixed);
+  auto const values = fromBinary<Series<std::set<int>>> (binary, fixed).mValues;
+  EXPECT_EQ ((std::set<int> {1, 2, 3, 5, 8}), values);
+}
+
+TEST (codecs, inapplicableHintsAreIgnored)
+{
+  std::vector<int> const ints {1, 2, 3};
+  EXPECT_EQ (ints, encodeAndBack (ints, Hint::XorFloat));
+
+  std::vector<double> const doubles {1.5, 2.5};
+  EXPECT_EQ (doubles, encodeAndBack (doubles, Hint::Delta));
+
+  auto const json = toJson ("series", Series<std::vector<int>> {ints, Hint::Delta});
+  EXPECT_EQ (ints, (fromJson<Series<std::vector<int>>> ("series", json.c_str ()).mValues));
+}
+
+TEST (codecs, legacyDataHasNoCodecs)
+{
+  // Readers of earlier versions only know the markers of elements and the end of arrays.
+  auto const legacy = [] (auto const& values, Hint hint)
+  {
+    return toBinary (Series<std::decay_t<decltype (values)>> {values, hint})->str ();
+  };
+
+  auto const signal = makeSignal (100);
+  for (auto const hint : {Hint::XorFloat, Hint::RunLength, Hint::Float32, Hint::Float16, Hint::Quantized16})
+  {
+    EXPECT_EQ (legacy (signal, Hint::None), legacy (signal, hint));
+    EXPECT_EQ (signal, encodeAndBack (signal, hint, {}));
+  }
+
+  auto const timestamps = makeTimestamps (100);
+  for (auto const hint : {Hint::Delta, Hint::RunLength})
+  {
+    EXPECT_EQ (legacy (timestamps, Hint::None), legacy (timestamps, hint));
+    EXPECT_EQ (timestamps, encodeAndBack (timestamps, hint, {}));
+  }
+}
+
+TEST (codecs, malformedBlockIsRejected)
+{
+  BinaryOptions const fixed {IntegerEncoding::Fixed};
+  auto binary = toBinary (Series<std::vector<double>> {makeSignal (100), Hint::XorFloat}, fixed)->str ();
+  binary.resize (binary.size () - 4);
+  auto const truncated = std::make_shared<std::stringstream> (binary);
+  EXPECT_THROW (fromBinary<Series<std::vector<double>>> (truncated, fixed), ArchiveError);
+}
+
+TEST (codecs, corruptSizeIsRejected)
+{
+  // The size is checked against the encoded block before any value is allocated.
+  BinaryOptions const fixed {IntegerEncoding::Fixed};
+  auto const corrupt = [&fixed] (auto const& series)
+  {
+    auto binary = toBinary (series, fixed)->str ();
+    for (std::size_t i = 1; i < 9; ++i)
+      binary [i] = 0x7F;
+    return std::make_shared<std::stringstream> (binary);
+  };
+
+  for (auto const hint : {Hint::XorFloat, Hint::Float32, Hint::Float16, Hint::Quantized16, Hint::RunLength})
+  {
+    using Doubles = Series<std::vector<double>>;
+    EXPECT_THROW (fromBinary<Doubles> (corrupt (Doubles {makeSignal (100), hint}), fixed), ArchiveError);
+  }
+  for (auto const hint : {Hint::Delta, Hint::RunLength})
+  {
+    using Integers = Series<std::vector<int64_t>>;
+    EXPECT_THROW (fromBinary<Integers> (corrupt (Integers {makeTimestamps (100), hint}), fixed), ArchiveError);
+  }
+}
+
+TEST (codecs, partialAndWholeReadsAgree)
+{
+  BinaryOptions const fixed {IntegerEncoding::Fixed};
+  auto const signal = makeSignal (1000);
+  for (auto const hint : {Hint::XorFloat, Hint::Float32, Hint::RunLength})
+  {
+    auto const binary = toBinary (Series<std::vector<double>> {signal, hint}, fixed);
+    auto const whole = fromBinary<Series<std::vector<double>>> (std::make_shared<std::stringstream> (binary->str ()), fixed);
+    auto const elements = fromBinary<Series<std::set<double>>> (binary, fixed);
+    EXPECT_EQ (whole.mValues, signal);
+    EXPECT_EQ (elements.mValues, (std::set<double> {signal.begin (), signal.end ()}));
+  }
+}
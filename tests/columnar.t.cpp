@@ -0,0 +1,193 @@
+#include <moose/stl_serialization.h>
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+using namespace moose;
+
+namespace
+{
+  struct Particle
+  {
+    double x {0};
+    double y {0};
+    int id {0};
+    std::string name;
+    std::array<float, 3> color {};
+
+    auto operator <=> (Particle const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("x", x);
+      ar ("y", y);
+      ar ("id", id);
+      ar ("name", name);
+      ar ("color", color);
+    }
+  };
+
+  struct Labeled
+  {
+    std::optional<int> label;
+
+    auto operator <=> (Labeled const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("label", label);
+    }
+  };
+
+  template <class T>
+  struct Columns
+  {
+    std::vector<T> mElements;
+    std::vector<T> mRows;
+
+    auto operator <=> (Columns const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("elements", mElements, Hint::Columnar);
+      ar ("rows", mRows);
+    }
+  };
+
+  auto makeParticles (size_t n) -> std::vector<Particle>
+  {
+    std::vector<Particle> particles;
+    for (size_t i = 0; i < n; ++i)
+    {
+      auto const d = static_cast<double> (i);
+      auto const f = static_cast<float> (i);
+      particles.push_back ({d, -d, static_cast<int> (i), "p" + std::to_string (i), {f, f, f}});
+    }
+    return particles;
+  }
+
+  auto contains (std::string const& bytes, void const* data, size_t size) -> bool
+  {
+    return bytes.find (std::string (static_cast<char const*> (data), size)) != std::string::npos;
+  }
+}
+
+TEST (columnar, writeRead)
+{
+  Columns<Particle> columns {makeParticles (50), makeParticles (3)};
+  EXPECT_EQ (columns, toBinaryAndBack (columns));
+  EXPECT_EQ (columns, toBinaryAndBack (columns, {IntegerEncoding::Varint}));
+  EXPECT_EQ (columns, toJsonAndBack (columns));
+}
+
+TEST (columnar, empty)
+{
+  Columns<Particle> columns;
+  EXPECT_EQ (columns, toBinaryAndBack (columns));
+}
+
+TEST (columnar, valuesOfOneMemberAreContiguous)
+{
+  Columns<Particle> columns {makeParticles (4), {}};
+  auto const binary = toBinary (columns, {IntegerEncoding::Fixed})->str ();
+
+  int32_t const ids [] = {0, 1, 2, 3};
+  EXPECT_TRUE (contains (binary, ids, sizeof (ids)));
+
+  double const xs [] = {0, 1, 2, 3};
+  EXPECT_TRUE (contains (binary, xs, sizeof (xs)));
+}
+
+TEST (columnar, differingElementsAreStoredAsRows)
+{
+  Columns<Labeled> columns {{{1}, {}, {3}}, {{}, {5}}};
+  EXPECT_EQ (columns, toBinaryAndBack (columns));
+  EXPECT_EQ (columns, toBinaryAndBack (columns, {IntegerEncoding::Varint}));
+}
+
+TEST (columnar, valuesAndNestedContainers)
+{
+  Columns<std::string> strings {{"a", "bc", "def"}, {"g"}};
+  EXPECT_EQ (strings, toBinaryAndBack (strings));
+
+  Columns<std::vector<int>> vectors {{{1, 2}, {}, {3, 4, 5}}, {{6}}};
+  EXPECT_EQ (vectors, toBinaryAndBack (vectors));
+  EXPECT_EQ (vectors, toBinaryAndBack (vectors, {IntegerEncoding::Varint}));
+
+  Columns<std::set<int>> sets {{{1, 2}, {}, {3}}, {{4}}};
+  EXPECT_EQ (sets, toBinaryAndBack (sets));
+
+  Columns<int> numbers {{1, 2, 3}, {4}};
+  EXPECT_EQ (numbers, toBinaryAndBack (numbers));
+}
+
+TEST (columnar, elementsBeyondLimitAreStoredAsRows)
+{
+  BinaryOptions options {IntegerEncoding::Fixed};
+  options.columnarLimit = 1024;
+
+  Columns<Particle> columns {makeParticles (50), {}};
+  Columns<Particle> rows {{}, makeParticles (50)};
+  auto const binary = toBinary (columns, options)->str ();
+  EXPECT_EQ (binary.size (), toBinary (rows, options)->str ().size ());
+  EXPECT_EQ (columns, toBinaryAndBack (columns, options));
+  EXPECT_EQ (columns, toBinaryAndBack (columns, {.integerEncoding = IntegerEncoding::Varint, .columnarLimit = 1024}));
+
+  // Small arrays are still stored as columns.
+  int32_t const ids [] = {0, 1, 2, 3};
+  Columns<Particle> small {makeParticles (4), {}};
+  EXPECT_TRUE (contains (toBinary (small, options)->str (), ids, sizeof (ids)));
+}
+
+TEST (columnar, indexedElementsBeyondLimit)
+{
+  BinaryOptions options {IntegerEncoding::Fixed};
+  options.columnarLimit = 1024;
+  options.index = true;
+  options.indexStride = 4;
+
+  auto const particles = makeParticles (50);
+  auto const out = std::make_shared<std::stringstream> ();
+  {
+    Archive archive {std::make_shared<BinaryWriter<std::stringstream>> (out, options)};
+    archive ("particles", particles, Hint::Columnar);
+  }
+
+  auto const reader = std::make_shared<BinaryReader> (out, options);
+  auto const elements = fromBinaryElements<Particle> (reader, "particles", 9, 30);
+  EXPECT_EQ (elements, (std::vector<Particle> {particles.begin () + 9, particles.begin () + 39}));
+}
+
+TEST (columnar, corruptSizesInHeader)
+{
+  Columns<Particle> const columns {makeParticles (4), {}};
+  BinaryOptions const options {IntegerEncoding::Fixed};
+  auto const binary = toBinary (columns, options)->str ();
+
+  // The header consists of the marker, the number of elements and the size of the shape.
+  std::string header (1, static_cast<char> (5));
+  uint64_t const count = 4;
+  header.append (reinterpret_cast<char const*> (&count), sizeof (count));
+  auto const begin = binary.find (header);
+  ASSERT_NE (begin, std::string::npos);
+
+  uint64_t shapeSize;
+  auto const shapeAt = begin + header.size ();
+  std::memcpy (&shapeSize, binary.data () + shapeAt, sizeof (shapeSize));
+  auto const columnCountAt = shapeAt + sizeof (shapeSize) + shapeSize;
+  auto const firstColumnAt = columnCountAt + sizeof (uint64_t);
+
+  for (auto const at : {shapeAt, columnCountAt, firstColumnAt})
+  {
+    auto corrupt = binary;
+    uint64_t const huge = uint64_t {1} << 60;
+    std::memcpy (corrupt.data () + at, &huge, sizeof (huge));
+
+    auto const* const bytes = reinterpret_cast<std::byte const*> (corrupt.data ());
+    EXPECT_THROW (fromBinary<Columns<Particle>> (std::span {bytes, corrupt.size ()}, options), ArchiveError);
+    EXPECT_THROW (fromBinary<Columns<Particle>> (std::make_shared<std::stringstream> (corrupt), options), ArchiveError);
+  }
+}
@@ -0,0 +1,151 @@
+#include <moose/stl_serialization.h>
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+using namespace moose;
+
+namespace
+{
+  struct Parameters
+  {
+    std::string mSolver;
+    double mTolerance {0};
+    std::vector<int> mLevels;
+
+    auto operator <=> (Parameters const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("solver", mSolver);
+      ar ("tolerance", mTolerance);
+      ar ("levels", mLevels);
+    }
+  };
+
+  struct Run
+  {
+    int mId {0};
+    Parameters mParameters;
+    std::vector<double> mWeights;
+
+    auto operator <=> (Run const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("id", mId);
+      ar ("parameters", mParameters);
+      ar ("weights", mWeights, Hint::Columnar);
+    }
+  };
+
+  struct Study
+  {
+    std::vector<Run> mRuns;
+    std::vector<std::vector<Run>> mGroups;
+
+    auto operator <=> (Study const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("runs", mRuns);
+      ar ("groups", mGroups);
+    }
+  };
+
+  auto makeStudy () -> Study
+  {
+    Parameters const coarse {"multigrid", 1e-6, {1, 2, 4, 8, 16, 32}};
+    Parameters const fine {"cg", 1e-10, {64, 128, 256}};
+    std::vector<double> const weights {0.25, 0.5, 0.25, 0.125, 0.0625};
+
+    Study study;
+    for (int i = 0; i < 200; ++i)
+      study.mRuns.push_back ({i, i % 2 == 0 ? coarse : fine, weights});
+
+    std::vector<Run> group;
+    for (int i = 0; i < 5; ++i)
+      group.push_back ({i, coarse, weights});
+    study.mGroups.assign (10, group);
+    return study;
+  }
+
+  BinaryOptions const dedup {IntegerEncoding::Fixed, nullptr, 32};
+}
+
+TEST (dedup, writeRead)
+{
+  auto const study = makeStudy ();
+  EXPECT_EQ (study, toBinaryAndBack (study, dedup));
+  EXPECT_EQ (study, toBinaryAndBack (study, {IntegerEncoding::Varint, nullptr, 32}));
+  EXPECT_EQ (study, toBinaryAndBack (study, {IntegerEncoding::Fixed, nullptr, 1}));
+}
+
+TEST (dedup, repeatedSubtreesAreStoredOnce)
+{
+  auto const study = makeStudy ();
+  auto const plain = toBinary (study)->str ().size ();
+  auto const deduplicated = toBinary (study, dedup)->str ().size ();
+  EXPECT_LT (deduplicated, plain / 4);
+
+  // Repeated groups collapse to a reference each.
+  auto withoutGroups = study;
+  withoutGroups.mGroups.resize (1);
+  EXPECT_LT (deduplicated - toBinary (withoutGroups, dedup)->str ().size (), size_t {9 * 8});
+}
+
+TEST (dedup, secondOccurrenceIsReferenced)
+{
+  // The second occurrence stores its children as references, but is still a repetition of the first.
+  auto const study = makeStudy ();
+  auto groups = decltype (study.mGroups) {{study.mRuns.front ()}};
+  auto const single = toBinary (groups, dedup)->str ().size ();
+
+  groups.push_back (groups.front ());
+  auto const twice = toBinary (groups, dedup);
+  EXPECT_LE (twice->str ().size (), single + 2);
+  EXPECT_EQ (groups, fromBinary<decltype (groups)> (twice, dedup));
+}
+
+TEST (dedup, smallSubtreesAreInline)
+{
+  Parameters const parameters {"a", 1, {1}};
+  std::vector<Parameters> const repeated (10, parameters);
+  auto const plain = toBinary (repeated, {IntegerEncoding::Fixed})->str ().size ();
+  auto const deduplicated = toBinary (repeated, {IntegerEncoding::Fixed, nullptr, 1000})->str ().size ();
+  // Only the tags of the structs are added.
+  EXPECT_EQ (plain + repeated.size (), deduplicated);
+  EXPECT_EQ (repeated, toBinaryAndBack (repeated, {IntegerEncoding::Fixed, nullptr, 1000}));
+}
+
+TEST (dedup, readerRequiresOption)
+{
+  auto const binary = toBinary (makeStudy (), dedup);
+  EXPECT_THROW (fromBinary<Study> (binary), ArchiveError);
+}
+
+TEST (dedup, referencesToFlushedEntries)
+{
+  auto const study = makeStudy ();
+  auto const single = std::make_shared<std::stringstream> ();
+  auto const twice = std::make_shared<std::stringstream> ();
+  {
+    Archive archive {std::make_shared<BinaryWriter<std::stringstream>> (single, dedup)};
+    archive ("first", study.mRuns);
+  }
+  {
+    Archive archive {std::make_shared<BinaryWriter<std::stringstream>> (twice, dedup)};
+    archive ("first", study.mRuns);
+    archive ("second", study.mRuns);
+  }
+  // The second entry is a reference to the first.
+  EXPECT_LT (twice->str ().size (), single->str ().size () + 16);
+
+  Archive archive {std::make_shared<BinaryReader> (twice, dedup)};
+  decltype (study.mRuns) first, second;
+  archive ("first", first);
+  archive ("second", second);
+  EXPECT_EQ (study.mRuns, first);
+  EXPECT_EQ (study.mRuns, second);
+}
@@ -0,0 +1,169 @@
+#include <moose/encoding_cache.h>
+#include <moose/stl_serialization.h>
+#include <moose/types.h>
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+using namespace moose;
+
+namespace
+{
+  int g_tableSerializations = 0;
+
+  struct Table
+  {
+    std::vector<double> mValues;
+    std::string mName;
+    uint64_t mRevision {0};
+
+    bool operator == (Table const& other) const
+    {
+      return mValues == other.mValues && mName == other.mName;
+    }
+
+    void serialize (Archive& ar)
+    {
+      ++g_tableSerializations;
+      ar ("values", mValues);
+      ar ("name", mName);
+    }
+  };
+
+  struct Snapshot
+  {
+    int mStep {0};
+    Table mTable;
+    std::shared_ptr<Table> mShared;
+
+    bool operator == (Snapshot const& other) const
+    {
+      return mStep == other.mStep && mTable == other.mTable && *mShared == *other.mShared;
+    }
+
+    void serialize (Archive& ar)
+    {
+      ar ("step", mStep);
+      ar ("table", mTable);
+      ar ("shared", mShared);
+    }
+  };
+
+  bool const g_tableRegistered = []
+  {
+    types ().add<Table> ("EncodingCacheTable");
+    return true;
+  } ();
+
+  auto makeSnapshot () -> Snapshot
+  {
+    Table table {{1, 2, 3, 4}, "lookup"};
+    return {0, table, std::make_shared<Table> (Table {{5, 6}, "shared"})};
+  }
+}
+
+template <>
+struct moose::TypeTraits<Table>
+{
+  static constexpr EntryType entryType = EntryType::Struct;
+  static constexpr bool cacheEncoding = true;
+  static auto generation (Table const& table) -> uint64_t {return table.mRevision;}
+};
+
+TEST (encodingCache, splicesCachedEncodings)
+{
+  auto const cache = std::make_shared<EncodingCache> ();
+  BinaryOptions const options {IntegerEncoding::Fixed, cache};
+
+  auto snapshot = makeSnapshot ();
+  auto const uncached = toBinary (snapshot, {IntegerEncoding::Fixed})->str ();
+
+  g_tableSerializations = 0;
+  auto const first = toBinary (snapshot, options)->str ();
+  EXPECT_EQ (g_tableSerializations, 2);
+  EXPECT_EQ (cache->statistics ().misses, 2u);
+  EXPECT_EQ (cache->size (), 2u);
+
+  snapshot.mStep = 1;
+  auto const second = toBinary (snapshot, options);
+  EXPECT_EQ (g_tableSerializations, 2);
+  EXPECT_EQ (cache->statistics ().hits, 2u);
+
+  EXPECT_EQ (uncached, first);
+  EXPECT_EQ (snapshot, fromBinary<Snapshot> (second, options));
+}
+
+TEST (encodingCache, generationInvalidatesEncoding)
+{
+  auto const cache = std::make_shared<EncodingCache> ();
+  BinaryOptions const options {IntegerEncoding::Varint, cache};
+
+  auto snapshot = makeSnapshot ();
+  toBinary (snapshot, options);
+
+  snapshot.mTable.mValues.push_back (5);
+  ++snapshot.mTable.mRevision;
+  auto const binary = toBinary (snapshot, options);
+  EXPECT_EQ (cache->statistics ().hits, 1u);
+  EXPECT_EQ (snapshot, fromBinary<Snapshot> (binary, options));
+}
+
+TEST (encodingCache, formatsAreDistinguished)
+{
+  auto const cache = std::make_shared<EncodingCache> ();
+  auto const snapshot = makeSnapshot ();
+
+  toBinary (snapshot, {IntegerEncoding::Fixed, cache});
+  auto const varint = toBinary (snapshot, {IntegerEncoding::Varint, cache});
+  EXPECT_EQ (cache->statistics ().hits, 0u);
+  EXPECT_EQ (snapshot, fromBinary<Snapshot> (varint, {IntegerEncoding::Varint}));
+}
+
+TEST (encodingCache, optionsAreDistinguished)
+{
+  auto const cache = std::make_shared<EncodingCache> ();
+  auto const snapshot = makeSnapshot ();
+  auto constexpr foreignOrder = std::endian::native == std::endian::little ? std::endian::big : std::endian::little;
+
+  toBinary (snapshot, {IntegerEncoding::Legacy, cache});
+  BinaryOptions const swapped {.integerEncoding = IntegerEncoding::Fixed, .encodingCache = cache, .header = true,
+                               .byteOrder = foreignOrder};
+  auto const binary = toBinary (snapshot, swapped);
+  EXPECT_EQ (cache->statistics ().hits, 0u);
+  EXPECT_EQ (snapshot, fromBinary<Snapshot> (binary, {.header = true}));
+
+  toBinary (snapshot, {IntegerEncoding::Fixed, cache});
+  toBinary (snapshot, {.integerEncoding = IntegerEncoding::Fixed, .encodingCache = cache, .columnarLimit = 0});
+  EXPECT_EQ (cache->statistics ().hits, 0u);
+}
+
+TEST (encodingCache, sizeLimit)
+{
+  auto const snapshot = makeSnapshot ();
+
+  auto const tiny = std::make_shared<EncodingCache> (8);
+  toBinary (snapshot, {IntegerEncoding::Fixed, tiny});
+  EXPECT_EQ (tiny->size (), 0u);
+
+  auto const small = std::make_shared<EncodingCache> (80);
+  toBinary (snapshot, {IntegerEncoding::Fixed, small});
+  EXPECT_EQ (small->size (), 1u);
+  EXPECT_EQ (small->statistics ().evictions, 1u);
+  EXPECT_LE (small->size_in_bytes (), small->max_size_in_bytes ());
+}
+
+TEST (encodingCache, columnarArraysAreNotCached)
+{
+  auto const cache = std::make_shared<EncodingCache> ();
+  struct Tables
+  {
+    std::vector<Table> mTables;
+    void serialize (Archive& ar) {ar ("tables", mTables, Hint::Columnar);}
+  };
+
+  Tables const tables {{Table {{1}, "a"}, Table {{2}, "b"}}};
+  auto const binary = toBinary (tables, {IntegerEncoding::Fixed, cache});
+  EXPECT_EQ (cache->size (), 0u);
+  EXPECT_EQ (tables.mTables, fromBinary<Tables> (binary).mTables);
+}
@@ -35,3 +35,41 @@ TEST (enums, colorsWriteRead)
   EXPECT_EQ (expectedColors, toJsonAndBack (expectedColors));
   EXPECT_EQ (expectedColors, toBinaryAndBack (expectedColors));
 }
+
+enum class Shade
+{
+  Light,
+  Dark
+};
+
+template <>
+struct moose::TypeTraits<Shade>
+{
+  static constexpr EntryType entryType = EntryType::PerFormat;
+  template <Format format>
+  using Traits = std::conditional_t<format == Format::Binary, EnumToIntTraits<Shade>, EnumToStringTraits<Shade>>;
+};
+
+TEST (enums, perFormatTraits)
+{
+  std::vector<Shade> const shades {Shade::Dark, Shade::Light};
+  EXPECT_EQ (shades, toJsonAndBack (shades));
+  EXPECT_EQ (shades, toBinaryAndBack (shades));
+
+  EXPECT_NE (toJson ("shades", shades).find ("\"Dark\""), std::string::npos);
+
+  std::vector<int> const ints {1, 0};
+  EXPECT_EQ (toBinary (ints)->str (), toBinary (shades)->str ());
+}
+
+TEST (enums, archiveFormat)
+{
+  struct Probe
+  {
+    Format mFormat {Format::Other};
+    void serialize (Archive& ar) {mFormat = ar.format ();}
+  };
+
+  EXPECT_EQ (Format::Json, toJsonAndBack (Probe {}).mFormat);
+  EXPECT_EQ (Format::Binary, toBinaryAndBack (Probe {}).mFormat);
+}
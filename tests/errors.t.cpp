@@ -0,0 +1,146 @@
+#include <moose/stl_serialization.h>
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+using namespace moose;
+
+namespace
+{
+  struct Point
+  {
+    int x {0};
+    int y {0};
+
+    auto operator <=> (Point const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("x", x);
+      ar ("y", y);
+    }
+  };
+
+  struct Record
+  {
+    std::string name;
+    Point position {};
+    std::vector<int> tags;
+
+    auto operator <=> (Record const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("name", name);
+      ar ("position", position, Point {-1, -1});
+      ar ("tags", tags, std::vector<int> {});
+    }
+  };
+
+  struct Config
+  {
+    std::vector<Record> records;
+    std::array<int, 3> triple {};
+
+    void serialize (Archive& ar)
+    {
+      ar ("records", records);
+      ar ("triple", triple, std::array<int, 3> {7, 8, 9});
+    }
+  };
+
+  struct Throwing
+  {
+    void serialize (Archive&)
+    {
+      throw std::runtime_error {"not an archive error"};
+    }
+  };
+}
+
+TEST (errors, missingEntriesInsideDefaultedValues)
+{
+  auto const json = R"""({
+    "config": {
+      "records": [
+        {"name": "complete", "position": {"x": 1, "y": 2}, "tags": [1]},
+        {"name": "partial", "position": {"x": 3}},
+        {"name": "absent"}
+      ],
+      "triple": [1, 2]
+    }
+  })""";
+
+  auto const config = fromJson<Config> ("config", json);
+  ASSERT_EQ (config.records.size (), 3u);
+  EXPECT_EQ (config.records [0], (Record {"complete", {1, 2}, {1}}));
+  EXPECT_EQ (config.records [1], (Record {"partial", {-1, -1}, {}}));
+  EXPECT_EQ (config.records [2], (Record {"absent", {-1, -1}, {}}));
+  EXPECT_EQ (config.triple, (std::array<int, 3> {7, 8, 9}));
+}
+
+TEST (errors, missingMandatoryEntryThrows)
+{
+  auto const json = R"""({"config": {"records": [{"position": {"x": 1, "y": 2}}]}})""";
+  EXPECT_THROW (fromJson<Config> ("config", json), ArchiveError);
+}
+
+TEST (errors, contiguousRangeSizeMismatchInsideDefaultedValues)
+{
+  BinaryOptions options;
+  options.integerEncoding = IntegerEncoding::Fixed;
+  auto const binary = toBinary (std::vector<double> {1, 2, 3, 4}, options);
+
+  Archive archive {std::make_shared<BinaryReader> (binary, options)};
+  std::array<double, 3> triple {};
+  archive ("", triple, std::array<double, 3> {7, 8, 9});
+  EXPECT_EQ (triple, (std::array<double, 3> {7, 8, 9}));
+}
+
+TEST (errors, otherExceptionsLeaveDefaultScope)
+{
+  Archive archive {JSONReader::fromString (R"""({"throwing": {}})""")};
+  Throwing throwing;
+  EXPECT_THROW (archive ("throwing", throwing, Throwing {}), std::runtime_error);
+
+  int missing = 0;
+  EXPECT_THROW (archive ("missing", missing), ArchiveError);
+}
+
+TEST (errors, tryFromJson)
+{
+  Config config;
+  config.records = {{"a", {1, 2}, {3}}};
+  auto const json = toJson ("config", config);
+
+  auto const result = tryFromJson<Config> ("config", json.c_str ());
+  ASSERT_TRUE (result);
+  EXPECT_EQ (result->records, config.records);
+  EXPECT_TRUE (result.error ().empty ());
+
+  auto const missing = tryFromJson<Config> ("config", R"""({"config": {"records": [{"tags": []}]}})""");
+  EXPECT_FALSE (missing);
+  EXPECT_NE (missing.error ().find ("'name'"), std::string::npos);
+  EXPECT_THROW (missing.value (), ArchiveError);
+
+  EXPECT_FALSE (tryFromJson<Config> ("other", json.c_str ()));
+  EXPECT_FALSE (tryFromJson<Config> ("config", "{\"config\": "));
+}
+
+TEST (errors, tryFromBinary)
+{
+  Config config;
+  config.records = {{"a", {1, 2}, {3}}, {"b", {}, {}}};
+  auto const binary = toBinary (config);
+
+  auto const result = tryFromBinary<Config> (binary);
+  ASSERT_TRUE (result.has_value ());
+  EXPECT_EQ (result->records, config.records);
+
+  auto truncated = binary->str ();
+  truncated.resize (truncated.size () / 2);
+  auto const failed = tryFromBinary<Config> (std::make_shared<std::stringstream> (truncated));
+  EXPECT_FALSE (failed);
+  EXPECT_FALSE (failed.error ().empty ());
+}
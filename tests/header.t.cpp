@@ -0,0 +1,151 @@
+#include <moose/stl_serialization.h>
+#include <moose/detail/byte_order.h>
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+using namespace moose;
+
+namespace
+{
+  struct Point
+  {
+    float x {0};
+    float y {0};
+
+    auto operator <=> (Point const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("x", x);
+      ar ("y", y);
+    }
+  };
+}
+
+template <>
+struct moose::TypeTraits<Point>
+{
+  static constexpr EntryType entryType = EntryType::Struct;
+  static constexpr bool rawBinary = true;
+};
+
+namespace
+{
+  struct Sample
+  {
+    int mId {0};
+    double mValue {0};
+    std::string mName;
+    std::vector<double> mSignal;
+    std::vector<unsigned int> mCounts;
+    std::vector<int64_t> mTimes;
+    std::vector<double> mLevels;
+    std::vector<Point> mPoints;
+    Point mOrigin;
+
+    auto operator <=> (Sample const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("id", mId);
+      ar ("value", mValue);
+      ar ("name", mName);
+      ar ("signal", mSignal);
+      ar ("counts", mCounts);
+      ar ("times", mTimes, Hint::Delta);
+      ar ("levels", mLevels, Hint::RunLength);
+      ar ("points", mPoints);
+      ar ("origin", mOrigin);
+    }
+  };
+
+  auto makeSample () -> Sample
+  {
+    return {-7, 2.5, "sample", {0.25, -1.5, 1e300}, {1, 0x1234, 0xFFFFFFFF}, {1000, 1010, 1030}, {1.5, 1.5, 2.5},
+            {{1, 2}, {3, 4}, {5, 6}}, {7, 8}};
+  }
+
+  constexpr auto foreignOrder = std::endian::native == std::endian::little ? std::endian::big : std::endian::little;
+}
+
+TEST (header, writeRead)
+{
+  auto const sample = makeSample ();
+  for (auto const& options : {BinaryOptions {.header = true},
+                              BinaryOptions {.integerEncoding = IntegerEncoding::Varint, .header = true},
+                              BinaryOptions {.dedupThreshold = 8, .header = true},
+                              BinaryOptions {.tagged = true, .index = true, .header = true}})
+  {
+    auto const binary = toBinary (sample, options);
+    EXPECT_EQ (binary->str ().substr (0, 4), "MOOB");
+    EXPECT_EQ (sample, fromBinary<Sample> (binary, {.header = true}));
+  }
+}
+
+TEST (header, foreignByteOrder)
+{
+  auto const sample = makeSample ();
+  for (auto const encoding : {IntegerEncoding::Fixed, IntegerEncoding::Varint})
+  {
+    BinaryOptions const options {.integerEncoding = encoding, .header = true, .byteOrder = foreignOrder};
+    auto const binary = toBinaryBytes (sample, options);
+    EXPECT_EQ (sample, fromBinary<Sample> (binary, {.header = true}));
+    EXPECT_EQ (sample, fromBinary<Sample> (std::make_shared<std::stringstream> (toBinary (sample, options)->str ()),
+                                           {.header = true}));
+  }
+
+  struct Columns
+  {
+    std::vector<Sample> mSamples;
+    auto operator <=> (Columns const&) const = default;
+    void serialize (Archive& ar) {ar ("samples", mSamples, Hint::Columnar);}
+  };
+  Columns const columns {{sample, sample}};
+  EXPECT_EQ (columns, fromBinary<Columns> (toBinaryBytes (columns, {.header = true, .byteOrder = foreignOrder}),
+                                           {.header = true}));
+}
+
+TEST (header, foreignNumbersAreSwapped)
+{
+  std::vector<double> const values {1.0, 2.0};
+  auto const native = toBinary (values, {.header = true})->str ();
+  auto const foreign = toBinary (values, {.header = true, .byteOrder = foreignOrder})->str ();
+  ASSERT_EQ (native.size (), foreign.size ());
+
+  auto const swapped = detail::byteSwap (1.0);
+  char bytes [sizeof (double)];
+  std::memcpy (bytes, &swapped, sizeof (double));
+  EXPECT_NE (foreign.find (std::string (bytes, sizeof (double))), std::string::npos);
+}
+
+TEST (header, invalidHeadersAreRejected)
+{
+  auto const sample = makeSample ();
+  EXPECT_THROW (fromBinary<Sample> (toBinary (sample), {.header = true}), ArchiveError);
+  EXPECT_THROW (toBinary (sample, {.byteOrder = foreignOrder}), ArchiveError);
+
+  auto binary = toBinary (sample, {.header = true})->str ();
+  binary [4] = 2;
+  EXPECT_THROW (fromBinary<Sample> (std::make_shared<std::stringstream> (binary), {.header = true}), ArchiveError);
+  EXPECT_THROW (fromBinary<Sample> (std::span<std::byte const> {}, {.header = true}), ArchiveError);
+}
+
+TEST (header, byteSwapArray)
+{
+  std::vector<uint16_t> shorts {0x0102, 0x0304, 0x0506, 0x0708, 0x090A};
+  detail::byteSwapArray<2> (shorts.data (), shorts.size ());
+  EXPECT_EQ (shorts, (std::vector<uint16_t> {0x0201, 0x0403, 0x0605, 0x0807, 0x0A09}));
+
+  std::vector<uint32_t> ints {0x01020304, 0x05060708, 0x090A0B0C};
+  detail::byteSwapArray<4> (ints.data (), ints.size ());
+  EXPECT_EQ (ints, (std::vector<uint32_t> {0x04030201, 0x08070605, 0x0C0B0A09}));
+
+  std::vector<uint64_t> longs {0x0102030405060708ull};
+  detail::byteSwapArray<8> (longs.data (), longs.size ());
+  EXPECT_EQ (longs.front (), 0x0807060504030201ull);
+  EXPECT_EQ (detail::byteSwap (detail::byteSwap (-2.5)), -2.5);
+}
@@ -0,0 +1,146 @@
+#include <moose/stl_serialization.h>
+#include <moose/streaming.h>
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+using namespace moose;
+
+namespace
+{
+  struct Frame
+  {
+    int mStep {0};
+    std::vector<double> mValues;
+    std::string mLabel;
+
+    auto operator <=> (Frame const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("step", mStep);
+      ar ("values", mValues);
+      ar ("label", mLabel);
+    }
+  };
+
+  auto makeFrame (int step) -> Frame
+  {
+    return {step, std::vector<double> (static_cast<size_t> (step % 5), 0.5 * step), "frame" + std::to_string (step)};
+  }
+
+  auto makeFrames (int count) -> std::vector<Frame>
+  {
+    std::vector<Frame> frames;
+    for (int i = 0; i < count; ++i)
+      frames.push_back (makeFrame (i));
+    return frames;
+  }
+
+  auto writeArchive (std::vector<Frame> const& frames, BinaryOptions options) -> std::shared_ptr<std::stringstream>
+  {
+    auto out = std::make_shared<std::stringstream> ();
+    Archive archive {std::make_shared<BinaryWriter<std::stringstream>> (out, options)};
+    archive ("header", std::string {"frames"});
+    archive ("frames", frames);
+    archive ("streamed", generate (frames.size (), [i = 0] () mutable {return makeFrame (i++);}));
+    archive ("footer", 42);
+    return out;
+  }
+
+  /// Reads through a separate stream, like concurrent readers would.
+  auto readRange (std::shared_ptr<std::stringstream> const& data, BinaryOptions options, const char* name,
+                  std::size_t first, std::size_t count) -> std::vector<Frame>
+  {
+    auto reader = std::make_shared<BinaryReader> (std::make_shared<std::stringstream> (data->str ()), options);
+    return fromBinaryElements<Frame> (reader, name, first, count);
+  }
+
+  auto slice (std::vector<Frame> const& frames, std::size_t first, std::size_t count) -> std::vector<Frame>
+  {
+    auto const begin = frames.begin () + static_cast<std::ptrdiff_t> (first);
+    return {begin, begin + static_cast<std::ptrdiff_t> (count)};
+  }
+}
+
+TEST (index, entries)
+{
+  BinaryOptions const options {.index = true};
+  auto const frames = makeFrames (20);
+  auto const data = writeArchive (frames, options);
+  auto const reader = std::make_shared<BinaryReader> (data, options);
+
+  EXPECT_EQ (fromBinaryEntry<int> (reader, "footer"), 42);
+  EXPECT_EQ (fromBinaryEntry<std::vector<Frame>> (reader, "frames"), frames);
+  EXPECT_EQ (fromBinaryEntry<std::string> (reader, "header"), "frames");
+  EXPECT_EQ (fromBinaryEntry<std::vector<Frame>> (reader, "streamed"), frames);
+  EXPECT_THROW (fromBinaryEntry<int> (reader, "missing"), ArchiveError);
+
+  auto const& index = reader->index ();
+  ASSERT_EQ (index.entries.size (), 4u);
+  EXPECT_EQ (index.entries [1].type, ContentType::Array);
+  EXPECT_TRUE (index.entries [1].elementOffsets.empty ());
+}
+
+TEST (index, sequentialReading)
+{
+  BinaryOptions const options {.index = true, .indexStride = 3};
+  auto const frames = makeFrames (10);
+  Archive archive {std::make_shared<BinaryReader> (writeArchive (frames, options), options)};
+
+  std::string header;
+  std::vector<Frame> read;
+  int footer = 0;
+  archive ("header", header);
+  archive ("frames", read);
+  archive ("streamed", read);
+  archive ("footer", footer);
+  EXPECT_EQ (read, frames);
+  EXPECT_EQ (footer, 42);
+}
+
+TEST (index, elements)
+{
+  auto const frames = makeFrames (100);
+  for (auto const encoding : {IntegerEncoding::Fixed, IntegerEncoding::Varint})
+  {
+    BinaryOptions const options {.integerEncoding = encoding, .index = true, .indexStride = 8};
+    auto const data = writeArchive (frames, options);
+
+    EXPECT_EQ (readRange (data, options, "frames", 0, 3), slice (frames, 0, 3));
+    EXPECT_EQ (readRange (data, options, "frames", 21, 10), slice (frames, 21, 10));
+    EXPECT_EQ (readRange (data, options, "frames", 99, 1), slice (frames, 99, 1));
+    EXPECT_EQ (readRange (data, options, "streamed", 37, 20), slice (frames, 37, 20));
+    EXPECT_THROW (readRange (data, options, "frames", 95, 10), ArchiveError);
+    EXPECT_THROW (readRange (data, options, "frames", 100, 1), ArchiveError);
+    EXPECT_THROW (readRange (data, options, "header", 0, 1), ArchiveError);
+  }
+}
+
+TEST (index, taggedAndDeduplicated)
+{
+  auto frames = makeFrames (50);
+  std::fill (frames.begin () + 10, frames.begin () + 20, makeFrame (300));
+
+  for (auto const& options : {BinaryOptions {.tagged = true, .index = true, .indexStride = 4},
+                              BinaryOptions {.dedupThreshold = 16, .index = true, .indexStride = 4}})
+  {
+    auto const data = writeArchive (frames, options);
+    auto const reader = std::make_shared<BinaryReader> (data, options);
+    EXPECT_EQ (fromBinaryEntry<int> (reader, "footer"), 42);
+    EXPECT_EQ (fromBinaryEntry<std::vector<Frame>> (reader, "frames"), frames);
+    EXPECT_EQ (readRange (data, options, "frames", 9, 30), slice (frames, 9, 30));
+    EXPECT_EQ (readRange (data, options, "frames", 45, 5), slice (frames, 45, 5));
+  }
+}
+
+TEST (index, missingIndexIsRejected)
+{
+  auto const frames = makeFrames (5);
+  auto const data = writeArchive (frames, {});
+  EXPECT_THROW (BinaryReader (data, {.index = true}), ArchiveError);
+
+  auto const reader = std::make_shared<BinaryReader> (data);
+  EXPECT_THROW (fromBinaryEntry<int> (reader, "footer"), ArchiveError);
+}
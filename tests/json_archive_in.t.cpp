@@ -43,3 +43,56 @@ TEST_F (JSONArchiveInFixture, readArray)
   std::array<int, 2> const expectedA {100, 101};
   EXPECT_EQ (a, expectedA);
 }
+
+TEST_F (JSONArchiveInFixture, readMembersInAnyOrder)
+{
+  std::string s;
+  double d;
+  std::array<int, 2> a;
+  archive ("string", s);
+  archive ("double", d);
+  archive ("array", a);
+  archive ("string", s);
+  EXPECT_EQ (s, "test");
+  EXPECT_EQ (d, 123.321);
+  EXPECT_EQ (a [1], 101);
+}
+
+TEST_F (JSONArchiveInFixture, missingMemberKeepsPosition)
+{
+  std::array<int, 2> a;
+  int missing = 0;
+  double d;
+  archive ("array", a);
+  archive ("missing", missing, 5);
+  archive ("double", d);
+  EXPECT_EQ (missing, 5);
+  EXPECT_EQ (d, 123.321);
+}
+
+namespace
+{
+  struct Base
+  {
+    virtual ~Base () = default;
+    int value {0};
+    void serialize (Archive& ar) {ar ("value", value);}
+  };
+
+  struct Derived : Base {};
+
+  bool const g_derivedRegistered = []
+  {
+    types ().add<Base> ("JSONArchiveInBase");
+    types ().add<Derived, Base> ("JSONArchiveInDerived");
+    return true;
+  } ();
+}
+
+TEST (JSONArchiveIn, typeNameAfterOtherMembers)
+{
+  auto const json = R"""({"object": {"value": 3, "@type_version": "1.0.0", "@type": "JSONArchiveInDerived"}})""";
+  auto const object = fromJson<std::shared_ptr<Base>> ("object", json);
+  ASSERT_NE (std::dynamic_pointer_cast<Derived> (object), nullptr);
+  EXPECT_EQ (object->value, 3);
+}
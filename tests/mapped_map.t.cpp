@@ -0,0 +1,158 @@
+#include <moose/mapped_map.h>
+#include <moose/stl_serialization.h>
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+using namespace moose;
+
+namespace
+{
+  struct Record
+  {
+    int mId {0};
+    std::string mLabel;
+    std::vector<double> mValues;
+
+    /// Number of records which were read, to check that lookups only decode the requested values.
+    static inline int s_reads {0};
+
+    auto operator <=> (Record const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      if (ar.is_reading ())
+        ++s_reads;
+      ar ("id", mId);
+      ar ("label", mLabel);
+      ar ("values", mValues);
+    }
+  };
+
+  auto makeKey (int i) -> std::string
+  {
+    auto key = std::to_string (i * 2);
+    return "key" + std::string (6 - key.size (), '0') + key;
+  }
+
+  auto makeRecords (int count) -> std::map<std::string, Record>
+  {
+    std::map<std::string, Record> records;
+    for (int i = 0; i < count; ++i)
+      records [makeKey (i)] = {i, "record" + std::to_string (i), std::vector<double> (static_cast<size_t> (i % 4), 0.5 * i)};
+    return records;
+  }
+
+  auto writeRecords (std::map<std::string, Record> const& records, BinaryOptions options) -> std::vector<std::byte>
+  {
+    ByteBuffer buffer;
+    {
+      Archive archive {std::make_shared<BinaryWriter<ByteBuffer>> (buffer, options)};
+      archive ("version", 3);
+      archive ("records", records);
+      archive ("footer", std::string {"end"});
+    }
+    return buffer.take ();
+  }
+}
+
+TEST (mappedMap, pointLookups)
+{
+  BinaryOptions const options {.index = true, .indexStride = 1};
+  auto const records = makeRecords (1000);
+  auto const data = writeRecords (records, options);
+  MappedMap<std::string, Record> map {std::make_shared<BinaryReader> (std::span {data}, options), "records"};
+
+  EXPECT_EQ (map.size (), records.size ());
+  EXPECT_EQ (map.key (0), "key000000");
+  EXPECT_EQ (map.value (999), records.at (makeKey (999)));
+
+  for (int i : {0, 1, 500, 998, 999})
+  {
+    Record::s_reads = 0;
+    EXPECT_EQ (map.find (makeKey (i)), records.at (makeKey (i)));
+    EXPECT_EQ (Record::s_reads, 1);
+  }
+
+  Record::s_reads = 0;
+  EXPECT_FALSE (map.find ("key000001"));
+  EXPECT_FALSE (map.find ("a"));
+  EXPECT_FALSE (map.find ("z"));
+  EXPECT_TRUE (map.contains ("key000002"));
+  EXPECT_FALSE (map.contains ("key000003"));
+  EXPECT_EQ (Record::s_reads, 0);
+
+  EXPECT_EQ (map.lower_bound ("key000003"), 2u);
+  EXPECT_EQ (map.lower_bound ("z"), map.size ());
+  EXPECT_EQ (map.at ("key000004").mId, 2);
+  EXPECT_THROW (map.at ("key000005"), ArchiveError);
+  EXPECT_THROW (map.key (1000), ArchiveError);
+}
+
+TEST (mappedMap, rangeScan)
+{
+  BinaryOptions const options {.index = true, .indexStride = 1};
+  auto const records = makeRecords (100);
+  auto const data = writeRecords (records, options);
+  MappedMap<std::string, Record> map {std::make_shared<BinaryReader> (std::span {data}, options), "records"};
+
+  std::vector<int> ids;
+  Record::s_reads = 0;
+  map.scan ("key000009", "key000020", [&ids] (std::string const& key, Record const& record)
+  {
+    EXPECT_EQ (key, makeKey (record.mId));
+    ids.push_back (record.mId);
+  });
+  EXPECT_EQ (ids, (std::vector<int> {5, 6, 7, 8, 9}));
+  EXPECT_EQ (Record::s_reads, 5);
+
+  ids.clear ();
+  map.scan ("key000190", "z", [&ids] (std::string const&, Record const& record) {ids.push_back (record.mId);});
+  EXPECT_EQ (ids, (std::vector<int> {95, 96, 97, 98, 99}));
+
+  ids.clear ();
+  map.scan ("z", "zz", [&ids] (std::string const&, Record const& record) {ids.push_back (record.mId);});
+  EXPECT_TRUE (ids.empty ());
+}
+
+TEST (mappedMap, stridesAndSamples)
+{
+  auto const records = makeRecords (300);
+  for (auto const stride : {std::size_t {1}, std::size_t {4}, std::size_t {16}})
+  {
+    BinaryOptions const options {.index = true, .indexStride = stride};
+    auto const data = writeRecords (records, options);
+    for (auto const samples : {std::size_t {0}, std::size_t {1}, std::size_t {7}, std::size_t {1000}})
+    {
+      MappedMap<std::string, Record> map {std::make_shared<BinaryReader> (std::span {data}, options), "records", samples};
+      for (int i = 0; i < 300; i += 37)
+      {
+        EXPECT_EQ (map.find (makeKey (i)), records.at (makeKey (i)));
+        EXPECT_FALSE (map.contains (makeKey (i) + "x"));
+      }
+    }
+  }
+}
+
+TEST (mappedMap, taggedData)
+{
+  BinaryOptions const options {.tagged = true, .index = true, .indexStride = 1};
+  auto const records = makeRecords (50);
+  auto const data = writeRecords (records, options);
+  MappedMap<std::string, Record> map {std::make_shared<BinaryReader> (std::span {data}, options), "records"};
+  EXPECT_EQ (map.find (makeKey (17)), records.at (makeKey (17)));
+
+  std::size_t count = 0;
+  map.scan ("", "z", [&count] (std::string const&, Record const&) {++count;});
+  EXPECT_EQ (count, records.size ());
+}
+
+TEST (mappedMap, missingPositionsAreRejected)
+{
+  BinaryOptions const options {.index = true};
+  auto const data = writeRecords (makeRecords (10), options);
+  auto const reader = std::make_shared<BinaryReader> (std::span {data}, options);
+  EXPECT_THROW ((MappedMap<std::string, Record> {reader, "records"}), ArchiveError);
+  EXPECT_THROW ((MappedMap<std::string, Record> {reader, "missing"}), ArchiveError);
+}
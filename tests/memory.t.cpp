@@ -0,0 +1,98 @@
+#include <moose/stl_serialization.h>
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+using namespace moose;
+
+namespace
+{
+  struct Record
+  {
+    int mId {0};
+    std::string mName;
+    std::vector<double> mSamples;
+    std::map<std::string, int> mCounters;
+    std::vector<int64_t> mTimes;
+    std::vector<int> mLabels;
+
+    auto operator <=> (Record const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("id", mId);
+      ar ("name", mName);
+      ar ("samples", mSamples);
+      ar ("counters", mCounters, std::map<std::string, int> {});
+      ar ("times", mTimes, Hint::Delta);
+      ar ("labels", mLabels);
+    }
+  };
+
+  auto makeRecords () -> std::vector<Record>
+  {
+    std::vector<Record> records;
+    for (int i = 0; i < 20; ++i)
+      records.push_back ({i, "record" + std::to_string (i), {0.5 * i, 1.5 * i}, {{"a", i}}, {1000, 1010 + i}, {i, -i, 300 * i}});
+    records.push_back (records.front ());
+    return records;
+  }
+
+  auto toBytes (std::shared_ptr<std::stringstream> const& binary) -> std::vector<std::byte>
+  {
+    auto const str = binary->str ();
+    auto const* const bytes = reinterpret_cast<std::byte const*> (str.data ());
+    return {bytes, bytes + str.size ()};
+  }
+}
+
+TEST (memory, writeRead)
+{
+  auto const records = makeRecords ();
+  for (auto const& options : {BinaryOptions {}, BinaryOptions {.integerEncoding = IntegerEncoding::Varint},
+                              BinaryOptions {.dedupThreshold = 8}, BinaryOptions {.tagged = true}})
+  {
+    auto const bytes = toBytes (toBinary (records, options));
+    EXPECT_EQ (records, fromBinary<std::vector<Record>> (bytes, options));
+  }
+}
+
+TEST (memory, ownedData)
+{
+  auto const records = makeRecords ();
+  auto bytes = std::make_shared<std::vector<std::byte> const> (toBytes (toBinary (records)));
+  Archive archive {std::make_shared<BinaryReader> (std::move (bytes))};
+
+  std::vector<Record> read;
+  archive ("", read);
+  EXPECT_EQ (records, read);
+}
+
+TEST (memory, index)
+{
+  BinaryOptions const options {.index = true, .indexStride = 4};
+  auto const records = makeRecords ();
+  auto out = std::make_shared<std::stringstream> ();
+  {
+    Archive archive {std::make_shared<BinaryWriter<std::stringstream>> (out, options)};
+    archive ("records", records);
+    archive ("count", records.size ());
+  }
+
+  auto const bytes = toBytes (out);
+  auto const reader = std::make_shared<BinaryReader> (std::span {bytes}, options);
+  EXPECT_EQ (fromBinaryEntry<std::size_t> (reader, "count"), records.size ());
+  auto const elements = fromBinaryElements<Record> (reader, "records", 9, 3);
+  EXPECT_EQ (elements, (std::vector<Record> {records.begin () + 9, records.begin () + 12}));
+}
+
+TEST (memory, truncatedDataIsRejected)
+{
+  BinaryOptions const options {.integerEncoding = IntegerEncoding::Varint};
+  auto bytes = toBytes (toBinary (makeRecords (), options));
+  bytes.resize (bytes.size () - 3);
+  EXPECT_THROW (fromBinary<std::vector<Record>> (bytes, options), ArchiveError);
+  EXPECT_FALSE (tryFromBinary<std::vector<Record>> (bytes, options));
+  EXPECT_THROW (fromBinary<int> (std::span<std::byte const> {}), ArchiveError);
+}
@@ -49,6 +49,40 @@ namespace
       ar (mValue);
     }
   };
+
+  struct PositionalV1
+  {
+    int mA {1};
+
+    void serialize (Archive& ar)
+    {
+      ar (mA);
+    }
+  };
+
+  struct PositionalV2
+  {
+    int mA {0};
+    int mB {0};
+
+    void serialize (Archive& ar)
+    {
+      ar (mA);
+      ar ("b", mB, 42);
+    }
+  };
+
+  struct PositionalMandatory
+  {
+    int mA {0};
+    int mB {0};
+
+    void serialize (Archive& ar)
+    {
+      ar (mA);
+      ar ("b", mB);
+    }
+  };
 }
 
 TEST (stl, noNameWithNameWithNoName)
@@ -64,3 +98,33 @@ TEST (stl, arrayOfNameWithNoName)
   EXPECT_EQ (v, toJsonAndBack (v));
   EXPECT_EQ (v, toBinaryAndBack (v));
 }
+
+TEST (stl, unnamedMembersArePositional)
+{
+  NoNameWithNameWithNoName const v;
+  auto const json = toJson ("v", v, {UnnamedEntries::Positional});
+  EXPECT_EQ (json.find ("@noname"), std::string::npos);
+  EXPECT_EQ (v, fromJson<NoNameWithNameWithNoName> ("v", json.c_str ()));
+}
+
+TEST (stl, namedUnnamedEntries)
+{
+  NoNameWithNameWithNoName const v;
+  auto const json = toJson ("v", v, {UnnamedEntries::Named});
+  EXPECT_NE (json.find ("@noname"), std::string::npos);
+  EXPECT_EQ (v, fromJson<NoNameWithNameWithNoName> ("v", json.c_str ()));
+}
+
+TEST (stl, missingPositionalMemberIsDefaulted)
+{
+  auto const json = toJson ("v", PositionalV1 {7}, {UnnamedEntries::Positional});
+  auto const v = fromJson<PositionalV2> ("v", json.c_str ());
+  EXPECT_EQ (v.mA, 7);
+  EXPECT_EQ (v.mB, 42);
+}
+
+TEST (stl, missingPositionalMemberIsReported)
+{
+  auto const json = toJson ("v", PositionalV1 {7}, {UnnamedEntries::Positional});
+  EXPECT_THROW (fromJson<PositionalMandatory> ("v", json.c_str ()), ArchiveError);
+}
@@ -0,0 +1,159 @@
+#include <moose/binary_patch.h>
+#include <moose/stl_serialization.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+using namespace moose;
+
+namespace
+{
+  struct Item
+  {
+    std::string mName;
+    int mCount {0};
+
+    auto operator <=> (Item const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("name", mName);
+      ar ("count", mCount);
+    }
+  };
+
+  struct State
+  {
+    int mStep {0};
+    std::vector<double> mSamples;
+    std::vector<Item> mItems;
+    std::map<std::string, int> mCounters;
+
+    auto operator <=> (State const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("step", mStep);
+      ar ("samples", mSamples);
+      ar ("items", mItems);
+      ar ("counters", mCounters);
+    }
+  };
+
+  auto makeState () -> State
+  {
+    State state;
+    for (int i = 0; i < 1000; ++i)
+      state.mSamples.push_back (0.5 * i);
+    for (int i = 0; i < 100; ++i)
+      state.mItems.push_back ({"item" + std::to_string (i), i});
+    state.mCounters = {{"a", 1}, {"b", 2}, {"c", 3}};
+    return state;
+  }
+
+  auto patchAndBack (State const& baseline, State const& current) -> State
+  {
+    return fromBinaryPatch (baseline, toBinaryPatch (baseline, current));
+  }
+}
+
+TEST (patch, eventTape)
+{
+  auto const state = makeState ();
+  auto const tape = toEventTape (state);
+  State restored;
+  fromEventTape (restored, tape);
+  EXPECT_EQ (state, restored);
+}
+
+TEST (patch, unchanged)
+{
+  auto const state = makeState ();
+  EXPECT_LT (toBinaryPatch (state, state)->str ().size (), size_t {4});
+  EXPECT_EQ (state, patchAndBack (state, state));
+}
+
+TEST (patch, changedValues)
+{
+  auto const baseline = makeState ();
+  auto current = baseline;
+  current.mStep = 1;
+  current.mSamples [500] = -1;
+  current.mItems [42].mName = "changed";
+  current.mCounters ["b"] = 20;
+
+  EXPECT_LT (toBinaryPatch (baseline, current)->str ().size (), size_t {100});
+  EXPECT_EQ (current, patchAndBack (baseline, current));
+}
+
+TEST (patch, appendedAndRemovedElements)
+{
+  auto const baseline = makeState ();
+
+  auto appended = baseline;
+  appended.mItems.push_back ({"new", 7});
+  appended.mSamples.push_back (3);
+  EXPECT_LT (toBinaryPatch (baseline, appended)->str ().size (), size_t {64});
+  EXPECT_EQ (appended, patchAndBack (baseline, appended));
+
+  auto removed = baseline;
+  removed.mItems.resize (10);
+  removed.mSamples.clear ();
+  EXPECT_LT (toBinaryPatch (baseline, removed)->str ().size (), size_t {32});
+  EXPECT_EQ (removed, patchAndBack (baseline, removed));
+
+  auto inserted = baseline;
+  inserted.mCounters ["aa"] = 5;
+  EXPECT_EQ (inserted, patchAndBack (baseline, inserted));
+}
+
+TEST (patch, writerMatchesComparedTapes)
+{
+  auto const baseline = makeState ();
+  auto const tapePatch = [&baseline] (State const& current)
+  {
+    return createPatch (toEventTape (baseline), toEventTape (current));
+  };
+
+  auto changed = baseline;
+  changed.mStep = 3;
+  changed.mItems [7].mCount = -1;
+  changed.mItems.resize (150, {"appended", 1});
+  changed.mSamples.resize (10);
+  changed.mCounters.erase ("a");
+  EXPECT_EQ (tapePatch (changed), toBinaryPatch (baseline, changed)->str ());
+  EXPECT_EQ (tapePatch (baseline), toBinaryPatch (baseline, baseline)->str ());
+  EXPECT_EQ (tapePatch (State {}), toBinaryPatch (baseline, State {})->str ());
+
+  // entries whose structure changed are replaced as a whole
+  using Variants = std::vector<std::variant<int, Item>>;
+  Variants const items {Item {"a", 1}, Item {"b", 2}, 3};
+  Variants const replaced {Item {"a", 1}, 2, Item {"c", 3}};
+  EXPECT_EQ (createPatch (toEventTape (items), toEventTape (replaced)), toBinaryPatch (items, replaced)->str ());
+  EXPECT_EQ (replaced, fromBinaryPatch (items, toBinaryPatch (items, replaced)));
+}
+
+TEST (patch, bitwiseComparisonOfDoubles)
+{
+  State baseline;
+  baseline.mSamples = {0.0, 1.0};
+  State current;
+  current.mSamples = {-0.0, std::nan ("")};
+
+  auto const restored = patchAndBack (baseline, current);
+  ASSERT_EQ (restored.mSamples.size (), 2u);
+  EXPECT_TRUE (std::signbit (restored.mSamples [0]));
+  EXPECT_TRUE (std::isnan (restored.mSamples [1]));
+}
+
+TEST (patch, malformedPatchIsRejected)
+{
+  auto const baseline = makeState ();
+  auto current = baseline;
+  current.mItems.push_back ({"new", 7});
+
+  auto patch = toBinaryPatch (baseline, current)->str ();
+  patch.resize (patch.size () - 2);
+  EXPECT_THROW (fromBinaryPatch (baseline, std::make_shared<std::stringstream> (patch)), ArchiveError);
+}
@@ -0,0 +1,251 @@
+#include <moose/profiling.h>
+#include <moose/stl/bitset.h>
+#include <moose/stl_serialization.h>
+#include <moose/types.h>
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace moose;
+
+namespace
+{
+  struct Animal
+  {
+    virtual ~Animal () = default;
+    std::string mName;
+
+    void serialize (Archive& ar)
+    {
+      ar ("name", mName);
+    }
+  };
+
+  struct Dog : Animal
+  {
+    int mBarks {0};
+
+    void serialize (Archive& ar)
+    {
+      Animal::serialize (ar);
+      ar ("barks", mBarks);
+    }
+  };
+
+  struct Zoo
+  {
+    std::vector<double> mSamples;
+    std::vector<std::shared_ptr<Animal>> mAnimals;
+    std::vector<std::string> mKeepers;
+
+    void serialize (Archive& ar)
+    {
+      ar ("samples", mSamples);
+      ar ("animals", mAnimals);
+      ar ("keepers", mKeepers);
+    }
+  };
+
+  bool const g_animalsRegistered = []
+  {
+    types ().add<Animal> ("ProfilingAnimal");
+    types ().add<Dog, Animal> ("ProfilingDog");
+    return true;
+  } ();
+
+  auto makeZoo () -> Zoo
+  {
+    Zoo zoo;
+    zoo.mSamples = {1, 2, 3, 4};
+    for (int i = 0; i < 10; ++i)
+    {
+      auto dog = std::make_shared<Dog> ();
+      dog->mName = "dog" + std::to_string (i);
+      dog->mBarks = i;
+      zoo.mAnimals.push_back (dog);
+    }
+    zoo.mAnimals.push_back (std::make_shared<Animal> ());
+    zoo.mKeepers = {"a", "b", "c"};
+    return zoo;
+  }
+
+  auto findField (Profile const& profile, std::string const& path) -> ProfileStatistics
+  {
+    auto const fields = profile.fields ();
+    auto const iter = std::find_if (fields.begin (), fields.end (), [&] (auto const& f) {return f.path == path;});
+    if (iter == fields.end ())
+    {
+      ADD_FAILURE () << "No field " << path;
+      return {};
+    }
+    return iter->statistics;
+  }
+
+  auto writeProfiled (Zoo const& zoo, std::shared_ptr<Profile> profile, ProfilingOptions options = {})
+    -> std::shared_ptr<std::stringstream>
+  {
+    auto out = std::make_shared<std::stringstream> ();
+    options.position = writePosition (*out);
+    Archive archive {std::make_shared<ProfilingWriter> (std::make_shared<BinaryWriter<std::stringstream>> (out),
+                                                        std::move (profile), std::move (options))};
+    archive ("", zoo);
+    return out;
+  }
+
+  struct TraceEvent
+  {
+    std::string name;
+    std::string ph;
+    double dur {0};
+
+    void serialize (Archive& ar)
+    {
+      ar ("name", name);
+      ar ("ph", ph);
+      ar ("dur", dur);
+    }
+  };
+}
+
+TEST (profiling, writerCollectsFieldStatistics)
+{
+  auto const zoo = makeZoo ();
+  auto const profile = std::make_shared<Profile> ();
+  auto const binary = writeProfiled (zoo, profile);
+
+  EXPECT_EQ (binary->str (), toBinary (zoo)->str ());
+
+  auto const root = findField (*profile, "");
+  EXPECT_EQ (root.count, 1u);
+  EXPECT_EQ (root.bytes, binary->str ().size ());
+  EXPECT_GE (root.seconds, 0.0);
+
+  EXPECT_EQ (findField (*profile, "animals/[]").count, 11u);
+  EXPECT_EQ (findField (*profile, "animals/[]/name").count, 11u);
+  EXPECT_EQ (findField (*profile, "animals/[]/barks").count, 10u);
+  EXPECT_EQ (findField (*profile, "keepers/[]").count, 3u);
+
+  auto const childBytes = findField (*profile, "samples").bytes + findField (*profile, "animals").bytes
+                        + findField (*profile, "keepers").bytes;
+  EXPECT_GT (findField (*profile, "keepers/[]").bytes, 0u);
+  EXPECT_LE (childBytes, root.bytes);
+
+  auto const& types = profile->types ();
+  ASSERT_EQ (types.count ("ProfilingDog"), 1u);
+  EXPECT_EQ (types.at ("ProfilingDog").count, 10u);
+  EXPECT_EQ (types.at ("ProfilingAnimal").count, 1u);
+  EXPECT_GT (types.at ("ProfilingDog").bytes, types.at ("ProfilingAnimal").bytes);
+}
+
+TEST (profiling, readerCollectsFieldStatistics)
+{
+  auto const zoo = makeZoo ();
+  auto const binary = toBinary (zoo);
+
+  auto const profile = std::make_shared<Profile> ();
+  Zoo restored;
+  {
+    Archive archive {std::make_shared<ProfilingReader> (std::make_shared<BinaryReader> (binary), profile,
+                                                        ProfilingOptions {.position = readPosition (*binary)})};
+    archive ("", restored);
+  }
+
+  EXPECT_EQ (restored.mSamples, zoo.mSamples);
+  EXPECT_EQ (restored.mKeepers, zoo.mKeepers);
+  ASSERT_EQ (restored.mAnimals.size (), zoo.mAnimals.size ());
+  EXPECT_EQ (restored.mAnimals [3]->mName, "dog3");
+
+  EXPECT_EQ (findField (*profile, "animals/[]/barks").count, 10u);
+  EXPECT_EQ (findField (*profile, "").bytes, binary->str ().size ());
+  EXPECT_EQ (profile->types ().at ("ProfilingDog").count, 10u);
+}
+
+TEST (profiling, jsonIsUnchanged)
+{
+  auto const zoo = makeZoo ();
+  auto const profile = std::make_shared<Profile> ();
+  auto out = std::make_shared<std::stringstream> ();
+  {
+    Archive archive {std::make_shared<ProfilingWriter> (std::make_shared<JSONWriter> (out), profile)};
+    archive ("zoo", zoo);
+  }
+  EXPECT_EQ (out->str (), toJson ("zoo", zoo));
+
+  auto const restored = fromJson<Zoo> ("zoo", out->str ().c_str ());
+  EXPECT_EQ (restored.mKeepers, zoo.mKeepers);
+  EXPECT_EQ (findField (*profile, "zoo/keepers/[]").count, 3u);
+  EXPECT_EQ (findField (*profile, "zoo/keepers/[]").bytes, 0u);
+}
+
+TEST (profiling, packedBits)
+{
+  std::vector<bool> const flags {true, false, true, true, false};
+  std::bitset<70> const mask {0x5A5Au};
+
+  auto const profile = std::make_shared<Profile> ();
+  auto out = std::make_shared<std::stringstream> ();
+  {
+    Archive archive {std::make_shared<ProfilingWriter> (std::make_shared<BinaryWriter<std::stringstream>> (out), profile)};
+    archive ("flags", flags);
+    archive ("mask", mask);
+  }
+  auto direct = std::make_shared<std::stringstream> ();
+  {
+    Archive archive {std::make_shared<BinaryWriter<std::stringstream>> (direct)};
+    archive ("flags", flags);
+    archive ("mask", mask);
+  }
+  EXPECT_EQ (out->str (), direct->str ());
+
+  std::vector<bool> flagsIn;
+  std::bitset<70> maskIn;
+  {
+    Archive archive {std::make_shared<ProfilingReader> (std::make_shared<BinaryReader> (out), profile)};
+    archive ("flags", flagsIn);
+    archive ("mask", maskIn);
+  }
+  EXPECT_EQ (flagsIn, flags);
+  EXPECT_EQ (maskIn, mask);
+  EXPECT_EQ (findField (*profile, "flags").count, 2u);
+}
+
+TEST (profiling, sampling)
+{
+  Zoo zoo;
+  zoo.mKeepers.resize (100);
+
+  auto const complete = std::make_shared<Profile> ();
+  writeProfiled (zoo, complete);
+  auto const sampled = std::make_shared<Profile> ();
+  writeProfiled (zoo, sampled, {.samplingInterval = 8});
+
+  auto const keepers = findField (*sampled, "keepers/[]");
+  EXPECT_EQ (keepers.count, 100u);
+  EXPECT_EQ (keepers.measured, 13u);
+  EXPECT_DOUBLE_EQ (keepers.estimated_bytes (), static_cast<double> (findField (*complete, "keepers/[]").bytes));
+}
+
+TEST (profiling, export)
+{
+  auto const profile = std::make_shared<Profile> ();
+  writeProfiled (makeZoo (), profile, {.trace = true, .maxTraceEvents = 5});
+
+  std::stringstream json;
+  profile->write_json (json);
+  EXPECT_NE (json.str ().find ("\"animals/[]/barks\""), std::string::npos);
+  EXPECT_NE (json.str ().find ("\"ProfilingDog\""), std::string::npos);
+
+  std::stringstream trace;
+  profile->write_chrome_trace (trace);
+  auto const events = fromJson<std::vector<TraceEvent>> ("traceEvents", trace.str ().c_str ());
+  ASSERT_EQ (events.size (), 5u);
+  EXPECT_EQ (events.front ().ph, "X");
+  EXPECT_EQ (events.front ().name, "samples");
+
+  profile->clear ();
+  EXPECT_TRUE (profile->fields ().empty ());
+  EXPECT_TRUE (profile->types ().empty ());
+}
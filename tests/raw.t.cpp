@@ -0,0 +1,131 @@
+#include <moose/stl_serialization.h>
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+using namespace moose;
+
+namespace
+{
+  struct Vertex
+  {
+    float x {0};
+    float y {0};
+    float z {0};
+    int id {0};
+
+    auto operator <=> (Vertex const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("x", x);
+      ar ("y", y);
+      ar ("z", z);
+      ar ("id", id);
+    }
+  };
+
+  struct VertexWithNormal
+  {
+    float x {0};
+    float y {0};
+    float z {0};
+    float nx {0};
+    float ny {0};
+    float nz {0};
+
+    void serialize (Archive& ar)
+    {
+      ar ("x", x);
+      ar ("y", y);
+      ar ("z", z);
+      ar ("nx", nx);
+      ar ("ny", ny);
+      ar ("nz", nz);
+    }
+  };
+
+  struct Mesh
+  {
+    std::string mName;
+    std::vector<Vertex> mVertices;
+    std::array<Vertex, 2> mBounds;
+    Vertex mCenter;
+
+    auto operator <=> (Mesh const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("name", mName);
+      ar ("vertices", mVertices);
+      ar ("bounds", mBounds);
+      ar ("center", mCenter);
+    }
+  };
+
+  auto makeVertices (size_t n) -> std::vector<Vertex>
+  {
+    std::vector<Vertex> vertices;
+    for (size_t i = 0; i < n; ++i)
+    {
+      auto const f = static_cast<float> (i);
+      vertices.push_back ({f, f * 0.5f, -f, static_cast<int> (i)});
+    }
+    return vertices;
+  }
+}
+
+template <>
+struct moose::TypeTraits<Vertex>
+{
+  static constexpr EntryType entryType = EntryType::Struct;
+  static constexpr bool rawBinary = true;
+};
+
+template <>
+struct moose::TypeTraits<VertexWithNormal>
+{
+  static constexpr EntryType entryType = EntryType::Struct;
+  static constexpr bool rawBinary = true;
+};
+
+TEST (raw, layout)
+{
+  auto const layout = detail::rawLayout<Vertex> ();
+  EXPECT_EQ (layout.size, sizeof (Vertex));
+  EXPECT_EQ (layout.alignment, alignof (Vertex));
+  EXPECT_EQ (layout.fieldCount, 4u);
+}
+
+TEST (raw, writeRead)
+{
+  Mesh mesh {"mesh", makeVertices (100), {{{-1, -1, -1, 0}, {1, 1, 1, 1}}}, {0.5f, 0.5f, 0.5f, 7}};
+  EXPECT_EQ (mesh, toBinaryAndBack (mesh));
+  EXPECT_EQ (mesh, toBinaryAndBack (mesh, {IntegerEncoding::Varint}));
+  EXPECT_EQ (mesh, toJsonAndBack (mesh));
+}
+
+TEST (raw, vectorIsSingleBlock)
+{
+  auto const vertices = makeVertices (1000);
+  auto const size = toBinary (vertices, {IntegerEncoding::Fixed})->str ().size ();
+  EXPECT_GE (size, vertices.size () * sizeof (Vertex));
+  EXPECT_LT (size, vertices.size () * sizeof (Vertex) + 32);
+}
+
+TEST (raw, jsonUsesSerialize)
+{
+  auto const json = toJson ("v", Vertex {1, 2, 3, 4});
+  EXPECT_NE (json.find ("\"id\": 4"), std::string::npos);
+}
+
+TEST (raw, incompatibleLayoutIsRejected)
+{
+  BinaryOptions const fixed {IntegerEncoding::Fixed};
+  auto const binary = toBinary (makeVertices (10), fixed);
+  EXPECT_THROW (fromBinary<std::vector<VertexWithNormal>> (binary, fixed), ArchiveError);
+
+  auto const single = toBinary (Vertex {}, fixed);
+  EXPECT_THROW (fromBinary<VertexWithNormal> (single, fixed), ArchiveError);
+}
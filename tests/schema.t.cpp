@@ -0,0 +1,249 @@
+#include <moose/from_binary.h>
+#include <moose/schema.h>
+#include <moose/stl_serialization.h>
+#include <moose/to_binary.h>
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+using namespace moose;
+
+namespace
+{
+  struct Point
+  {
+    double x {0};
+    double y {0};
+
+    void serialize (Archive& ar)
+    {
+      ar ("x", x);
+      ar ("y", y);
+    }
+  };
+
+  struct Sample
+  {
+    int mId {0};
+    std::string mName;
+    std::vector<Point> mPoints;
+    std::vector<double> mValues;
+
+    void serialize (Archive& ar)
+    {
+      ar ("id", mId);
+      ar ("name", mName);
+      ar ("points", mPoints);
+      ar ("values", mValues);
+    }
+  };
+
+  /// Like `Sample`, but with other names and floats instead of doubles.
+  struct Renamed
+  {
+    int mKey {0};
+    std::string mLabel;
+    std::vector<Point> mPositions;
+    std::vector<float> mSamples;
+
+    void serialize (Archive& ar)
+    {
+      ar ("key", mKey);
+      ar ("label", mLabel);
+      ar ("positions", mPositions);
+      ar ("samples", mSamples);
+    }
+  };
+
+  /// Like `Sample`, but with a 64 bit id.
+  struct WideId
+  {
+    long long mId {0};
+    std::string mName;
+    std::vector<Point> mPoints;
+    std::vector<double> mValues;
+
+    void serialize (Archive& ar)
+    {
+      ar ("id", mId);
+      ar ("name", mName);
+      ar ("points", mPoints);
+      ar ("values", mValues);
+    }
+  };
+
+  /// Like `Sample`, but with integers as elements of `mValues`.
+  struct IntegerValues
+  {
+    int mId {0};
+    std::string mName;
+    std::vector<Point> mPoints;
+    std::vector<int> mValues;
+
+    void serialize (Archive& ar)
+    {
+      ar ("id", mId);
+      ar ("name", mName);
+      ar ("points", mPoints);
+      ar ("values", mValues);
+    }
+  };
+
+  /// Like `Sample`, but with an additional member with default value.
+  struct Extended
+  {
+    int mId {0};
+    std::string mName;
+    std::vector<Point> mPoints;
+    std::vector<double> mValues;
+    int mExtra {0};
+
+    void serialize (Archive& ar)
+    {
+      ar ("id", mId);
+      ar ("name", mName);
+      ar ("points", mPoints);
+      ar ("values", mValues);
+      ar ("extra", mExtra, 5);
+    }
+  };
+
+  struct Node
+  {
+    int mValue {0};
+    std::vector<Node> mChildren;
+
+    void serialize (Archive& ar)
+    {
+      ar ("value", mValue);
+      ar ("children", mChildren);
+    }
+  };
+
+  struct Shape
+  {
+    std::shared_ptr<Point> mCenter;
+
+    void serialize (Archive& ar)
+    {
+      ar ("center", mCenter);
+    }
+  };
+
+  bool const g_pointRegistered = []
+  {
+    types ().add<Point> ("SchemaPoint");
+    return true;
+  } ();
+
+  auto makeSample () -> Sample
+  {
+    return {7, "sample", {{1, 2}, {3, 4}}, {0.5, 1.5}};
+  }
+}
+
+TEST (MooseSchema, EqualForSameType)
+{
+  EXPECT_NE (schemaFingerprint<Sample> (), 0u);
+  EXPECT_EQ (schemaFingerprint<Sample> (), schemaFingerprint<Sample> ());
+}
+
+TEST (MooseSchema, IgnoresNamesAndEquivalentContainers)
+{
+  EXPECT_EQ (schemaFingerprint<Sample> (), schemaFingerprint<Renamed> ());
+  EXPECT_EQ (schemaFingerprint<std::vector<int>> (), schemaFingerprint<std::set<int>> ());
+}
+
+TEST (MooseSchema, DiffersForChangedTypes)
+{
+  EXPECT_NE (schemaFingerprint<Sample> (), schemaFingerprint<WideId> ());
+  EXPECT_NE (schemaFingerprint<Sample> (), schemaFingerprint<IntegerValues> ());
+  EXPECT_NE (schemaFingerprint<std::vector<Point>> (), schemaFingerprint<std::vector<double>> ());
+}
+
+TEST (MooseSchema, DescribesRecursiveTypes)
+{
+  EXPECT_NE (schemaFingerprint<Node> (), 0u);
+  EXPECT_NE (schemaFingerprint<Node> (), schemaFingerprint<int> ());
+}
+
+TEST (MooseSchema, DescribesPointeesOfNullPointers)
+{
+  EXPECT_NE (schemaFingerprint<Shape> (), 0u);
+  EXPECT_NE (schemaFingerprint<Shape> (), schemaFingerprint<std::shared_ptr<double>> ());
+}
+
+TEST (MooseSchema, StoredInHeader)
+{
+  BinaryOptions options;
+  options.header = true;
+  auto const data = toBinaryBytes (makeSample (), options);
+
+  BinaryReader reader {std::span {data}, options};
+  EXPECT_EQ (reader.schema_fingerprint (), schemaFingerprint<Sample> ());
+
+  auto const sample = fromBinary<Sample> (std::span {data}, options);
+  EXPECT_EQ (sample.mName, "sample");
+  EXPECT_EQ (sample.mPoints.size (), 2u);
+
+  auto const renamed = fromBinary<Renamed> (std::span {data}, options);
+  EXPECT_EQ (renamed.mLabel, "sample");
+}
+
+TEST (MooseSchema, RejectsOtherSchemaBeforePayload)
+{
+  BinaryOptions options;
+  options.header = true;
+  auto data = toBinaryBytes (makeSample (), options);
+  data.resize (detail::headerSize + detail::schemaSize);
+
+  try
+  {
+    fromBinary<WideId> (std::span<std::byte const> {data}, options);
+    FAIL () << "Expected an ArchiveError";
+  }
+  catch (ArchiveError const& e)
+  {
+    EXPECT_NE (std::string {e.what ()}.find ("different schema"), std::string::npos);
+  }
+
+  auto const result = tryFromBinary<IntegerValues> (std::span<std::byte const> {data}, options);
+  EXPECT_FALSE (result);
+}
+
+TEST (MooseSchema, AcceptsDataWithoutFingerprint)
+{
+  BinaryOptions options;
+  options.header = true;
+
+  ByteBuffer buffer;
+  {
+    Archive archive {std::make_shared<BinaryWriter<ByteBuffer>> (buffer, options)};
+    auto sample = makeSample ();
+    archive ("", sample);
+  }
+  auto const data = buffer.take ();
+
+  EXPECT_EQ (BinaryReader (std::span {data}, options).schema_fingerprint (), 0u);
+  EXPECT_EQ (fromBinary<Sample> (std::span {data}, options).mId, 7);
+}
+
+TEST (MooseSchema, NotCheckedForTaggedData)
+{
+  BinaryOptions options;
+  options.header = true;
+  options.tagged = true;
+  auto const data = toBinaryBytes (makeSample (), options);
+  EXPECT_EQ (BinaryReader (std::span {data}, options).schema_fingerprint (), 0u);
+
+  auto const extended = fromBinary<Extended> (std::span {data}, options);
+  EXPECT_EQ (extended.mName, "sample");
+  EXPECT_EQ (extended.mExtra, 5);
+
+  // A fingerprint given explicitly is stored, but not checked for tagged data.
+  options.schema = schemaFingerprint<Sample> ();
+  auto const withSchema = toBinaryBytes (makeSample (), options);
+  options.schema = schemaFingerprint<Extended> ();
+  EXPECT_EQ (fromBinary<Extended> (std::span {withSchema}, options).mExtra, 5);
+}
@@ -81,3 +81,66 @@ TEST (stl, filesystemPath)
   EXPECT_EQ (v, toJsonAndBack (v));
   EXPECT_EQ (v, toBinaryAndBack (v));
 }
+
+TEST (stl, vectorOfBools)
+{
+  for (std::size_t size : {0, 1, 7, 8, 63, 64, 65, 130})
+  {
+    std::vector<bool> v (size);
+    for (std::size_t i = 0; i < size; ++i)
+      v [i] = (i % 3 == 0) != (i % 7 == 0);
+
+    EXPECT_EQ (v, toJsonAndBack (v));
+    EXPECT_EQ (v, toBinaryAndBack (v));
+    EXPECT_EQ (v, toBinaryAndBack (v, {.integerEncoding = IntegerEncoding::Varint}));
+  }
+}
+
+TEST (stl, vectorOfBoolsIsPacked)
+{
+  std::vector<bool> const v (130, true);
+  // The number of bits, followed by 8 bits per byte.
+  EXPECT_EQ (toBinaryBytes (v).size (), 8u + 17u);
+  EXPECT_NE (toJson ("bits", std::vector<bool> {true, false, true}).find (R"("bits": "101")"), std::string::npos);
+}
+
+TEST (stl, corruptPackedBitsSize)
+{
+  auto bytes = toBinaryBytes (std::vector<bool> (130, true));
+  for (std::size_t i = 0; i < 8; ++i)
+    bytes [i] = std::byte {0x7F};
+  EXPECT_THROW (fromBinary<std::vector<bool>> (bytes), ArchiveError);
+
+  auto stream = toBinary (std::vector<bool> (130, true));
+  auto text = stream->str ();
+  text [7] = '\x7F';
+  EXPECT_THROW (fromBinary<std::vector<bool>> (std::make_shared<std::stringstream> (text)), ArchiveError);
+}
+
+TEST (stl, vectorsOfBoolsInStructs)
+{
+  std::vector<std::vector<bool>> v {{true, false}, {}, std::vector<bool> (70, true)};
+  EXPECT_EQ (v, toJsonAndBack (v));
+  EXPECT_EQ (v, toBinaryAndBack (v));
+  EXPECT_EQ (v, toBinaryAndBack (v, {.tagged = true}));
+}
+
+TEST (stl, bitset)
+{
+  std::bitset<100> v;
+  v.set (0);
+  v.set (63);
+  v.set (64);
+  v.set (99);
+  EXPECT_EQ (v, toJsonAndBack (v));
+  EXPECT_EQ (v, toBinaryAndBack (v));
+
+  std::bitset<10> const small {0b1000000101};
+  EXPECT_EQ (small, toJsonAndBack (small));
+  EXPECT_EQ (small, toBinaryAndBack (small));
+  std::bitset<64> const word {0x8000'0000'0000'0001u};
+  EXPECT_EQ (word, toBinaryAndBack (word));
+
+  auto const shorter = toBinary (std::bitset<10> {});
+  EXPECT_THROW (fromBinary<std::bitset<100>> (shorter), ArchiveError);
+}
@@ -0,0 +1,183 @@
+#include <moose/stl_serialization.h>
+#include <moose/streaming.h>
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+using namespace moose;
+
+namespace
+{
+  struct Sample
+  {
+    int mIndex {0};
+    std::string mLabel;
+
+    auto operator <=> (Sample const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("index", mIndex);
+      ar ("label", mLabel);
+    }
+  };
+
+  auto makeSample (int i) -> Sample
+  {
+    return {i, "sample" + std::to_string (i)};
+  }
+
+  /// Writes its samples through a generator and reads them through a consumer.
+  struct Samples
+  {
+    std::optional<std::size_t> mCount;
+    int mLimit {0};
+    std::vector<Sample> mRead {};
+
+    void serialize (Archive& ar)
+    {
+      if (ar.is_writing ())
+      {
+        if (mCount)
+          ar ("samples", generate (*mCount, [i = 0] () mutable {return makeSample (i++);}));
+        else
+        {
+          ar ("samples", generate (unbounded, [this, i = 0] () mutable -> std::optional<Sample>
+          {
+            if (i == mLimit)
+              return std::nullopt;
+            return makeSample (i++);
+          }));
+        }
+      }
+      else
+      {
+        auto sink = consume<Sample> ([this] (Sample&& s) {mRead.push_back (std::move (s));});
+        ar ("samples", sink);
+      }
+    }
+  };
+
+  struct Materialized
+  {
+    std::vector<Sample> mSamples;
+
+    void serialize (Archive& ar)
+    {
+      ar ("samples", mSamples);
+    }
+  };
+
+  auto makeSamples (int n) -> std::vector<Sample>
+  {
+    std::vector<Sample> samples;
+    for (int i = 0; i < n; ++i)
+      samples.push_back (makeSample (i));
+    return samples;
+  }
+}
+
+TEST (streaming, generateBounded)
+{
+  Samples const samples {100};
+  auto const expected = makeSamples (100);
+
+  auto const binary = toBinary (samples);
+  EXPECT_EQ (expected, fromBinary<Materialized> (binary).mSamples);
+  EXPECT_EQ (binary->str (), toBinary (Materialized {expected})->str ());
+
+  auto const json = toJson ("s", samples);
+  EXPECT_EQ (expected, fromJson<Materialized> ("s", json.c_str ()).mSamples);
+}
+
+TEST (streaming, generateUnbounded)
+{
+  Samples samples {std::nullopt, 50};
+  auto const expected = makeSamples (50);
+
+  EXPECT_EQ (expected, fromBinary<Materialized> (toBinary (samples)).mSamples);
+  EXPECT_EQ (expected, fromBinary<Materialized> (toBinary (samples, {IntegerEncoding::Varint}),
+                                                 {IntegerEncoding::Varint}).mSamples);
+
+  auto const json = toJson ("s", samples);
+  EXPECT_EQ (expected, fromJson<Materialized> ("s", json.c_str ()).mSamples);
+
+  samples.mLimit = 0;
+  EXPECT_TRUE (fromBinary<Materialized> (toBinary (samples)).mSamples.empty ());
+}
+
+TEST (streaming, consume)
+{
+  Materialized const materialized {makeSamples (20)};
+
+  EXPECT_EQ (materialized.mSamples, fromBinary<Samples> (toBinary (materialized)).mRead);
+
+  auto const json = toJson ("m", materialized);
+  EXPECT_EQ (materialized.mSamples, fromJson<Samples> ("m", json.c_str ()).mRead);
+}
+
+TEST (streaming, numbers)
+{
+  struct Numbers
+  {
+    void serialize (Archive& ar)
+    {
+      if (ar.is_writing ())
+        ar ("values", generate (1000, [i = 0] () mutable {return 0.5 * i++;}));
+      else
+      {
+        auto sink = consume<double> ([this] (double v) {mSum += v;});
+        ar ("values", sink);
+      }
+    }
+    double mSum {0};
+  };
+
+  EXPECT_EQ (0.5 * 999 * 1000 / 2, fromBinary<Numbers> (toBinary (Numbers {})).mSum);
+  EXPECT_EQ (0.5 * 999 * 1000 / 2, toJsonAndBack (Numbers {}).mSum);
+}
+
+TEST (streaming, producerEndsEarly)
+{
+  struct Short
+  {
+    void serialize (Archive& ar)
+    {
+      ar ("values", generate (3, [i = 0] () mutable -> std::optional<int>
+      {
+        if (i == 2)
+          return std::nullopt;
+        return i++;
+      }));
+    }
+  };
+
+  EXPECT_THROW (toBinary (Short {}), ArchiveError);
+}
+
+TEST (streaming, wrongDirection)
+{
+  struct ReadsGenerator
+  {
+    void serialize (Archive& ar)
+    {
+      auto source = generate (2, [] {return Sample {};});
+      ar ("samples", source);
+    }
+  };
+
+  auto const binary = toBinary (Materialized {makeSamples (2)});
+  EXPECT_THROW (fromBinary<ReadsGenerator> (binary), ArchiveError);
+
+  struct WritesConsumer
+  {
+    void serialize (Archive& ar)
+    {
+      auto sink = consume<Sample> ([] (Sample&&) {});
+      ar ("samples", sink);
+    }
+  };
+
+  EXPECT_THROW (toBinary (WritesConsumer {}), ArchiveError);
+}
@@ -0,0 +1,174 @@
+#include <moose/stl_serialization.h>
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+using namespace moose;
+
+namespace
+{
+  struct Point
+  {
+    float x {0};
+    float y {0};
+
+    auto operator <=> (Point const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("x", x);
+      ar ("y", y);
+    }
+  };
+}
+
+template <>
+struct moose::TypeTraits<Point>
+{
+  static constexpr EntryType entryType = EntryType::Struct;
+  static constexpr bool rawBinary = true;
+};
+
+namespace
+{
+  struct Shape
+  {
+    virtual ~Shape () = default;
+    std::string mName;
+
+    virtual void serialize (Archive& ar)
+    {
+      ar.type_version ({1, 2, 0});
+      ar ("name", mName);
+    }
+  };
+
+  struct Circle : Shape
+  {
+    double mRadius {0};
+
+    void serialize (Archive& ar) override
+    {
+      Shape::serialize (ar);
+      ar ("radius", mRadius);
+    }
+  };
+
+  struct Scene
+  {
+    std::vector<Point> mPoints;
+    std::vector<std::shared_ptr<Shape>> mShapes;
+    std::map<std::string, std::vector<int>> mGroups;
+    std::optional<Point> mOrigin;
+    std::vector<int64_t> mTimestamps;
+
+    void serialize (Archive& ar)
+    {
+      ar ("points", mPoints, Hint::Columnar);
+      ar ("shapes", mShapes);
+      ar ("groups", mGroups);
+      ar ("origin", mOrigin);
+      ar ("timestamps", mTimestamps, Hint::Delta);
+    }
+  };
+
+  struct SettingsV1
+  {
+    int mWidth {0};
+    std::vector<Point> mOutline;
+    std::string mTitle;
+
+    void serialize (Archive& ar)
+    {
+      ar ("width", mWidth);
+      ar ("outline", mOutline);
+      ar ("title", mTitle);
+    }
+  };
+
+  /// Drops the outline, reads the members in a different order and adds a new member.
+  struct SettingsV2
+  {
+    std::string mTitle;
+    int mWidth {0};
+    int mHeight {0};
+
+    void serialize (Archive& ar)
+    {
+      ar ("title", mTitle);
+      ar ("height", mHeight, 480);
+      ar ("width", mWidth);
+    }
+  };
+
+  bool const g_shapesRegistered = []
+  {
+    types ().add<Shape> ("TaggedShape");
+    types ().add<Circle, Shape> ("TaggedCircle");
+    return true;
+  } ();
+
+  BinaryOptions const tagged {.tagged = true};
+}
+
+TEST (tagged, writeRead)
+{
+  Scene scene;
+  scene.mPoints = {{1, 2}, {3, 4}};
+  auto circle = std::make_shared<Circle> ();
+  circle->mName = "c";
+  circle->mRadius = 2.5;
+  scene.mShapes = {circle};
+  scene.mGroups = {{"a", {1, 2}}, {"b", {}}};
+  scene.mOrigin = Point {5, 6};
+  scene.mTimestamps = {100, 110, 125};
+
+  for (auto const encoding : {IntegerEncoding::Fixed, IntegerEncoding::Varint})
+  {
+    BinaryOptions options {encoding};
+    options.tagged = true;
+    auto const read = toBinaryAndBack (scene, options);
+    EXPECT_EQ (scene.mPoints, read.mPoints);
+    ASSERT_EQ (read.mShapes.size (), 1u);
+    auto const readCircle = std::dynamic_pointer_cast<Circle> (read.mShapes [0]);
+    ASSERT_NE (readCircle, nullptr);
+    EXPECT_EQ (readCircle->mName, "c");
+    EXPECT_EQ (readCircle->mRadius, 2.5);
+    EXPECT_EQ (scene.mGroups, read.mGroups);
+    EXPECT_EQ (scene.mOrigin, read.mOrigin);
+    EXPECT_EQ (scene.mTimestamps, read.mTimestamps);
+  }
+}
+
+TEST (tagged, skipsAndToleratesChangedMembers)
+{
+  SettingsV1 const v1 {640, std::vector<Point> (1000, Point {1, 1}), "main"};
+  auto const v2 = fromBinary<SettingsV2> (toBinary (v1, tagged), tagged);
+  EXPECT_EQ (v2.mTitle, "main");
+  EXPECT_EQ (v2.mWidth, 640);
+  EXPECT_EQ (v2.mHeight, 480);
+}
+
+TEST (tagged, missingMembers)
+{
+  struct Required
+  {
+    int mDepth {0};
+    void serialize (Archive& ar) {ar ("depth", mDepth);}
+  };
+
+  auto const binary = toBinary (SettingsV1 {1, {}, "t"}, tagged);
+  EXPECT_THROW (fromBinary<Required> (binary, tagged), ArchiveError);
+
+  binary->seekg (0);
+  auto const result = tryFromBinary<Required> (binary, tagged);
+  EXPECT_FALSE (result);
+  EXPECT_NE (result.error ().find ("depth"), std::string::npos);
+}
+
+TEST (tagged, cannotBeDeduplicated)
+{
+  BinaryOptions options {.dedupThreshold = 16, .tagged = true};
+  EXPECT_THROW (toBinary (SettingsV1 {}, options), ArchiveError);
+}
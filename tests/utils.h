@@ -6,10 +6,10 @@
 #include <moose/to_json.h>
 
 template <class T>
-T toBinaryAndBack (T const& t)
+T toBinaryAndBack (T const& t, moose::BinaryOptions options = {})
 {
-  auto const binary = moose::toBinary (t);
-  return moose::fromBinary<T> (binary);
+  auto const binary = moose::toBinary (t, options);
+  return moose::fromBinary<T> (binary, options);
 }
 
 template <class T>
@@ -0,0 +1,215 @@
+#include <moose/stl_serialization.h>
+#include <moose/detail/varint.h>
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <limits>
+
+using namespace moose;
+
+namespace
+{
+  auto const varint = BinaryOptions {IntegerEncoding::Varint};
+
+  struct Record
+  {
+    int mIndex {0};
+    long long int mOffset {0};
+    unsigned int mCount {0};
+    std::string mName;
+    std::vector<int> mValues;
+
+    auto operator <=> (Record const&) const = default;
+
+    void serialize (Archive& ar)
+    {
+      ar ("index", mIndex);
+      ar ("offset", mOffset);
+      ar ("count", mCount);
+      ar ("name", mName);
+      ar ("values", mValues);
+    }
+  };
+
+  /// Like a pipe or a socket: reads data in small pieces and can not seek.
+  class PipeBuffer : public std::streambuf
+  {
+  public:
+    explicit PipeBuffer (std::string data) : mData {std::move (data)} {}
+
+  protected:
+    auto underflow () -> int_type override
+    {
+      if (mPosition == mData.size ())
+        return traits_type::eof ();
+      auto const size = std::min<std::size_t> (7, mData.size () - mPosition);
+      std::copy_n (mData.data () + mPosition, size, mPiece);
+      mPosition += size;
+      setg (mPiece, mPiece, mPiece + size);
+      return traits_type::to_int_type (mPiece [0]);
+    }
+
+  private:
+    std::string mData;
+    std::size_t mPosition {0};
+    char mPiece [7];
+  };
+
+  template <class T>
+  auto fromPipe (std::string data, BinaryOptions options) -> T
+  {
+    PipeBuffer buffer {std::move (data)};
+    std::istream in {&buffer};
+    T t;
+    Archive archive {std::make_shared<BinaryReader> (in, options)};
+    archive ("", t);
+    return t;
+  }
+}
+
+TEST (varint, zigZag)
+{
+  EXPECT_EQ (detail::zigZagEncode (0), 0u);
+  EXPECT_EQ (detail::zigZagEncode (-1), 1u);
+  EXPECT_EQ (detail::zigZagEncode (1), 2u);
+  EXPECT_EQ (detail::zigZagEncode (-2), 3u);
+
+  for (int64_t v : {int64_t {0}, int64_t {-1}, int64_t {63}, int64_t {-64},
+                    std::numeric_limits<int64_t>::min (), std::numeric_limits<int64_t>::max ()})
+  {
+    EXPECT_EQ (detail::zigZagDecode (detail::zigZagEncode (v)), v);
+  }
+}
+
+TEST (varint, bulkDecode)
+{
+  // Mix runs of single byte values with multi byte values to cover both decoding paths.
+  std::vector<int64_t> values;
+  for (int64_t i = 0; i < 100; ++i)
+    values.push_back (i % 13 == 0 ? i * -100000 : i % 50);
+  values.push_back (std::numeric_limits<int64_t>::min ());
+
+  std::vector<uint8_t> encoded (values.size () * detail::maxVarintSize);
+  size_t size = 0;
+  for (auto const v : values)
+    size += detail::encodeVarint (detail::toVarint (v), encoded.data () + size);
+
+  std::vector<int64_t> decoded (values.size ());
+  auto const* const end = encoded.data () + size;
+  EXPECT_EQ (detail::decodeVarints (encoded.data (), end, decoded.data (), decoded.size ()), end);
+  EXPECT_EQ (decoded, values);
+
+  EXPECT_EQ (detail::decodeVarints (encoded.data (), end - 1, decoded.data (), decoded.size ()), nullptr);
+}
+
+TEST (varint, integers)
+{
+  EXPECT_EQ (std::numeric_limits<int>::min (), toBinaryAndBack (std::numeric_limits<int>::min (), varint));
+  EXPECT_EQ (std::numeric_limits<long long int>::max (), toBinaryAndBack (std::numeric_limits<long long int>::max (), varint));
+  EXPECT_EQ (std::numeric_limits<unsigned long long int>::max (), toBinaryAndBack (std::numeric_limits<unsigned long long int>::max (), varint));
+  EXPECT_EQ (char {-3}, toBinaryAndBack (char {-3}, varint));
+  EXPECT_EQ (-12345, toBinaryAndBack (-12345));
+}
+
+TEST (varint, containers)
+{
+  std::vector<int> v;
+  for (int i = -1000; i < 1000; ++i)
+    v.push_back (i * i * (i % 2 == 0 ? 1 : -1));
+
+  std::set<long int> s {-5, 1, 1000000, 7};
+  std::map<std::string, unsigned int> m {{"a", 1}, {"bb", 200000}};
+  std::array<unsigned long int, 3> a {{0, 128, 1ul << 40}};
+
+  EXPECT_EQ (v, toBinaryAndBack (v, varint));
+  EXPECT_EQ (s, toBinaryAndBack (s, varint));
+  EXPECT_EQ (m, toBinaryAndBack (m, varint));
+  EXPECT_EQ (a, toBinaryAndBack (a, varint));
+  EXPECT_EQ (v, toBinaryAndBack (v));
+  EXPECT_EQ (a, toBinaryAndBack (a));
+}
+
+TEST (varint, records)
+{
+  std::vector<Record> records;
+  for (int i = 0; i < 20; ++i)
+    records.push_back ({i, -i * 1000ll, static_cast<unsigned int> (i * 3), "record" + std::to_string (i), {i, -i, i * 100}});
+
+  EXPECT_EQ (records, toBinaryAndBack (records, varint));
+  EXPECT_EQ (records, toBinaryAndBack (records));
+}
+
+TEST (varint, smallerThanFixed)
+{
+  std::vector<int> v (1000);
+  for (size_t i = 0; i < v.size (); ++i)
+    v [i] = static_cast<int> (i % 60);
+
+  auto const fixedSize = toBinary (v)->str ().size ();
+  auto const varintSize = toBinary (v, varint)->str ().size ();
+  EXPECT_LT (varintSize * 3, fixedSize);
+}
+
+TEST (varint, corruptArraySize)
+{
+  BinaryOptions const fixed {IntegerEncoding::Fixed};
+  auto bytes = toBinaryBytes (std::vector<double> (4, 1.0), fixed);
+  for (std::size_t i = 1; i < 9; ++i)
+    bytes [i] = std::byte {0x7F};
+  EXPECT_THROW (fromBinary<std::vector<double>> (bytes, fixed), ArchiveError);
+
+  std::string text (reinterpret_cast<char const*> (bytes.data ()), bytes.size ());
+  EXPECT_THROW (fromBinary<std::vector<double>> (std::make_shared<std::stringstream> (text), fixed), ArchiveError);
+}
+
+TEST (varint, legacyLayoutIsDefault)
+{
+  // The original layout: integers as doubles, a marker in front of each array element and after the last one.
+  std::vector<int> const v {1, 2};
+  std::vector<uint8_t> expected {1};
+  auto const append = [&expected] (double value)
+  {
+    auto const bytes = std::bit_cast<std::array<uint8_t, sizeof (double)>> (value);
+    expected.insert (expected.end (), bytes.begin (), bytes.end ());
+  };
+  append (1.0);
+  expected.push_back (1);
+  append (2.0);
+  expected.push_back (0);
+
+  auto const binary = toBinaryBytes (v);
+  ASSERT_EQ (binary.size (), expected.size ());
+  EXPECT_EQ (0, std::memcmp (binary.data (), expected.data (), expected.size ()));
+  EXPECT_EQ (v, fromBinary<std::vector<int>> (binary));
+
+  Record const record {3, -4, 5, "legacy", {6, 7}};
+  EXPECT_EQ (record, toBinaryAndBack (record));
+  BinaryOptions const header {.header = true};
+  EXPECT_EQ (record, toBinaryAndBack (record, header));
+}
+
+TEST (varint, nonSeekableStream)
+{
+  Record const record {-3, 1ll << 40, 7, "record", {1, -2, 300}};
+  std::vector<double> const doubles {0.5, 1.5, -2.5};
+  std::bitset<70> const bits {0x0123456789ABCDEFull};
+
+  for (auto const options : {BinaryOptions {IntegerEncoding::Fixed}, varint, BinaryOptions {}})
+  {
+    EXPECT_EQ (fromPipe<Record> (toBinary (record, options)->str (), options), record);
+    EXPECT_EQ (fromPipe<std::vector<double>> (toBinary (doubles, options)->str (), options), doubles);
+    EXPECT_EQ (fromPipe<std::bitset<70>> (toBinary (bits, options)->str (), options), bits);
+  }
+
+  // Corrupt sizes are not checked upfront, but fail at the end of the data.
+  BinaryOptions const fixed {IntegerEncoding::Fixed};
+  auto corrupt = toBinary (doubles, fixed)->str ();
+  for (std::size_t i = 1; i < 9; ++i)
+    corrupt [i] = 0x7F;
+  EXPECT_THROW (fromPipe<std::vector<double>> (corrupt, fixed), ArchiveError);
+}
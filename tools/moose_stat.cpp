@@ -0,0 +1,581 @@
+// This file is part of moose, a C++ serialization library
+//
+// Copyright (C) 2024 Volume Graphics
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+// THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/** \file
+  Prints which fields and types dominate the size of a moose archive.
+
+  JSON archives are walked generically, i.e. without the types of the application. Sizes are
+  offsets in the JSON text: each entry accounts for its name, its value and the separator in front
+  of it, so the sizes of all children of an entry sum up to its own size.
+
+  Binary archives store neither names nor the types of values. Only their framing is walked:
+  the header, the index of top-level entries and, for tagged data, the field ids and lengths of
+  the members of the outermost struct. Names are taken from the index where available. Binary
+  archives which are neither tagged nor indexed are rejected, since without the types it is not
+  known where their values end. Use a `ProfilingReader` with `readPosition` in an application which
+  knows the types to obtain the complete breakdown for binary archives.*/
+
+#include <moose/binary_index.h>
+#include <moose/detail/binary_encoding.h>
+#include <moose/detail/varint.h>
+
+#include <rapidjson/error/en.h>
+#include <rapidjson/reader.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  struct Options
+  {
+    std::string filename;
+    std::size_t top {10};
+    std::size_t depth {std::numeric_limits<std::size_t>::max ()};
+  };
+
+  struct Statistics
+  {
+    uint64_t count {0};
+    uint64_t bytes {0};
+  };
+
+  /// A field path. All elements of an array share the node `[]`.
+  struct Node
+  {
+    std::string mName;
+    std::size_t mParent;
+    std::vector<std::size_t> mChildren {};
+    Statistics mStatistics {};
+  };
+
+  struct TypeStatistics
+  {
+    Statistics mStatistics;
+    std::map<std::string, uint64_t> mVersions;
+  };
+
+  /// An array or string instance for the lists of the largest ones.
+  struct Item
+  {
+    uint64_t mSize;
+    std::size_t mNode;
+    uint64_t mBytes;
+
+    bool operator > (Item const& other) const {return mSize > other.mSize;}
+  };
+
+  /// Keeps the `n` largest items.
+  class TopItems
+  {
+  public:
+    explicit TopItems (std::size_t n) : mN {n} {}
+
+    void add (Item const& item)
+    {
+      if (mN == 0)
+        return;
+      if (mItems.size () < mN)
+        mItems.push (item);
+      else if (item > mItems.top ())
+      {
+        mItems.pop ();
+        mItems.push (item);
+      }
+    }
+
+    /// Returns the items, largest first.
+    auto sorted () const -> std::vector<Item>
+    {
+      auto items = mItems;
+      std::vector<Item> result;
+      for (; !items.empty (); items.pop ())
+        result.push_back (items.top ());
+      std::reverse (result.begin (), result.end ());
+      return result;
+    }
+
+  private:
+    std::size_t mN;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> mItems;
+  };
+
+  /// Collects the statistics of a JSON archive from the events of a rapidjson SAX reader.
+  class Collector : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, Collector>
+  {
+  public:
+    Collector (rapidjson::StringStream const& stream, std::size_t top)
+      : mStream {stream}
+      , mLargestArrays {top}
+      , mLargestStrings {top}
+    {
+      mNodes.push_back ({"", 0});
+    }
+
+    bool Key (const char* str, rapidjson::SizeType length, bool)
+    {
+      mKey.assign (str, length);
+      return true;
+    }
+
+    bool Default () {return value ();}
+
+    bool String (const char* str, rapidjson::SizeType length, bool)
+    {
+      if (!mFrames.empty () && !mFrames.back ().mArray)
+      {
+        // Type annotations are attributed to the object, not listed as fields.
+        if (mKey == "@type")
+        {
+          mFrames.back ().mType.assign (str, length);
+          return skip ();
+        }
+        if (mKey == "@type_version")
+        {
+          mFrames.back ().mVersion.assign (str, length);
+          return skip ();
+        }
+      }
+
+      auto const start = mPosition;
+      value ();
+      mLargestStrings.add ({length, mLastNode, mPosition - start});
+      return true;
+    }
+
+    bool StartObject () {return begin (false);}
+    bool EndObject (rapidjson::SizeType) {return end ();}
+    bool StartArray () {return begin (true);}
+    bool EndArray (rapidjson::SizeType count) {return end (count);}
+
+    auto nodes () const -> std::vector<Node> const& {return mNodes;}
+    auto types () const -> std::map<std::string, TypeStatistics> const& {return mTypes;}
+    auto largest_arrays () const -> TopItems const& {return mLargestArrays;}
+    auto largest_strings () const -> TopItems const& {return mLargestStrings;}
+
+    auto path (std::size_t node) const -> std::string
+    {
+      std::string path;
+      for (; node != 0; node = mNodes [node].mParent)
+        path.insert (0, path.empty () ? mNodes [node].mName : mNodes [node].mName + "/");
+      return path;
+    }
+
+  private:
+    struct Frame
+    {
+      std::size_t mNode;
+      bool mArray;
+      uint64_t mStart;
+      std::string mType {};
+      std::string mVersion {};
+    };
+
+  private:
+    /// Returns the node of the value which starts now.
+    auto current_node () -> std::size_t
+    {
+      if (mFrames.empty ())
+        return 0;
+
+      auto const parent = mFrames.back ().mNode;
+      auto const& name = mFrames.back ().mArray ? std::string {"[]"} : mKey;
+      for (auto const child : mNodes [parent].mChildren)
+      {
+        if (mNodes [child].mName == name)
+          return child;
+      }
+
+      auto const child = mNodes.size ();
+      mNodes.push_back ({name, parent});
+      mNodes [parent].mChildren.push_back (child);
+      return child;
+    }
+
+    void record (std::size_t node, uint64_t start)
+    {
+      mPosition = mStream.Tell ();
+      ++mNodes [node].mStatistics.count;
+      mNodes [node].mStatistics.bytes += mPosition - start;
+      mLastNode = node;
+    }
+
+    bool value ()
+    {
+      record (current_node (), mPosition);
+      return true;
+    }
+
+    /// Skips a value without recording it. Its bytes are attributed to the enclosing entry.
+    bool skip ()
+    {
+      mPosition = mStream.Tell ();
+      return true;
+    }
+
+    bool begin (bool array)
+    {
+      auto const node = current_node ();
+      mFrames.push_back ({node, array, mPosition});
+      mPosition = mStream.Tell ();
+      return true;
+    }
+
+    bool end (std::size_t count = 0)
+    {
+      auto const frame = std::move (mFrames.back ());
+      mFrames.pop_back ();
+      record (frame.mNode, frame.mStart);
+
+      auto const bytes = mPosition - frame.mStart;
+      if (frame.mArray)
+        mLargestArrays.add ({count, frame.mNode, bytes});
+      if (!frame.mType.empty ())
+      {
+        auto& type = mTypes [frame.mType];
+        ++type.mStatistics.count;
+        type.mStatistics.bytes += bytes;
+        if (!frame.mVersion.empty ())
+          ++type.mVersions [frame.mVersion];
+      }
+      return true;
+    }
+
+  private:
+    rapidjson::StringStream const& mStream;
+    std::vector<Node> mNodes;
+    std::vector<Frame> mFrames;
+    std::map<std::string, TypeStatistics> mTypes;
+    TopItems mLargestArrays;
+    TopItems mLargestStrings;
+    std::string mKey;
+    /// End of the last value, i.e. the start of the next one.
+    uint64_t mPosition {0};
+    std::size_t mLastNode {0};
+  };
+
+  auto percent (uint64_t part, uint64_t total) -> double
+  {
+    return total == 0 ? 0 : 100.0 * static_cast<double> (part) / static_cast<double> (total);
+  }
+
+  void printTree (Collector const& collector, std::size_t node, std::size_t depth, Options const& options,
+                  uint64_t total)
+  {
+    auto const& nodes = collector.nodes ();
+    auto children = nodes [node].mChildren;
+    std::sort (children.begin (), children.end (), [&] (auto a, auto b)
+    {
+      return nodes [a].mStatistics.bytes > nodes [b].mStatistics.bytes;
+    });
+
+    for (auto const child : children)
+    {
+      auto const& statistics = nodes [child].mStatistics;
+      std::cout << std::setw (14) << statistics.bytes
+                << std::setw (8) << std::fixed << std::setprecision (1) << percent (statistics.bytes, total) << "%"
+                << std::setw (12) << statistics.count << "  "
+                << std::string (2 * depth, ' ') << nodes [child].mName << "\n";
+
+      if (depth + 1 < options.depth)
+        printTree (collector, child, depth + 1, options, total);
+    }
+  }
+
+  void printItems (Collector const& collector, TopItems const& items, const char* sizeName)
+  {
+    std::cout << std::setw (14) << sizeName << std::setw (14) << "bytes" << "  path\n";
+    for (auto const& item : items.sorted ())
+      std::cout << std::setw (14) << item.mSize << std::setw (14) << item.mBytes << "  " << collector.path (item.mNode) << "\n";
+  }
+
+  void printJsonStatistics (std::string const& content, Options const& options)
+  {
+    rapidjson::StringStream stream {content.c_str ()};
+    Collector collector {stream, options.top};
+    rapidjson::Reader reader;
+    auto const result = reader.Parse (stream, collector);
+    if (!result)
+    {
+      throw std::runtime_error {std::string {"JSON parse error at offset "} + std::to_string (result.Offset ())
+                                + ": " + rapidjson::GetParseError_En (result.Code ())};
+    }
+
+    auto const total = static_cast<uint64_t> (content.size ());
+    std::cout << "JSON archive, " << total << " bytes\n\n"
+              << "Fields:\n"
+              << std::setw (14) << "bytes" << std::setw (9) << "share" << std::setw (12) << "count" << "  name\n";
+    printTree (collector, 0, 0, options, total);
+
+    std::cout << "\nTypes:\n"
+              << std::setw (14) << "bytes" << std::setw (9) << "share" << std::setw (12) << "count" << "  type (versions)\n";
+    std::vector<std::pair<std::string, TypeStatistics>> types (collector.types ().begin (), collector.types ().end ());
+    std::sort (types.begin (), types.end (), [] (auto const& a, auto const& b)
+    {
+      return a.second.mStatistics.bytes > b.second.mStatistics.bytes;
+    });
+    for (auto const& [name, type] : types)
+    {
+      std::cout << std::setw (14) << type.mStatistics.bytes
+                << std::setw (8) << std::fixed << std::setprecision (1) << percent (type.mStatistics.bytes, total) << "%"
+                << std::setw (12) << type.mStatistics.count << "  " << name;
+      for (auto const& [version, count] : type.mVersions)
+        std::cout << " " << version << ":" << count;
+      std::cout << "\n";
+    }
+
+    std::cout << "\nLargest arrays:\n";
+    printItems (collector, collector.largest_arrays (), "elements");
+    std::cout << "\nLargest strings:\n";
+    printItems (collector, collector.largest_strings (), "length");
+  }
+
+  /// A part of a binary archive whose size is known without the types which wrote it.
+  struct BinaryPart
+  {
+    std::string mName;
+    uint64_t mBytes;
+  };
+
+  auto hex (uint64_t value, int width) -> std::string
+  {
+    std::ostringstream out;
+    out << std::hex << std::setfill ('0') << std::setw (width) << value;
+    return out.str ();
+  }
+
+  /// Names of tagged members are only stored as ids. Top-level members can be named through the index.
+  auto memberName (uint32_t id, moose::BinaryIndex const& index) -> std::string
+  {
+    for (auto const& entry : index.entries)
+    {
+      if (moose::detail::fieldId (entry.name.c_str ()) == id)
+        return entry.name;
+    }
+    return "#" + hex (id, 8);
+  }
+
+  /// Returns the top-level members of tagged data in `[begin, end)` from their ids and lengths.
+  auto taggedMembers (uint8_t const* begin, uint8_t const* end, moose::BinaryIndex const& index) -> std::vector<BinaryPart>
+  {
+    std::vector<BinaryPart> members;
+    for (auto const* position = begin; position != end;)
+    {
+      uint64_t length = 0;
+      auto const* const content = end - position > 4 ? moose::detail::decodeVarint (position + 4, end, length) : nullptr;
+      if (content == nullptr || length > static_cast<uint64_t> (end - content))
+        throw std::runtime_error {"Invalid tagged member at offset " + std::to_string (position - begin)};
+
+      auto const id = static_cast<uint32_t> (position [0] | (position [1] << 8) | (position [2] << 16)
+                                             | (static_cast<uint32_t> (position [3]) << 24));
+      auto const next = content + length;
+      members.push_back ({memberName (id, index), static_cast<uint64_t> (next - position)});
+      position = next;
+    }
+    return members;
+  }
+
+  void printBinaryStatistics (std::string const& content, Options const& options)
+  {
+    namespace detail = moose::detail;
+    auto const* const data = reinterpret_cast<uint8_t const*> (content.data ());
+    auto const total = static_cast<uint64_t> (content.size ());
+    std::cout << "Binary archive, " << total << " bytes\n\n";
+
+    std::vector<BinaryPart> parts;
+    moose::BinaryOptions binaryOptions;
+    std::size_t begin = 0;
+    bool const hasHeader = content.size () >= detail::headerSize
+                        && std::equal (detail::headerMagic, detail::headerMagic + sizeof (detail::headerMagic), content.begin ());
+    if (hasHeader)
+    {
+      std::array<uint8_t, detail::headerSize> header;
+      std::copy_n (data, header.size (), header.begin ());
+      begin = header.size ();
+      if (detail::decodeHeader (header, binaryOptions))
+      {
+        if (content.size () < begin + detail::schemaSize)
+          throw std::runtime_error {"Truncated header"};
+        std::array<uint8_t, detail::schemaSize> schema;
+        std::copy_n (data + begin, schema.size (), schema.begin ());
+        binaryOptions.schema = detail::decodeSchema (schema);
+        begin += schema.size ();
+      }
+      parts.push_back ({"(header)", begin});
+
+      std::cout << "Header: version " << static_cast<int> (data [4])
+                << (binaryOptions.byteOrder == std::endian::big ? ", big endian" : ", little endian")
+                << (binaryOptions.integerEncoding == moose::IntegerEncoding::Varint ? ", varint"
+                    : binaryOptions.integerEncoding == moose::IntegerEncoding::Legacy ? ", legacy numbers" : ", fixed width")
+                << (binaryOptions.dedupThreshold > 0 ? ", deduplicated" : "")
+                << (binaryOptions.tagged ? ", tagged" : "")
+                << (binaryOptions.index ? ", indexed" : "");
+      if (binaryOptions.schema != 0)
+        std::cout << ", schema " << hex (binaryOptions.schema, 16);
+      std::cout << "\n";
+    }
+    else
+      std::cout << "No header: the options of the writer are unknown.\n";
+
+    // The index is found through its trailer, also in data without header.
+    auto end = content.size ();
+    moose::BinaryIndex index;
+    bool const hasIndex = end >= detail::indexTrailerSize
+                       && std::equal (detail::indexMagic, detail::indexMagic + sizeof (detail::indexMagic),
+                                      content.end () - sizeof (detail::indexMagic));
+    if (hasIndex)
+    {
+      uint64_t position = 0;
+      for (std::size_t i = 0; i < 8; ++i)
+        position |= static_cast<uint64_t> (data [end - detail::indexTrailerSize + i]) << (8 * i);
+      if (position < begin || position > end - detail::indexTrailerSize)
+        throw std::runtime_error {"Invalid position of the index"};
+
+      index = detail::decodeIndex (data + position, data + end - detail::indexTrailerSize);
+      parts.push_back ({"(index)", end - position});
+      end = static_cast<std::size_t> (position);
+      std::cout << "Index: " << index.entries.size () << " top-level entries\n";
+    }
+
+    if (binaryOptions.tagged)
+    {
+      for (auto const& member : taggedMembers (data + begin, data + end, index))
+        parts.push_back (member);
+    }
+    else if (hasIndex)
+    {
+      for (std::size_t i = 0; i < index.entries.size (); ++i)
+      {
+        auto const& entry = index.entries [i];
+        auto const next = i + 1 < index.entries.size () ? index.entries [i + 1].offset : end;
+        if (entry.offset > next || next > end)
+          throw std::runtime_error {"Invalid offset of entry '" + entry.name + "' in the index"};
+        auto name = entry.name;
+        if (entry.type == moose::ContentType::Array && entry.elementCount > 0)
+          name += " [" + std::to_string (entry.elementCount) + " elements]";
+        parts.push_back ({name, next - entry.offset});
+      }
+    }
+    else
+    {
+      // Plain binary data does not mark where values end, so it can not be walked without its types.
+      throw std::runtime_error {"Binary archives which are neither tagged nor indexed are not supported, since their "
+                                "entries can only be decoded with the types which wrote them. Read the archive through "
+                                "a moose::ProfilingReader in your application to obtain a breakdown by field and type."};
+    }
+
+    std::sort (parts.begin (), parts.end (), [] (auto const& a, auto const& b) {return a.mBytes > b.mBytes;});
+    if (parts.size () > options.top + 2)
+      parts.resize (options.top + 2);
+
+    std::cout << "\nTop-level entries:\n"
+              << std::setw (14) << "bytes" << std::setw (9) << "share" << "  name\n";
+    for (auto const& part : parts)
+    {
+      std::cout << std::setw (14) << part.mBytes
+                << std::setw (8) << std::fixed << std::setprecision (1) << percent (part.mBytes, total) << "%"
+                << "  " << part.mName << "\n";
+    }
+  }
+
+  void printUsage ()
+  {
+    std::cerr << "usage: moose_stat [--top <n>] [--depth <n>] <archive>\n"
+                 "Prints the sizes and counts of the entries of a JSON moose archive by field path and by\n"
+                 "@type, as well as the largest arrays and strings. For binary archives, the header and\n"
+                 "the sizes of the top-level entries of indexed or tagged data are printed. Other binary\n"
+                 "archives are not supported.\n";
+  }
+
+  auto parseOptions (int argc, char** argv) -> Options
+  {
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+      std::string const arg = argv [i];
+      if (arg == "--help" || arg == "-h")
+      {
+        printUsage ();
+        std::exit (0);
+      }
+      else if ((arg == "--top" || arg == "--depth") && i + 1 < argc)
+      {
+        auto const value = static_cast<std::size_t> (std::stoul (argv [++i]));
+        (arg == "--top" ? options.top : options.depth) = value;
+      }
+      else if (options.filename.empty () && !arg.starts_with ("--"))
+        options.filename = arg;
+      else
+      {
+        printUsage ();
+        std::exit (1);
+      }
+    }
+
+    if (options.filename.empty ())
+    {
+      printUsage ();
+      std::exit (1);
+    }
+    return options;
+  }
+}
+
+int main (int argc, char** argv)
+{
+  try
+  {
+    auto const options = parseOptions (argc, argv);
+
+    std::ifstream in {options.filename, std::ios::binary};
+    if (!in)
+      throw std::runtime_error {"File not accessible: " + options.filename};
+    std::string const content {std::istreambuf_iterator<char> {in}, std::istreambuf_iterator<char> {}};
+
+    auto const first = content.find_first_not_of (" \t\r\n");
+    if (first != std::string::npos && content [first] == '{')
+      printJsonStatistics (content, options);
+    else
+      printBinaryStatistics (content, options);
+  }
+  catch (std::exception const& e)
+  {
+    std::cerr << "moose_stat: " << e.what () << "\n";
+    return 1;
+  }
+  return 0;
+}